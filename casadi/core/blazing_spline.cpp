@@ -384,6 +384,8 @@ namespace casadi {
         "correct index. 'linear' uses a forward linear search. 'exact' uses "
         "a comparator function optimized for uniformly distributed data "
         "(requires equally spaced knots). 'binary' uses a binary search. "
+        "'hunt' searches outward from the interval of the previous call, "
+        "which is cached per memory object. "
         "'auto' (default) uses 'linear' for small grids and 'binary' for large."}},
       {"pedantic_mode_order",
        {OT_STRING,
@@ -536,10 +538,15 @@ namespace casadi {
       knots_inv = "0";
     }
 
-    std::vector<casadi_int> degree(nd, 3);
-    std::vector<casadi_int> mode =
-      Interpolant::interpret_lookup_mode(
-        lookup_modes_, knots_stacked_, knots_offset_, degree, degree);
+    std::vector<casadi_int> mode = lookup_mode();
+
+    // Start indices of the previous call, for 'hunt' lookup; the kernel keeps them at iw+nd+1
+    std::string starts;
+    if (codegen_needs_mem()) {
+      g.add_auxiliary(CodeGenerator::AUX_COPY, {"casadi_int"});
+      starts = codegen_mem(g) + ".starts";
+      g << "casadi_copy_casadi_int(" << starts << ", " << nd << ", iw+" << nd+1 << ");\n";
+    }
 
     std::string fun_name = "casadi_blazing_" + str(nd) + "d_boor_eval";
     std::string f_ptr = "res[0]";
@@ -561,6 +568,32 @@ namespace casadi {
           "arg[0], " +
           g.constant(mode) + ", " +
           "iw, w);\n";
+    if (!starts.empty()) {
+      g << "casadi_copy_casadi_int(iw+" << nd+1 << ", " << nd << ", " << starts << ");\n";
+    }
+  }
+
+  std::vector<casadi_int> BlazingSplineFunction::lookup_mode() const {
+    std::vector<casadi_int> degree(ndim(), 3);
+    return Interpolant::interpret_lookup_mode(
+      lookup_modes_, knots_stacked_, knots_offset_, degree, degree);
+  }
+
+  std::string BlazingSplineFunction::codegen_mem_type() const {
+    return "struct { casadi_int starts[" + str(ndim()) + "]; }";
+  }
+
+  bool BlazingSplineFunction::codegen_needs_mem() const {
+    for (casadi_int e : lookup_mode()) {
+      if (e==LOOKUP_HUNT) return true;
+    }
+    return false;
+  }
+
+  void BlazingSplineFunction::codegen_init_mem(CodeGenerator& g) const {
+    g.add_auxiliary(CodeGenerator::AUX_CLEAR, {"casadi_int"});
+    g << "casadi_clear_casadi_int(" << codegen_mem(g) << ".starts, " << ndim() << ");\n";
+    g << "return 0;\n";
   }
 
   bool BlazingSplineFunction::has_jacobian() const {
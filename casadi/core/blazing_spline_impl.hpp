@@ -96,6 +96,18 @@ namespace casadi {
         \identifier{2aj} */
     void codegen_body(CodeGenerator& g) const override;
 
+    /** \brief Thread-local memory object type */
+    std::string codegen_mem_type() const override;
+
+    /** \brief Is thread-local memory object needed? */
+    bool codegen_needs_mem() const override;
+
+    /** \brief Generate code for init_mem */
+    void codegen_init_mem(CodeGenerator& g) const override;
+
+    /** \brief Lookup mode (enum) for each dimension */
+    std::vector<casadi_int> lookup_mode() const;
+
     ///@{
     /** \brief Jacobian of all outputs with respect to all inputs
 
@@ -24,27 +24,56 @@
 
 
 #include "function.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <new>
+#ifdef CASADI_WITH_THREAD
+#ifdef CASADI_WITH_THREAD_MINGW
+#include <mingw.thread.h>
+#else // CASADI_WITH_THREAD_MINGW
+#include <thread>
+#endif // CASADI_WITH_THREAD_MINGW
+#endif // CASADI_WITH_THREAD
 
 using namespace casadi;
 
-int eval_dump(const std::string& name) {
-    // Load function
-    Function f = Function::load(name+".casadi");
-    f.change_option("dump_in", false);
-    f.change_option("dump_out", false);
+// Heap allocations through operator new, counted for 'bench'
+std::atomic<size_t> n_alloc(0);
+
+void* operator new(std::size_t sz) {
+  n_alloc.fetch_add(1, std::memory_order_relaxed);
+  if (void* p = std::malloc(sz ? sz : 1)) return p;
+  throw std::bad_alloc();
+}
 
-    // Helper to format filenames 
-    std::stringstream ss;
-    ss << std::setfill('0') << std::setw(6);
+void operator delete(void* p) noexcept {
+  std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+  std::free(p);
+}
 
-    std::vector<DM> inputs;
-    // Loop over all inputs
+// Load the inputs dumped with 'dump_in', in binary or text form
+std::vector<std::vector<DM>> load_dump(Function& f, const std::string& name) {
+    if (std::ifstream(name+".casadi_dump").good()) {
+        std::vector<std::vector<DM>> ret = f.read_dump(name+".casadi_dump");
+        casadi_assert(!ret.empty(), "No inputs recorded in " + name + ".casadi_dump");
+        return ret;
+    }
+    std::vector<std::vector<DM>> ret;
     for (int i=0;i<1000000;++i) {
-        ss << i;
+        std::stringstream ss;
+        ss << std::setfill('0') << std::setw(6) << i;
         try {
-            inputs = f.generate_in(name+"."+ss.str()+ ".in.txt");
+            ret.push_back(f.generate_in(name+"."+ss.str()+ ".in.txt"));
         } catch (CasadiException& ex) {
             if (i==0) {
                 casadi_warning(ex.what());
@@ -54,11 +83,24 @@ int eval_dump(const std::string& name) {
             // No more input files
             break;
         }
+    }
+    return ret;
+}
+
+int eval_dump(const std::string& name) {
+    // Load function
+    Function f = Function::load(name+".casadi");
+    f.change_option("dump_in", false);
+    f.change_option("dump_out", false);
+
+    std::vector<std::vector<DM>> inputs = load_dump(f, name);
+    for (size_t i=0; i<inputs.size(); ++i) {
         // Run function
-        std::vector<DM> res = f(inputs);
+        std::vector<DM> res = f(inputs[i]);
         // Generate output file
+        std::stringstream ss;
+        ss << std::setfill('0') << std::setw(6) << i;
         f.generate_out(name+"."+ss.str()+ ".out.txt", res);
-        ss.clear();
     }
     return 0;
 }
@@ -69,17 +111,217 @@ int eval_dump_parse(const std::vector<std::string>& args) {
     return eval_dump(name);
 }
 
+// Latency statistics of a set of samples [s]
+struct LatencyStats {
+    double min, p50, p90, p99, max, mean;
+    explicit LatencyStats(std::vector<double> t) {
+        std::sort(t.begin(), t.end());
+        // Nearest-rank percentile
+        auto pct = [&](double p) {
+            size_t k = static_cast<size_t>(std::ceil(p*static_cast<double>(t.size())));
+            return t[std::min(std::max(k, size_t(1)), t.size()) - 1];
+        };
+        min = t.front();
+        p50 = pct(0.5);
+        p90 = pct(0.9);
+        p99 = pct(0.99);
+        max = t.back();
+        mean = 0;
+        for (double e : t) mean += e;
+        mean /= static_cast<double>(t.size());
+    }
+    void disp(std::ostream& s) const {
+        s << std::setw(12) << 1e6*min << std::setw(12) << 1e6*p50 << std::setw(12) << 1e6*p90
+          << std::setw(12) << 1e6*p99 << std::setw(12) << 1e6*max << std::setw(12) << 1e6*mean;
+    }
+    void to_json(std::ostream& s) const {
+        s << "{\"min\": " << min << ", \"p50\": " << p50 << ", \"p90\": " << p90
+          << ", \"p99\": " << p99 << ", \"max\": " << max << ", \"mean\": " << mean << "}";
+    }
+};
+
+int bench(const std::string& name, casadi_int repeat, casadi_int warmup, casadi_int threads,
+        const std::string& json) {
+    casadi_assert(repeat>0, "Option --repeat must be positive.");
+    casadi_assert(warmup>=0, "Option --warmup must be non-negative.");
+    casadi_assert(threads>0, "Option --threads must be positive.");
+#ifndef CASADI_WITH_THREAD
+    casadi_assert(threads==1, "--threads requires CasADi to be compiled with WITH_THREAD.");
+#endif // CASADI_WITH_THREAD
+
+    // Load function and inputs
+    Function f = Function::load(name+".casadi");
+    f.change_option("dump_in", false);
+    f.change_option("dump_out", false);
+    std::vector<std::vector<DM>> inputs = load_dump(f, name);
+    size_t n_input = inputs.size();
+
+    // Latency samples per thread and input
+    std::vector<std::vector<std::vector<double>>> samples(threads,
+        std::vector<std::vector<double>>(n_input, std::vector<double>(repeat)));
+
+    // Threads wait for each other after warming up, the last one starts the clock
+    std::atomic<casadi_int> n_ready(0);
+    std::atomic<bool> go(false);
+    // A failing thread records its error and makes all threads stop
+    std::vector<std::exception_ptr> errors(threads);
+    std::atomic<bool> abort(false);
+    size_t alloc0 = 0;
+    std::chrono::steady_clock::time_point start;
+    auto worker = [&](casadi_int t) {
+        int mem = -1;
+        try {
+            // Memory object and work vectors of this thread
+            mem = f.checkout();
+            std::vector<const double*> arg(f.sz_arg());
+            std::vector<double*> res(f.sz_res());
+            std::vector<casadi_int> iw(f.sz_iw());
+            std::vector<double> w(f.sz_w());
+            std::vector<std::vector<double>> out(f.n_out());
+            for (casadi_int i=0; i<f.n_out(); ++i) {
+                out[i].resize(f.nnz_out(i));
+                res[i] = get_ptr(out[i]);
+            }
+            auto eval = [&](const std::vector<DM>& in) {
+                for (casadi_int i=0; i<f.n_in(); ++i) arg[i] = in[i].ptr();
+                if (f(get_ptr(arg), get_ptr(res), get_ptr(iw), get_ptr(w), mem)) {
+                    casadi_error("Evaluation of '" + f.name() + "' failed.");
+                }
+            };
+            for (auto&& in : inputs) {
+                for (casadi_int r=0; r<warmup && !abort; ++r) eval(in);
+            }
+            if (++n_ready==threads) {
+                alloc0 = n_alloc;
+                start = std::chrono::steady_clock::now();
+                go = true;
+            }
+            while (!go && !abort) {
+#ifdef CASADI_WITH_THREAD
+                std::this_thread::yield();
+#endif // CASADI_WITH_THREAD
+            }
+            for (size_t k=0; k<n_input && !abort; ++k) {
+                for (casadi_int r=0; r<repeat; ++r) {
+                    auto t0 = std::chrono::steady_clock::now();
+                    eval(inputs[k]);
+                    samples[t][k][r] = std::chrono::duration<double>(
+                        std::chrono::steady_clock::now() - t0).count();
+                }
+            }
+        } catch (...) {
+            errors[t] = std::current_exception();
+            abort = true;
+        }
+        if (mem>=0) f.release(mem);
+    };
+
+    // Evaluate
+#ifdef CASADI_WITH_THREAD
+    std::vector<std::thread> pool;
+    for (casadi_int t=1; t<threads; ++t) pool.emplace_back(worker, t);
+#endif // CASADI_WITH_THREAD
+    worker(0);
+#ifdef CASADI_WITH_THREAD
+    for (auto&& th : pool) th.join();
+#endif // CASADI_WITH_THREAD
+    for (auto&& e : errors) {
+        if (e) std::rethrow_exception(e);
+    }
+    double t_wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    size_t n_eval = threads*repeat*n_input;
+    double alloc_per_eval = static_cast<double>(n_alloc - alloc0)/static_cast<double>(n_eval);
+
+    // Statistics per input and overall
+    std::vector<LatencyStats> per_input;
+    std::vector<double> all;
+    for (size_t k=0; k<n_input; ++k) {
+        std::vector<double> s;
+        for (casadi_int t=0; t<threads; ++t) s.insert(s.end(), samples[t][k].begin(), samples[t][k].end());
+        all.insert(all.end(), s.begin(), s.end());
+        per_input.emplace_back(s);
+    }
+    LatencyStats total(all);
+
+    // Report
+    std::cout << "Function '" << f.name() << "': " << n_input << " dumped input(s), "
+              << repeat << " evaluation(s) each, " << warmup << " warmup, "
+              << threads << " thread(s)" << std::endl;
+    std::cout << std::setw(8) << "input" << std::setw(12) << "min [us]" << std::setw(12) << "p50"
+              << std::setw(12) << "p90" << std::setw(12) << "p99" << std::setw(12) << "max"
+              << std::setw(12) << "mean" << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+    for (size_t k=0; k<n_input; ++k) {
+        std::cout << std::setw(8) << k;
+        per_input[k].disp(std::cout);
+        std::cout << std::endl;
+    }
+    std::cout << std::setw(8) << "all";
+    total.disp(std::cout);
+    std::cout << std::endl;
+    std::cout << "Throughput: " << static_cast<double>(n_eval)/t_wall << " evaluations/s" << std::endl;
+    std::cout << "Heap allocations: " << alloc_per_eval << " per evaluation" << std::endl;
+
+    // Machine-readable report
+    if (!json.empty()) {
+        std::ofstream s(json);
+        casadi_assert(s.good(), "Could not open '" + json + "' for writing.");
+        s << std::setprecision(9);
+        s << "{\"function\": \"" << f.name() << "\", \"n_input\": " << n_input
+          << ", \"repeat\": " << repeat << ", \"warmup\": " << warmup
+          << ", \"threads\": " << threads << ", \"n_eval\": " << n_eval
+          << ", \"t_wall\": " << t_wall
+          << ", \"throughput\": " << static_cast<double>(n_eval)/t_wall
+          << ", \"alloc_per_eval\": " << alloc_per_eval
+          << ",\n \"latency\": ";
+        total.to_json(s);
+        s << ",\n \"latency_per_input\": [";
+        for (size_t k=0; k<n_input; ++k) {
+            s << (k ? ",\n  " : "\n  ");
+            per_input[k].to_json(s);
+        }
+        s << "]}\n";
+    }
+    return 0;
+}
+
+int bench_parse(const std::vector<std::string>& args) {
+    casadi_assert(args.size()>0, "Name is missing in $ casadi-cli bench name.");
+    std::string name = args[0];
+    casadi_int repeat = 1000, warmup = 10, threads = 1;
+    std::string json;
+    for (size_t i=1; i<args.size(); i+=2) {
+        casadi_assert(i+1<args.size(), "Missing value for option '" + args[i] + "'.");
+        const std::string& v = args[i+1];
+        if (args[i]=="--repeat") {
+            repeat = std::stoll(v);
+        } else if (args[i]=="--warmup") {
+            warmup = std::stoll(v);
+        } else if (args[i]=="--threads") {
+            threads = std::stoll(v);
+        } else if (args[i]=="--json") {
+            json = v;
+        } else {
+            casadi_error("Unrecognised option '" + args[i] + "' for bench. "
+                         "Use one of --repeat, --warmup, --threads, --json.");
+        }
+    }
+    return bench(name, repeat, warmup, threads, json);
+}
+
 int main(int argc, char* argv[]) {
   try {
     // Retrieve all arguments
     std::vector<std::string> args(argv + 1, argv + argc);
 
     // Branch on 'command' (first argument)
-    std::set<std::string> commands = {"eval_dump"};
+    std::set<std::string> commands = {"eval_dump", "bench"};
     casadi_assert(args.size()>0, "Must provide a command. Use one of: " + str(commands) + ".");
     std::string cmd = args[0];
     if (cmd=="eval_dump") {
         return eval_dump_parse(std::vector<std::string>(args.begin()+1, args.end()));
+    } else if (cmd=="bench") {
+        return bench_parse(std::vector<std::string>(args.begin()+1, args.end()));
     } else {
         casadi_assert(commands.find(cmd)!=commands.end(),
             "Unrecognised command '" + cmd + "'. Use one of: " + str(commands) + ".");
@@ -53,6 +53,8 @@ namespace casadi {
         return "exact";
       case LOOKUP_BINARY:
         return "binary";
+      case LOOKUP_HUNT:
+        return "hunt";
       default:
         casadi_assert_dev(false);
     }
@@ -68,9 +70,11 @@ namespace casadi {
       return LOOKUP_LINEAR;
     } else if (lookup_mode=="exact") {
       return LOOKUP_EXACT;
+    } else if (lookup_mode=="hunt") {
+      return LOOKUP_HUNT;
     } else {
       casadi_error("Invalid lookup mode '" + lookup_mode + "'. "
-        "Available modes: linear|binary|exact|auto");
+        "Available modes: linear|binary|exact|hunt|auto");
     }
   }
 
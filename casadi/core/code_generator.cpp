@@ -26,12 +26,14 @@
 
 #include "code_generator.hpp"
 #include "function_internal.hpp"
+#include "mx_function.hpp"
 #include "convexify.hpp"
 #include "blas_impl.hpp"
 #include <casadi_runtime_str.h>
 #include "global_options.hpp"
 #include "filesystem_impl.hpp"
 #include <iomanip>
+#include <cstdint>
 
 namespace casadi {
 
@@ -65,6 +67,9 @@ namespace casadi {
     this->max_initializer_elements_per_line = 8;
     this->force_canonical = false;
     this->l1_blas = false;
+    this->constant_blob = "embedded";
+    this->constant_blob_threshold = 1000;
+    this->simplify = false;
 
     avoid_stack_ = false;
     indent_ = 2;
@@ -140,6 +145,17 @@ namespace casadi {
         this->l1_blas = e.second;
       } else if (e.first=="thread_safe") {
         thread_safe_ = e.second;
+      } else if (e.first=="constant_blob") {
+        this->constant_blob = e.second.to_string();
+        casadi_assert(this->constant_blob=="embedded" || this->constant_blob=="file"
+          || this->constant_blob=="incbin",
+          "Option constant_blob must be 'embedded', 'file' or 'incbin'");
+      } else if (e.first=="constant_blob_threshold") {
+        this->constant_blob_threshold = e.second;
+        casadi_assert(this->constant_blob_threshold>=1,
+          "Option constant_blob_threshold must be >=1");
+      } else if (e.first=="simplify") {
+        this->simplify = e.second;
       } else {
         casadi_error("Unrecognized option: " + str(e.first));
       }
@@ -201,6 +217,15 @@ namespace casadi {
       add_include("string.h");
     }
 
+    // Reading the constant blob at runtime
+    if (this->constant_blob=="file") {
+      add_include("stdio.h");
+      add_include("stdlib.h");
+    }
+
+    // Default location of the constant blob, relative to the working directory
+    blob_file_ = this->name + ".bin";
+
     // Mex
     if (this->mex) {
       add_include("mex.h", false, "MATLAB_MEX_FILE");
@@ -396,18 +421,26 @@ namespace casadi {
     return fname;
   }
 
-    void CodeGenerator::add(const Function& f, bool with_jac_sparsity) {
+    void CodeGenerator::add(const Function& f0, bool with_jac_sparsity) {
+    // Simplify the graph of MX functions, if requested
+    Function f = f0;
+    if (this->simplify && f.is_a("MXFunction")) {
+      f = f->simplify_passes(MXFunction::simplify_tasks_);
+    }
+
     // Add if not already added
     std::string codegen_name = add_dependency(f);
 
     // Define function
     *this << declare(f->signature(f.name())) << "{\n"
+          << blob_check("return 1;")
           << "return " << codegen_name <<  "(arg, res, iw, w, mem);\n"
           << "}\n\n";
 
     if (this->unroll_args) {
       // Define function
-      *this << declare(f->signature_unrolled(f.name())) << "{\n";
+      *this << declare(f->signature_unrolled(f.name())) << "{\n"
+            << blob_check("return 1;");
       for (casadi_int i=0; i<f.n_in(); ++i) {
         *this << "arg[" << i << "] = " << f.name_in(i) << ";\n";
       }
@@ -538,6 +571,9 @@ namespace casadi {
     // Create c file
     std::string fullname = prefix + this->name + this->suffix;
 
+    // The constant blob is placed next to it
+    blob_file_ = prefix + this->name + ".bin";
+
     auto s_ptr = Filesystem::ofstream_ptr(fullname);
     std::ostream& s = *s_ptr;
     stream_open(s, this->cpp);
@@ -566,6 +602,12 @@ namespace casadi {
     stream_close(s, this->cpp);
     s_ptr.reset();
 
+    // Write the constant blob
+    if (!blob_.empty()) {
+      auto b_ptr = Filesystem::ofstream_ptr(blob_file_, std::ios_base::binary);
+      b_ptr->write(blob_.data(), blob_.size());
+    }
+
     // Generate s-function
     if (this->with_sfunction) {
       for (unsigned ii=0; ii<this->added_sfunctions.size(); ii++) {
@@ -676,6 +718,15 @@ namespace casadi {
     // TODO(@jaeandersson): These helper functions really should be moved
     // to the runtime directory
 
+    // Sparsity patterns are missing if the constant blob cannot be read
+    std::string sp_check;
+    if (this->constant_blob=="file") {
+      sp_check = "    if (!sp) {\n"
+                 "      ssSetErrorStatus(S, \"Constant data could not be read.\");\n"
+                 "      return;\n"
+                 "    }\n";
+    }
+
     // Initialize function
     g << "/* Function: mdlInitializeSizes ===========================================\n"
       << "* Abstract:\n"
@@ -701,6 +752,7 @@ namespace casadi {
         "vectors or matrices) */\n"
       << "  for (ii=0; ii<" << f->n_in_ << "; ++ii) {\n"
       << "    sp = " << f.name() << "_sparsity_in(ii);\n"
+      << sp_check
       << "    if (sp[1]==1) {\n"
       << "      ssSetInputPortWidth(S, ii, sp[0]);\n"
       << "    }\n"
@@ -714,6 +766,7 @@ namespace casadi {
       << "  /* Configure simulink output ports (dense or sparse vectors or matrices allowed) */\n"
       << "  for (ii=0; ii<" << f->n_out_ << "; ++ii) {\n"
       << "    sp = " << f.name() << "_sparsity_out(ii);\n"
+      << sp_check
       << "    if (sp[1]==1) {\n"
       << "      ssSetOutputPortWidth(S, ii, sp[0]);\n"
       << "    }\n"
@@ -972,10 +1025,15 @@ namespace casadi {
       s << "#include <casadi/mem.h>\n" << std::endl;
     }
 
+    // Decide which constants are stored in the blob
+    blob_collect();
+
     // Macros
     if (!added_shorthands_.empty()) {
       s << "/* Add prefix to internal symbols */\n";
       for (auto&& i : added_shorthands_) {
+        // Constants in the blob are defined by their offset instead
+        if (blob_offset_.count(i)) continue;
         s << "#define " << "casadi_" << i <<  " CASADI_PREFIX(" << i <<  ")\n";
       }
       s << std::endl;
@@ -997,6 +1055,7 @@ namespace casadi {
     // Print integer constants
     if (!integer_constants_.empty()) {
       for (casadi_int i=0; i<integer_constants_.size(); ++i) {
+        if (blob_offset_.count("s" + str(i))) continue;
         print_vector(s, "casadi_s" + str(i), integer_constants_[i]);
       }
       s << std::endl;
@@ -1005,6 +1064,7 @@ namespace casadi {
     // Print double constants
     if (!double_constants_.empty()) {
       for (casadi_int i=0; i<double_constants_.size(); ++i) {
+        if (blob_offset_.count("c" + str(i))) continue;
         print_vector(s, "casadi_c" + str(i), double_constants_[i]);
       }
       s << std::endl;
@@ -1026,6 +1086,9 @@ namespace casadi {
       s << std::endl;
     }
 
+    // Constants stored in the blob
+    generate_blob(s);
+
     if (sz_zeros_) {
       std::vector<double> sz_zeros(sz_zeros_, 0);
       print_vector(s, "casadi_zeros", std::vector<double>(sz_zeros));
@@ -1154,6 +1217,130 @@ namespace casadi {
     s << array("static const char*", name, v.size(), initializer(v));
   }
 
+  template<typename T>
+  casadi_int CodeGenerator::blob_append(const std::vector<T>& v, casadi_int elsize) {
+    // Each entry starts at a multiple of 8 bytes
+    blob_.resize((blob_.size() + 7) / 8 * 8, '\0');
+    casadi_int offset = blob_.size();
+    for (T e : v) {
+      if (std::is_floating_point<T>::value && elsize==sizeof(float)) {
+        float r = static_cast<float>(e);
+        blob_.append(reinterpret_cast<const char*>(&r), sizeof(r));
+      } else if (std::is_floating_point<T>::value) {
+        double r = static_cast<double>(e);
+        blob_.append(reinterpret_cast<const char*>(&r), sizeof(r));
+      } else if (elsize==sizeof(int32_t)) {
+        int32_t r = static_cast<int32_t>(e);
+        blob_.append(reinterpret_cast<const char*>(&r), sizeof(r));
+      } else {
+        int64_t r = static_cast<int64_t>(e);
+        blob_.append(reinterpret_cast<const char*>(&r), sizeof(r));
+      }
+    }
+    return offset;
+  }
+
+  void CodeGenerator::blob_collect() {
+    blob_offset_.clear();
+    blob_.clear();
+    if (this->constant_blob=="embedded") return;
+    // Binary layout of casadi_real and casadi_int
+    casadi_int real_size = 0, int_size = 0;
+    if (this->casadi_real_type=="double") real_size = sizeof(double);
+    if (this->casadi_real_type=="float") real_size = sizeof(float);
+    if (this->casadi_int_type==CASADI_INT_TYPE_STR) int_size = sizeof(casadi_int);
+    if (this->casadi_int_type=="int" || this->casadi_int_type=="int32_t") int_size = 4;
+    if (this->casadi_int_type=="long long int" || this->casadi_int_type=="long long"
+        || this->casadi_int_type=="int64_t") int_size = 8;
+    casadi_assert(real_size>0 && int_size>0,
+      "Option constant_blob requires casadi_real to be 'double' or 'float' and casadi_int "
+      "to be a fixed width integer type, got '" + this->casadi_real_type + "' and '"
+      + this->casadi_int_type + "'");
+    // Move large constants
+    for (casadi_int i=0; i<integer_constants_.size(); ++i) {
+      if (integer_constants_[i].size()<this->constant_blob_threshold) continue;
+      blob_offset_["s" + str(i)] = blob_append(integer_constants_[i], int_size);
+    }
+    for (casadi_int i=0; i<double_constants_.size(); ++i) {
+      if (double_constants_[i].size()<this->constant_blob_threshold) continue;
+      blob_offset_["c" + str(i)] = blob_append(double_constants_[i], real_size);
+    }
+    if (!blob_offset_.empty()) shorthand("blob");
+  }
+
+  std::string CodeGenerator::blob_check(const std::string& fail) {
+    if (this->constant_blob!="file") return "";
+    return "if (!" + shorthand("blob") + "()) " + fail + "\n";
+  }
+
+  void CodeGenerator::generate_blob(std::ostream &s) {
+    if (!added_shorthands_.count("blob")) return;
+    if (this->constant_blob=="incbin") {
+      // Embedded into the object file by the assembler
+      std::string sym = this->prefix + "_blob";
+      // The assembler resolves relative paths against its working directory
+      std::string fname = blob_file_;
+      if (!Filesystem::is_absolute(fname) && Filesystem::is_enabled()) {
+        fname = Filesystem::absolute(fname);
+      }
+      s << "#ifndef CASADI_BLOB_FILE\n"
+        << "#define CASADI_BLOB_FILE " << constant(fname) << "\n"
+        << "#endif\n\n"
+        << "/* Constant data, included by the assembler. A relative CASADI_BLOB_FILE is\n"
+        << "   resolved against the working directory of the compiler, or -Wa,-I<dir> */\n"
+        << "#if defined(__GNUC__) && defined(__ELF__)\n"
+        << "__asm__(\".pushsection .rodata\\n\"\n"
+        << "        \".balign 16\\n\"\n"
+        << "        \".local " << sym << "\\n\"\n"
+        << "        \"" << sym << ":\\n\"\n"
+        << "        \".incbin \\\"\" CASADI_BLOB_FILE \"\\\"\\n\"\n"
+        << "        \".popsection\\n\");\n"
+        << "extern const char casadi_blob[] __asm__(\"" << sym << "\")"
+        << " __attribute__((visibility(\"hidden\")));\n"
+        << "#else\n"
+        << "#error \"constant_blob='incbin' requires GCC or Clang on an ELF target\"\n"
+        << "#endif\n\n";
+    } else {
+      // Read from file at the first call
+      if (blob_.empty()) {
+        s << "/* No constant data */\n"
+          << "static const char* casadi_blob(void) {\n"
+          << "  return \"\";\n";
+      } else {
+        s << "#ifndef CASADI_BLOB_FILE\n"
+          << "#define CASADI_BLOB_FILE " << constant(blob_file_) << "\n"
+          << "#endif\n\n"
+          << "/* Constant data, read by the incref routines or else at the first call.\n"
+          << "   The read is not synchronized: call incref before evaluating from\n"
+          << "   several threads. Returns 0 if the data cannot be read. */\n"
+          << "static const char* casadi_blob(void) {\n"
+          << "  static char* data = 0;\n"
+          << "  char* d;\n"
+          << "  FILE* f;\n"
+          << "  if (data) return data;\n"
+          << "  f = fopen(CASADI_BLOB_FILE, \"rb\");\n"
+          << "  if (!f) return 0;\n"
+          << "  d = (char*)malloc(" << blob_.size() << ");\n"
+          << "  if (d && fread(d, 1, " << blob_.size() << ", f)!=" << blob_.size() << ") {\n"
+          << "    free(d);\n"
+          << "    d = 0;\n"
+          << "  }\n"
+          << "  fclose(f);\n"
+          << "  data = d;\n"
+          << "  return data;\n";
+      }
+      s << "}\n\n";
+    }
+    // Constants are referenced by offset
+    std::string base = this->constant_blob=="incbin" ? "casadi_blob" : "casadi_blob()";
+    for (auto&& e : blob_offset_) {
+      std::string type = e.first[0]=='c' ? "const casadi_real*" : "const casadi_int*";
+      s << "#define casadi_" << e.first << " ((" << type << ")(" << base << "+"
+        << e.second << "))\n";
+    }
+    s << std::endl;
+  }
+
   std::string CodeGenerator::print_canonical(const Sparsity& sp, const std::string& arg) {
     add_auxiliary(AUX_PRINT_CANONICAL);
     std::stringstream s;
@@ -1681,6 +1868,12 @@ namespace casadi {
     case AUX_MTIMES_DENSE_SPARSE:
       this->auxiliaries << sanitize_source(casadi_mtimes_dense_sparse_str, inst);
       break;
+    case AUX_MTIMES_PLAN:
+      this->auxiliaries << sanitize_source(casadi_mtimes_plan_str, inst);
+      break;
+    case AUX_MTIMES_BLOCK:
+      this->auxiliaries << sanitize_source(casadi_mtimes_block_str, inst);
+      break;
     case AUX_TRILSOLVE:
       this->auxiliaries << sanitize_source(casadi_trilsolve_str, inst);
       break;
@@ -1779,6 +1972,25 @@ namespace casadi {
 
       this->auxiliaries << sanitize_source(casadi_qrqp_str, inst);
       break;
+    case AUX_KKT:
+      add_auxiliary(AUX_CLEAR);
+      this->auxiliaries << sanitize_source(casadi_kkt_str, inst);
+      break;
+    case AUX_IPQP:
+      add_auxiliary(AUX_COPY);
+      add_auxiliary(AUX_AXPY);
+      add_auxiliary(AUX_CLEAR);
+      add_auxiliary(AUX_FILL);
+      add_auxiliary(AUX_FMIN);
+      add_auxiliary(AUX_FMAX);
+      add_auxiliary(AUX_FABS);
+      add_auxiliary(AUX_INF);
+      add_auxiliary(AUX_REAL_MIN);
+      add_include("stdio.h");
+      add_include("math.h");
+
+      this->auxiliaries << sanitize_source(casadi_ipqp_str, inst);
+      break;
     case AUX_NLP:
       add_auxiliary(AUX_ORACLE);
       this->auxiliaries << sanitize_source(casadi_nlp_str, inst);
@@ -2523,6 +2735,22 @@ namespace casadi {
       + y + ", " + sparsity(sp_y) + ", " + z + ");";
   }
 
+  std::string CodeGenerator::mtimes_plan(const std::string& x, const std::string& y,
+      const std::string& z, const std::vector<casadi_int>& iz,
+      const std::vector<casadi_int>& ptr, const std::vector<casadi_int>& ix,
+      const std::vector<casadi_int>& iy) {
+    add_auxiliary(AUX_MTIMES_PLAN);
+    return "casadi_mtimes_plan(" + x + ", " + y + ", " + z + ", " + str(iz.size()) + ", "
+      + constant(iz) + ", " + constant(ptr) + ", " + constant(ix) + ", " + constant(iy) + ");";
+  }
+
+  std::string CodeGenerator::mtimes_block(const std::string& x, const std::string& y,
+      const std::string& z, casadi_int bs, const std::vector<casadi_int>& blocks) {
+    add_auxiliary(AUX_MTIMES_BLOCK);
+    return "casadi_mtimes_block(" + x + ", " + y + ", " + z + ", " + str(bs) + ", "
+      + str(blocks.size()/6) + ", " + constant(blocks) + ");";
+  }
+
   std::string CodeGenerator::trilsolve(const Sparsity& sp_x, const std::string& x,
       const std::string& y, bool tr, bool unity, casadi_int nrhs) {
     add_auxiliary(AUX_TRILSOLVE);
@@ -2792,6 +3020,7 @@ namespace casadi {
 
     // Input sparsities
     *this << declare("const casadi_int* " + name + "_sparsity_in(casadi_int i)") << " {\n"
+      << blob_check("return 0;")
       << "switch (i) {\n";
     for (casadi_int i=0; i<sp_in.size(); ++i) {
       *this << "case " << i << ": return " << sparsity(sp_in[i], force_canonical) << ";\n";
@@ -2801,6 +3030,7 @@ namespace casadi {
 
     // Output sparsities
     *this << declare("const casadi_int* " + name + "_sparsity_out(casadi_int i)") << " {\n"
+      << blob_check("return 0;")
       << "switch (i) {\n";
     for (casadi_int i=0; i<sp_out.size(); ++i) {
       *this << "case " << i << ": return " << sparsity(sp_out[i], force_canonical) << ";\n";
@@ -3004,6 +3234,8 @@ namespace casadi {
   generate_dump(const Function& f, const std::string& arr, bool is_input) {
     casadi_int n = is_input ? f.n_in() : f.n_out();
     std::string dump_format = f->dump_format_.empty() ? "mtx" : f->dump_format_;
+    // The binary dump format is not available in generated code
+    if (dump_format=="bin") dump_format = "mtx";
     std::string effective_dir = dump_dir_prefix + f->dump_dir_ + dump_dir_suffix;
     std::string prefix;
     if (!effective_dir.empty()) prefix = effective_dir + "/";
@@ -83,6 +83,13 @@ namespace casadi {
     /// Add/get a shorthand
     std::string shorthand(const std::string& name, bool allow_adding=true);
 
+    /** \brief Statement running \a fail if the constant blob cannot be read
+
+        Empty unless constant_blob is 'file'. Needed in every exposed function
+        that may read a constant.
+    */
+    std::string blob_check(const std::string& fail);
+
     /* Add a sparsity pattern
     *
     * \param canonical If true, request canonical form,
@@ -454,6 +461,18 @@ namespace casadi {
                                     const std::string& y, const Sparsity& sp_y,
                                     const std::string& z);
 
+    /** \brief Codegen sparse matrix-matrix multiplication with a product plan */
+    std::string mtimes_plan(const std::string& x, const std::string& y,
+                            const std::string& z, const std::vector<casadi_int>& iz,
+                            const std::vector<casadi_int>& ptr,
+                            const std::vector<casadi_int>& ix,
+                            const std::vector<casadi_int>& iy);
+
+    /** \brief Codegen block-sparse matrix-matrix multiplication */
+    std::string mtimes_block(const std::string& x, const std::string& y,
+                             const std::string& z, casadi_int bs,
+                             const std::vector<casadi_int>& blocks);
+
     /** \brief Codegen lower triangular solve
 
         \identifier{ss} */
@@ -710,6 +729,8 @@ namespace casadi {
       AUX_MTIMES,
       AUX_MTIMES_DENSE,
       AUX_MTIMES_DENSE_SPARSE,
+      AUX_MTIMES_PLAN,
+      AUX_MTIMES_BLOCK,
       AUX_TRILSOLVE,
       AUX_TRIUSOLVE,
       AUX_PROJECT,
@@ -733,6 +754,8 @@ namespace casadi {
       AUX_DET,
       AUX_QP,
       AUX_QRQP,
+      AUX_KKT,
+      AUX_IPQP,
       AUX_SOCP,
       AUX_NLP,
       AUX_SQPMETHOD,
@@ -1033,6 +1056,16 @@ namespace casadi {
     // Generate import symbol macros
     void generate_import_symbol(std::ostream &s) const;
 
+    // Move constants above the size threshold to the binary blob
+    void blob_collect();
+
+    // Generate the references to the binary blob
+    void generate_blob(std::ostream &s);
+
+    // Append a constant to the binary blob, return its byte offset
+    template<typename T>
+    casadi_int blob_append(const std::vector<T>& v, casadi_int elsize);
+
     //  private:
   public:
     /// \cond INTERNAL
@@ -1115,6 +1148,15 @@ namespace casadi {
     // Emit thread-safe checkout/release?
     bool thread_safe_;
 
+    // Storage of large constants: "embedded", "file" or "incbin"
+    std::string constant_blob;
+
+    // Minimum number of elements of a constant stored outside of the source
+    casadi_int constant_blob_threshold;
+
+    // Simplify the graph of MX functions before generating code?
+    bool simplify;
+
     // Prefix symbols in DLLs?
     std::string dll_export, dll_import;
 
@@ -1188,6 +1230,15 @@ namespace casadi {
     std::vector<std::vector<char> > char_constants_;
     std::vector<std::vector<std::string> > string_constants_;
 
+    // Constants stored in the binary blob: shorthand and byte offset
+    std::map<std::string, casadi_int> blob_offset_;
+
+    // Contents of the binary blob
+    std::string blob_;
+
+    // Location of the binary blob, as referenced from the generated code
+    std::string blob_file_;
+
     // Does any function need thread-local memory?
     bool needs_mem_;
 
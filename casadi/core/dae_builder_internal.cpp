@@ -37,6 +37,7 @@
 #include "code_generator.hpp"
 #include "calculus.hpp"
 #include "xml_file.hpp"
+#include "xml_reader.hpp"
 #include "external.hpp"
 #include "fmu_function.hpp"
 #include "integrator.hpp"
@@ -664,6 +665,7 @@ DaeBuilderInternal::DaeBuilderInternal(const std::string& name, const std::strin
   provides_directional_derivatives_ = false;
   provides_adjoint_derivatives_ = false;
   can_be_instantiated_only_once_per_process_ = false;
+  can_get_and_set_fmu_state_ = false;
   symbolic_ = true;
   detect_quad_ = false;
   start_time_ = nan;
@@ -716,9 +718,11 @@ void DaeBuilderInternal::load_fmi_description(const std::string& filename) {
   // Ensure no variables already
   casadi_assert(n_variables() == 0, "Instance already has variables");
 
-  // Parse XML file
-  XmlFile xml_file("tinyxml");
-  XmlNode fmi_desc = xml_file.parse(filename)[0];  // One child; fmiModelDescription
+  // Read XML file incrementally, without a document tree for ModelVariables
+  auto xml_ptr = Filesystem::ifstream_ptr(filename);
+  XmlReader xml(*xml_ptr);
+  XmlNode xml_doc, fmi_desc;
+  casadi_assert(xml.next(xml_doc, fmi_desc), "Missing 'fmiModelDescription'");
 
   // Read FMU version
   fmi_version_ = fmi_desc.attribute<std::string>("fmiVersion", "");
@@ -752,6 +756,28 @@ void DaeBuilderInternal::load_fmi_description(const std::string& filename) {
     nzero_ = fmi_desc.attribute<casadi_int>("numberOfEventIndicators", 0);
   }
 
+  // Read sections, importing ModelVariables one variable at a time
+  bool has_model_variables = false;
+  XmlNode section;
+  while (xml.next(fmi_desc, section)) {
+    if (section.name == "ModelVariables") {
+      casadi_assert(!has_model_variables, "Duplicate 'ModelVariables'");
+      has_model_variables = true;
+      // Mapping from derivative variables to corresponding state variables, FMUX only
+      std::vector<std::pair<std::string, std::string>> fmi1_der;
+      XmlNode vnode;
+      while (xml.next(section, vnode)) {
+        xml.read_body(vnode);
+        import_model_variable(vnode, fmi1_der);
+      }
+      finalize_model_variables(fmi1_der);
+    } else {
+      xml.read_body(section);
+      fmi_desc.children.push_back(std::move(section));
+    }
+  }
+  casadi_assert(has_model_variables, "Missing 'ModelVariables'");
+
   // Process DefaultExperiment
   if (fmi_desc.has_child("DefaultExperiment")) {
     import_default_experiment(fmi_desc["DefaultExperiment"]);
@@ -764,10 +790,6 @@ void DaeBuilderInternal::load_fmi_description(const std::string& filename) {
     import_model_exchange(fmi_desc["ModelExchange"]);
   }
 
-  // Process ModelVariables
-  casadi_assert(fmi_desc.has_child("ModelVariables"), "Missing 'ModelVariables'");
-  import_model_variables(fmi_desc["ModelVariables"]);
-
   // Process model structure
   if (fmi_desc.has_child("ModelStructure")) {
     import_model_structure(fmi_desc["ModelStructure"]);
@@ -3407,20 +3429,25 @@ void DaeBuilderInternal::categorize(size_t ind, Category cat) {
 
 void DaeBuilderInternal::insert(std::vector<size_t>& v, size_t ind) const {
   // Keep list ordered: Insert at location corresponding to model variable index
-  size_t loc = v.size();
-  for (size_t i = 0; i < v.size(); ++i) {
-    if (variable(v[i]).index >= ind) {
-      loc = i;
-      break;
-    }
+  if (v.empty() || v.back() < ind) {
+    // Common case when importing variables in order
+    v.push_back(ind);
+  } else {
+    v.insert(std::lower_bound(v.begin(), v.end(), ind), ind);
   }
-  v.insert(v.begin() + loc, ind);
 }
 
 void DaeBuilderInternal::remove(std::vector<size_t>& v, size_t ind) const {
-  for (auto it = v.begin(); it != v.end(); ++it) {
+  // Most lists are ordered by variable index, try a binary search first
+  auto it_sorted = std::lower_bound(v.begin(), v.end(), ind);
+  if (it_sorted != v.end() && *it_sorted == ind) {
+    v.erase(it_sorted);
+    return;
+  }
+  // Linear search, from the back
+  for (auto it = v.rbegin(); it != v.rend(); ++it) {
     if (*it == ind) {
-      v.erase(it);
+      v.erase(std::next(it).base());
       return;
     }
   }
@@ -3836,6 +3863,8 @@ void DaeBuilderInternal::import_model_exchange(const XmlNode& n) {
   model_identifier_ = n.attribute<std::string>("modelIdentifier");
   can_be_instantiated_only_once_per_process_ =
     n.attribute<bool>("canBeInstantiatedOnlyOncePerProcess", false);
+  can_get_and_set_fmu_state_ = n.attribute<bool>(
+    fmi_major_ >= 3 ? "canGetAndSetFMUState" : "canGetAndSetFMUstate", false);
   // Get list of source files
   if (n.has_child("SourceFiles")) {
     for (const XmlNode& sf : n["SourceFiles"].children) {
@@ -3844,161 +3873,156 @@ void DaeBuilderInternal::import_model_exchange(const XmlNode& n) {
   }
 }
 
-void DaeBuilderInternal::import_model_variables(const XmlNode& modvars) {
-  // Mapping from derivative variables to corresponding state variables, FMUX only
-  std::vector<std::pair<std::string, std::string>> fmi1_der;
-
-  // Add variables
-  for (casadi_int i = 0; i < modvars.size(); ++i) {
-    // Get a reference to the variable
-    const XmlNode& vnode = modvars[i];
-
-    // Name of variable
-    std::string name = vnode.attribute<std::string>("name");
-
-    // Handle variable categories (FMUX)
-    if (fmi_major_ == 1 && vnode.has_child("VariableCategory")) {
-      std::string variable_category = vnode["VariableCategory"].text;
-      if (variable_category == "derivative") {
-        // Create a new derivative variable
-        std::string x_name = vnode["QualifiedName"][0].attribute<std::string>("name");
-        fmi1_der.push_back(std::make_pair(x_name, name));
-      }
+void DaeBuilderInternal::import_model_variable(const XmlNode& vnode,
+    std::vector<std::pair<std::string, std::string>>& fmi1_der) {
+  // Name of variable
+  std::string name = vnode.attribute<std::string>("name");
+
+  // Handle variable categories (FMUX)
+  if (fmi_major_ == 1 && vnode.has_child("VariableCategory")) {
+    std::string variable_category = vnode["VariableCategory"].text;
+    if (variable_category == "derivative") {
+      // Create a new derivative variable
+      std::string x_name = vnode["QualifiedName"][0].attribute<std::string>("name");
+      fmi1_der.push_back(std::make_pair(x_name, name));
     }
+  }
 
-    // When conditions are reformulated into continuous zero-crossing functions
-    if (fmi_major_ == 1 && name.rfind("$whenCondition", 0) == 0) continue;
+  // When conditions are reformulated into continuous zero-crossing functions
+  if (fmi_major_ == 1 && name.rfind("$whenCondition", 0) == 0) return;
 
-    // Ignore duplicate variables
-    if (varind_.find(name) != varind_.end()) {
-      casadi_warning("Duplicate variable '" + name + "' ignored");
-      continue;
-    }
+  // Ignore duplicate variables
+  if (varind_.find(name) != varind_.end()) {
+    casadi_warning("Duplicate variable '" + name + "' ignored");
+    return;
+  }
 
-    // Type specific properties
-    Dict opts;
-    Type type = Type::NUMEL;
-    casadi_int derivative = -1;
-    if (fmi_major_ >= 3) {
-      // FMI 3.0: Type information in the same node
-      type = to_enum<Type>(vnode.name);
-      switch (type) {
-      case Type::FLOAT32:  // fall-through
-      case Type::FLOAT64:
-        // Floating point valued variables
-        opts["unit"] = vnode.attribute<std::string>("unit", "");
-        opts["display_unit"] = vnode.attribute<std::string>("displayUnit", "");
-        opts["min"] = vnode.attribute<double>("min", -inf);
-        opts["max"] = vnode.attribute<double>("max", inf);
-        opts["nominal"] = vnode.attribute<double>("nominal", 1.);
-        opts["start"] = vnode.attribute<double>("start", 0.);
-        derivative = vnode.attribute<casadi_int>("derivative", -1);
-        break;
-      case Type::INT8:  // fall-through
-      case Type::UINT8:  // fall-through
-      case Type::INT16:  // fall-through
-      case Type::UINT16:  // fall-through
-      case Type::INT32:  // fall-through
-      case Type::UINT32:  // fall-through
-      case Type::INT64:  // fall-through
-      case Type::UINT64:  // fall-through
-        // Integer valued variables
-        opts["min"] = vnode.attribute<double>("min", -inf);
-        opts["max"] = vnode.attribute<double>("max", inf);
-        break;
-      default:
-        break;
-      }
+  // Type specific properties
+  Dict opts;
+  Type type = Type::NUMEL;
+  casadi_int derivative = -1;
+  if (fmi_major_ >= 3) {
+    // FMI 3.0: Type information in the same node
+    type = to_enum<Type>(vnode.name);
+    switch (type) {
+    case Type::FLOAT32:  // fall-through
+    case Type::FLOAT64:
+      // Floating point valued variables
+      opts["unit"] = vnode.attribute<std::string>("unit", "");
+      opts["display_unit"] = vnode.attribute<std::string>("displayUnit", "");
+      opts["min"] = vnode.attribute<double>("min", -inf);
+      opts["max"] = vnode.attribute<double>("max", inf);
+      opts["nominal"] = vnode.attribute<double>("nominal", 1.);
+      opts["start"] = vnode.attribute<double>("start", 0.);
+      derivative = vnode.attribute<casadi_int>("derivative", -1);
+      break;
+    case Type::INT8:  // fall-through
+    case Type::UINT8:  // fall-through
+    case Type::INT16:  // fall-through
+    case Type::UINT16:  // fall-through
+    case Type::INT32:  // fall-through
+    case Type::UINT32:  // fall-through
+    case Type::INT64:  // fall-through
+    case Type::UINT64:  // fall-through
+      // Integer valued variables
+      opts["min"] = vnode.attribute<double>("min", -inf);
+      opts["max"] = vnode.attribute<double>("max", inf);
+      break;
+    default:
+      break;
+    }
+  } else {
+    // FMI 1.0 / 2.0: Type information in a separate node
+    if (vnode.has_child("Real")) {
+      type = Type::FLOAT64;
+      const XmlNode& props = vnode["Real"];
+      opts["unit"] = props.attribute<std::string>("unit", "");
+      opts["display_unit"] = props.attribute<std::string>("displayUnit", "");
+      opts["min"] = props.attribute<double>("min", -inf);
+      opts["max"] = props.attribute<double>("max", inf);
+      opts["nominal"] = props.attribute<double>("nominal", 1.);
+      opts["start"] = props.attribute<double>("start", 0.);
+      derivative = props.attribute<casadi_int>("derivative", -1);
+    } else if (vnode.has_child("Integer")) {
+      type = Type::INT32;
+      const XmlNode& props = vnode["Integer"];
+      opts["min"] = props.attribute<double>("min", -inf);
+      opts["max"] = props.attribute<double>("max", inf);
+    } else if (vnode.has_child("Boolean")) {
+      type = Type::BOOLEAN;
+    } else if (vnode.has_child("String")) {
+      type = Type::STRING;
+    } else if (vnode.has_child("Enumeration")) {
+      type = Type::ENUMERATION;
     } else {
-      // FMI 1.0 / 2.0: Type information in a separate node
-      if (vnode.has_child("Real")) {
-        type = Type::FLOAT64;
-        const XmlNode& props = vnode["Real"];
-        opts["unit"] = props.attribute<std::string>("unit", "");
-        opts["display_unit"] = props.attribute<std::string>("displayUnit", "");
-        opts["min"] = props.attribute<double>("min", -inf);
-        opts["max"] = props.attribute<double>("max", inf);
-        opts["nominal"] = props.attribute<double>("nominal", 1.);
-        opts["start"] = props.attribute<double>("start", 0.);
-        derivative = props.attribute<casadi_int>("derivative", -1);
-      } else if (vnode.has_child("Integer")) {
-        type = Type::INT32;
-        const XmlNode& props = vnode["Integer"];
-        opts["min"] = props.attribute<double>("min", -inf);
-        opts["max"] = props.attribute<double>("max", inf);
-      } else if (vnode.has_child("Boolean")) {
-        type = Type::BOOLEAN;
-      } else if (vnode.has_child("String")) {
-        type = Type::STRING;
-      } else if (vnode.has_child("Enumeration")) {
-        type = Type::ENUMERATION;
-      } else {
-        casadi_warning("Unknown type for " + name);
-      }
+      casadi_warning("Unknown type for " + name);
     }
+  }
 
-    // Description
-    std::string description = vnode.attribute<std::string>("description", "");
-
-    // Causality (FMI 1.0 -> FMI 2.0+)
-    std::string causality_str = vnode.attribute<std::string>("causality", "local");
-    if (fmi_major_ == 1 && causality_str == "internal") causality_str = "local";
-    Causality causality = to_enum<Causality>(causality_str);
-
-    // Variability (FMI 1.0 -> FMI 2.0+)
-    std::string variability_str = vnode.attribute<std::string>("variability",
-      to_string(default_variability(causality, type)));
-    if (fmi_major_ == 1 && variability_str == "parameter") variability_str = "fixed";
-    Variability variability = to_enum<Variability>(variability_str);
-
-    // Initial property
-    Initial initial = default_initial(causality, variability);
-    std::string initial_str = vnode.attribute<std::string>("initial", "");
-    if (!initial_str.empty()) {
-      // Consistency check
-      casadi_assert(causality != Causality::INPUT && causality != Causality::INDEPENDENT,
-        "The combination causality = '" + to_string(causality) + "', "
-        "initial = '" + initial_str + "' is not allowed per the FMI specification.");
-      initial = to_enum<Initial>(initial_str);
-    }
+  // Description
+  std::string description = vnode.attribute<std::string>("description", "");
 
-    // If an input has a description that starts with "PARAMETER:",
-    // treat it as a tunable parameter
-    if (causality == Causality::INPUT && description.rfind("PARAMETER:", 0) == 0) {
-      // Make tunable parameter
-      causality = Causality::PARAMETER;
-      variability = Variability::TUNABLE;
-    }
+  // Causality (FMI 1.0 -> FMI 2.0+)
+  std::string causality_str = vnode.attribute<std::string>("causality", "local");
+  if (fmi_major_ == 1 && causality_str == "internal") causality_str = "local";
+  Causality causality = to_enum<Causality>(causality_str);
 
-    // Create the new variable
-    opts["type"] = to_string(type);
-    opts["initial"] = to_string(initial);
-    opts["description"] = description;
-    Variable& var = add(name, causality, variability, opts);
-    if (debug_) uout() << "Added variable: " << var.name << std::endl;
+  // Variability (FMI 1.0 -> FMI 2.0+)
+  std::string variability_str = vnode.attribute<std::string>("variability",
+    to_string(default_variability(causality, type)));
+  if (fmi_major_ == 1 && variability_str == "parameter") variability_str = "fixed";
+  Variability variability = to_enum<Variability>(variability_str);
 
-    // Ignore time variable?
-    if (causality == Causality::INDEPENDENT && ignore_time_) {
-      categorize(var.index, Category::NUMEL);
-    }
+  // Initial property
+  Initial initial = default_initial(causality, variability);
+  std::string initial_str = vnode.attribute<std::string>("initial", "");
+  if (!initial_str.empty()) {
+    // Consistency check
+    casadi_assert(causality != Causality::INPUT && causality != Causality::INDEPENDENT,
+      "The combination causality = '" + to_string(causality) + "', "
+      "initial = '" + initial_str + "' is not allowed per the FMI specification.");
+    initial = to_enum<Initial>(initial_str);
+  }
 
-    // Do not permit discrete variables in x, for now
-    if (variability == Variability::DISCRETE) {
-      categorize(var.index, Category::NUMEL);
-    }
+  // If an input has a description that starts with "PARAMETER:",
+  // treat it as a tunable parameter
+  if (causality == Causality::INPUT && description.rfind("PARAMETER:", 0) == 0) {
+    // Make tunable parameter
+    causality = Causality::PARAMETER;
+    variability = Variability::TUNABLE;
+  }
 
-    // Derivative attribute
-    var.der_of = derivative;
+  // Create the new variable
+  opts["type"] = to_string(type);
+  opts["initial"] = to_string(initial);
+  opts["description"] = description;
+  Variable& var = add(name, causality, variability, opts);
+  if (debug_) uout() << "Added variable: " << var.name << std::endl;
 
-    // Unless detect_quad has been set, assume all variables in the right-hand-sides
-    // Prevents changing X to Q
-    var.in_rhs = !detect_quad_ && fmi_major_ >= 2;
-    var.value_reference = static_cast<unsigned int>(vnode.attribute<casadi_int>("valueReference"));
+  // Ignore time variable?
+  if (causality == Causality::INDEPENDENT && ignore_time_) {
+    categorize(var.index, Category::NUMEL);
+  }
 
-    // Add to variable reference map
-    vrmap_[var.value_reference] = var.index;
+  // Do not permit discrete variables in x, for now
+  if (variability == Variability::DISCRETE) {
+    categorize(var.index, Category::NUMEL);
   }
 
+  // Derivative attribute
+  var.der_of = derivative;
+
+  // Unless detect_quad has been set, assume all variables in the right-hand-sides
+  // Prevents changing X to Q
+  var.in_rhs = !detect_quad_ && fmi_major_ >= 2;
+  var.value_reference = static_cast<unsigned int>(vnode.attribute<casadi_int>("valueReference"));
+
+  // Add to variable reference map
+  vrmap_[var.value_reference] = var.index;
+}
+
+void DaeBuilderInternal::finalize_model_variables(
+    const std::vector<std::pair<std::string, std::string>>& fmi1_der) {
   // Set "parent" property using "derivative" attribute
   for (size_t i = 0; i < n_variables(); ++i) {
     Variable& v = variable(i);
@@ -4072,13 +4096,13 @@ void DaeBuilderInternal::import_model_structure(const XmlNode& n) {
   indices(Category::Y).clear();
 
   // Algebraic variables are handled internally in the FMU by default
-  for (size_t i = 0; i < n_variables(); ++i) {
-    Variable& v = variable(i);
-    if (v.category == Category::Z) {
-      // Mark as dependent variable, no need for an algebraic equation anymore
-      categorize(v.index, Category::W);
-    }
+  // Mark as dependent variables, no need for an algebraic equation anymore.
+  // Moved all at once, since removing them one by one is quadratic in the number of variables
+  for (size_t i : indices(Category::Z)) {
+    variable(i).category = Category::W;
+    indices(Category::W).push_back(i);
   }
+  indices(Category::Z).clear();
 
   // Read structure
   if (fmi_major_ >= 3) {
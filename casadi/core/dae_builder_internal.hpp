@@ -524,6 +524,7 @@ protected:
   bool provides_directional_derivatives_;
   bool provides_adjoint_derivatives_;
   bool can_be_instantiated_only_once_per_process_;
+  bool can_get_and_set_fmu_state_;
   std::vector<std::string> source_files_;
 
   /// Name of instance
@@ -693,10 +694,13 @@ protected:
   // Read ModelExchange
   void import_model_exchange(const XmlNode& n);
 
-  /** \brief Read ModelVariables
+  // Read a single ModelVariables entry
+  void import_model_variable(const XmlNode& vnode,
+    std::vector<std::pair<std::string, std::string>>& fmi1_der);
 
-      \identifier{2ft} */
-  void import_model_variables(const XmlNode& modvars);
+  // Resolve references between variables after all ModelVariables entries have been read
+  void finalize_model_variables(
+    const std::vector<std::pair<std::string, std::string>>& fmi1_der);
 
   // Read ModelStructure
   void import_model_structure(const XmlNode& n);
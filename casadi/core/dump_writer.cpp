@@ -0,0 +1,358 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "dump_writer.hpp"
+#include "casadi_misc.hpp"
+#include "filesystem_impl.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <limits>
+#include <map>
+
+namespace casadi {
+
+  namespace {
+    const char dump_magic[12] = "CASADI_DUMP";
+    const uint32_t dump_version = 2;
+    const uint32_t dump_layout = 2;
+
+    template<typename T>
+    char* put(char* p, T v) {
+      std::memcpy(p, &v, sizeof(T));
+      return p + sizeof(T);
+    }
+
+    template<typename T>
+    bool get(std::istream& s, T& v) {
+      return static_cast<bool>(s.read(reinterpret_cast<char*>(&v), sizeof(T)));
+    }
+
+    // Bytes needed for the record body (excluding the leading size field)
+    size_t record_size(const std::vector<casadi_int>& nnz) {
+      size_t ret = sizeof(uint32_t) + 2*sizeof(int64_t);
+      for (casadi_int n : nnz) ret += sizeof(int64_t) + n*sizeof(double);
+      return ret;
+    }
+
+    // Writers currently open, by file name
+    std::map<std::string, std::weak_ptr<DumpWriter>> open_writers;
+
+    // Key of a file in open_writers, so that e.g. "./f.casadi_dump" and "f.casadi_dump" match
+    std::string writer_key(const std::string& fname) {
+      std::string ret = fname;
+      while (ret.size()>2 && ret[0]=='.' && (ret[1]=='/' || ret[1]=='\\')) ret.erase(0, 2);
+      if (Filesystem::is_enabled() && !Filesystem::is_absolute(ret)) {
+        ret = Filesystem::absolute(ret);
+      }
+      return ret;
+    }
+#ifdef CASADI_WITH_THREAD
+    std::mutex open_writers_mtx;
+#endif // CASADI_WITH_THREAD
+  } // namespace
+
+  std::shared_ptr<DumpWriter> DumpWriter::open(const std::string& fname, casadi_int capacity,
+      const std::vector<Sparsity> (&sp)[2]) {
+#ifdef CASADI_WITH_THREAD
+    std::lock_guard<std::mutex> lock(open_writers_mtx);
+#endif // CASADI_WITH_THREAD
+    std::string key = writer_key(fname);
+    std::weak_ptr<DumpWriter>& e = open_writers[key];
+    std::shared_ptr<DumpWriter> w = e.lock();
+    if (w) {
+      for (casadi_int k=0; k<2; ++k) {
+        bool match = w->sp_[k].size()==sp[k].size();
+        for (size_t i=0; match && i<sp[k].size(); ++i) match = w->sp_[k][i]==sp[k][i];
+        casadi_assert(match, "'" + fname + "' is already being written by a Function "
+          "with a different " + (k ? "output" : "input") + " sparsity.");
+      }
+      return w;
+    }
+    // Closing a writer is serialized with opening one, so that appends do not interleave
+    w = std::shared_ptr<DumpWriter>(new DumpWriter(fname, capacity, sp), [key](DumpWriter* p) {
+#ifdef CASADI_WITH_THREAD
+      std::lock_guard<std::mutex> lock(open_writers_mtx);
+#endif // CASADI_WITH_THREAD
+      delete p;
+      auto it = open_writers.find(key);
+      if (it!=open_writers.end() && it->second.expired()) open_writers.erase(it);
+    });
+    e = w;
+    return w;
+  }
+
+  DumpWriter::DumpWriter(const std::string& fname, casadi_int capacity,
+      const std::vector<Sparsity> (&sp)[2]) : n_push_(0), n_dropped_(0) {
+    casadi_assert(capacity>0, "Dump buffer must hold at least one record.");
+    for (casadi_int k=0; k<2; ++k) {
+      sp_[k] = sp[k];
+      for (const Sparsity& s : sp[k]) nnz_[k].push_back(s.nnz());
+    }
+    slot_size_ = sizeof(uint32_t) + std::max(record_size(nnz_[0]), record_size(nnz_[1]));
+
+    // Only write a header when starting a new file
+    bool fresh;
+    {
+      auto in = Filesystem::ifstream_ptr(fname, std::ios_base::in | std::ios_base::binary, false);
+      fresh = !in || !in->good() || in->peek()==std::char_traits<char>::eof();
+    }
+    stream_ = Filesystem::ofstream_ptr(fname, std::ios_base::app | std::ios_base::binary);
+    if (fresh) {
+      stream_->write(dump_magic, sizeof(dump_magic));
+      stream_->write(reinterpret_cast<const char*>(&dump_version), sizeof(dump_version));
+    }
+
+    // Sparsity of the records that follow
+    std::vector<char> layout(sizeof(uint32_t) + sizeof(uint32_t) + 2*sizeof(int64_t));
+    char* p = get_ptr(layout) + sizeof(uint32_t);
+    p = put<uint32_t>(p, dump_layout);
+    p = put<int64_t>(p, static_cast<int64_t>(sp_[0].size()));
+    put<int64_t>(p, static_cast<int64_t>(sp_[1].size()));
+    for (casadi_int k=0; k<2; ++k) {
+      for (const Sparsity& s : sp_[k]) {
+        std::vector<casadi_int> c = s.compress();
+        size_t off = layout.size();
+        layout.resize(off + sizeof(int64_t) + c.size()*sizeof(int64_t));
+        p = put<int64_t>(&layout[off], static_cast<int64_t>(c.size()));
+        for (casadi_int v : c) p = put<int64_t>(p, v);
+      }
+    }
+    put<uint32_t>(get_ptr(layout), static_cast<uint32_t>(layout.size() - sizeof(uint32_t)));
+    stream_->write(get_ptr(layout), layout.size());
+
+#ifdef CASADI_WITH_THREAD
+    // Round up to a power of two
+    size_t n_slot = 1;
+    while (n_slot<static_cast<size_t>(capacity)) n_slot *= 2;
+    mask_ = n_slot - 1;
+    seq_.reset(new std::atomic<size_t>[n_slot]);
+    for (size_t k=0; k<n_slot; ++k) seq_[k] = k;
+    data_.resize(n_slot*slot_size_);
+    len_.resize(n_slot);
+    enqueue_pos_ = 0;
+    dequeue_pos_ = 0;
+    flush_pos_ = 0;
+    stop_ = false;
+    thread_ = std::thread([this]() { run();});
+#else // CASADI_WITH_THREAD
+    data_.resize(slot_size_);
+#endif // CASADI_WITH_THREAD
+  }
+
+  DumpWriter::~DumpWriter() {
+#ifdef CASADI_WITH_THREAD
+    stop_.store(true, std::memory_order_release);
+    thread_.join();
+#endif // CASADI_WITH_THREAD
+    stream_->flush();
+  }
+
+  size_t DumpWriter::serialize(char* slot, bool out, casadi_int id,
+      const double* const* v) const {
+    const std::vector<casadi_int>& nnz = nnz_[out];
+    char* p = slot + sizeof(uint32_t);
+    p = put<uint32_t>(p, out ? 1 : 0);
+    p = put<int64_t>(p, id);
+    p = put<int64_t>(p, static_cast<int64_t>(nnz.size()));
+    for (size_t i=0; i<nnz.size(); ++i) {
+      if (v[i]) {
+        p = put<int64_t>(p, nnz[i]);
+        std::memcpy(p, v[i], nnz[i]*sizeof(double));
+        p += nnz[i]*sizeof(double);
+      } else {
+        p = put<int64_t>(p, -1);
+      }
+    }
+    size_t len = p - slot;
+    put<uint32_t>(slot, static_cast<uint32_t>(len - sizeof(uint32_t)));
+    return len;
+  }
+
+  bool DumpWriter::push(bool out, casadi_int id, const double* const* v) {
+    n_push_.fetch_add(1, std::memory_order_relaxed);
+#ifdef CASADI_WITH_THREAD
+    // Claim a free slot
+    size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    while (true) {
+      size_t seq = seq_[pos & mask_].load(std::memory_order_acquire);
+      if (seq==pos) {
+        if (enqueue_pos_.compare_exchange_weak(pos, pos+1, std::memory_order_relaxed)) break;
+      } else if (seq<pos) {
+        // Queue full
+        n_dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      } else {
+        pos = enqueue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+    // Fill and publish it
+    size_t k = pos & mask_;
+    len_[k] = serialize(&data_[k*slot_size_], out, id, v);
+    seq_[k].store(pos+1, std::memory_order_release);
+#else // CASADI_WITH_THREAD
+    stream_->write(get_ptr(data_), serialize(get_ptr(data_), out, id, v));
+#endif // CASADI_WITH_THREAD
+    return true;
+  }
+
+  void DumpWriter::flush() {
+#ifdef CASADI_WITH_THREAD
+    // Records claimed before this point are published shortly after
+    size_t pos = enqueue_pos_.load(std::memory_order_acquire);
+    while (flush_pos_.load(std::memory_order_acquire)<pos) std::this_thread::yield();
+#else // CASADI_WITH_THREAD
+    stream_->flush();
+#endif // CASADI_WITH_THREAD
+  }
+
+#ifdef CASADI_WITH_THREAD
+  void DumpWriter::run() {
+    casadi_int idle = 0;
+    while (true) {
+      size_t k = dequeue_pos_ & mask_;
+      if (seq_[k].load(std::memory_order_acquire)==dequeue_pos_+1) {
+        stream_->write(&data_[k*slot_size_], len_[k]);
+        // Hand the slot back to the producers
+        seq_[k].store(dequeue_pos_ + mask_ + 1, std::memory_order_release);
+        dequeue_pos_++;
+        idle = 0;
+      } else if (stop_.load(std::memory_order_acquire)) {
+        // Records published before stopping are visible now
+        if (seq_[k].load(std::memory_order_acquire)!=dequeue_pos_+1) break;
+      } else {
+        // Back off while idle, flushing once
+        if (idle++==0) {
+          stream_->flush();
+          flush_pos_.store(dequeue_pos_, std::memory_order_release);
+        }
+        if (idle<64) {
+          std::this_thread::yield();
+        } else {
+          std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+      }
+    }
+  }
+#endif // CASADI_WITH_THREAD
+
+  std::vector<std::vector<double>> DumpWriter::read(const std::string& fname, bool out,
+      const std::vector<Sparsity>& sp) {
+    // Records may still be queued
+    std::shared_ptr<DumpWriter> w;
+    {
+#ifdef CASADI_WITH_THREAD
+      std::lock_guard<std::mutex> lock(open_writers_mtx);
+#endif // CASADI_WITH_THREAD
+      auto it = open_writers.find(writer_key(fname));
+      if (it!=open_writers.end()) w = it->second.lock();
+    }
+    if (w) w->flush();
+
+    auto in_ptr = Filesystem::ifstream_ptr(fname, std::ios_base::in | std::ios_base::binary);
+    std::istream& in = *in_ptr;
+
+    // Header
+    char magic[sizeof(dump_magic)];
+    uint32_t version;
+    casadi_assert(in.read(magic, sizeof(magic)) && std::memcmp(magic, dump_magic, sizeof(magic))==0
+      && get(in, version), "'" + fname + "' is not a CasADi binary dump.");
+    casadi_assert(version==dump_version,
+      "Unsupported dump version " + str(version) + " in '" + fname + "'.");
+    casadi_int nnz_tot = 0;
+    for (const Sparsity& s : sp) nnz_tot += s.nnz();
+
+    // Entry of the current layout not matching sp, -1 if none, -2 before any layout
+    casadi_int mismatch = -2;
+
+    std::vector<std::vector<double>> ret;
+    std::vector<char> buf;
+    uint32_t size;
+    while (get(in, size)) {
+      buf.resize(size);
+      // A truncated record at the end is ignored
+      if (!in.read(get_ptr(buf), size)) break;
+      const char* p = get_ptr(buf);
+      auto take = [&](void* dest, size_t n) {
+        casadi_assert(p + n <= get_ptr(buf) + buf.size(), "Corrupt record in '" + fname + "'.");
+        if (n==0) return;
+        std::memcpy(dest, p, n);
+        p += n;
+      };
+      uint32_t kind;
+      take(&kind, sizeof(kind));
+      if (kind==dump_layout) {
+        int64_t n[2];
+        take(n, sizeof(n));
+        // A different number of entries is reported with the records
+        mismatch = -1;
+        for (casadi_int k=0; k<2; ++k) {
+          for (int64_t i=0; i<n[k]; ++i) {
+            int64_t len;
+            take(&len, sizeof(len));
+            casadi_assert(len>=0 && static_cast<size_t>(len)
+              <= (get_ptr(buf) + buf.size() - p)/sizeof(int64_t),
+              "Corrupt record in '" + fname + "'.");
+            std::vector<int64_t> c(len);
+            take(get_ptr(c), len*sizeof(int64_t));
+            if (k!=out || mismatch!=-1 || i>=static_cast<int64_t>(sp.size())) continue;
+            if (Sparsity::compressed(std::vector<casadi_int>(c.begin(), c.end()))!=sp[i]) {
+              mismatch = i;
+            }
+          }
+        }
+        continue;
+      }
+      if (kind!=(out ? 1u : 0u)) continue;
+      int64_t id, n;
+      take(&id, sizeof(id));
+      take(&n, sizeof(n));
+      casadi_assert(mismatch!=-2, "Record " + str(id) + " in '" + fname + "' "
+        "precedes any sparsity layout.");
+      casadi_assert(n==static_cast<int64_t>(sp.size()),
+        "Record " + str(id) + " in '" + fname + "' has " + str(n) + " entries, "
+        "expected " + str(sp.size()) + ".");
+      casadi_assert(mismatch==-1, "Sparsity mismatch for entry " + str(mismatch)
+        + " of record " + str(id) + " in '" + fname + "'.");
+      std::vector<double> d;
+      d.reserve(nnz_tot);
+      for (size_t i=0; i<sp.size(); ++i) {
+        int64_t m;
+        take(&m, sizeof(m));
+        if (m<0) {
+          d.resize(d.size() + sp[i].nnz(), out ? std::numeric_limits<double>::quiet_NaN() : 0.);
+        } else {
+          casadi_assert(m==sp[i].nnz(), "Dimension mismatch for entry " + str(i)
+            + " of record " + str(id) + " in '" + fname + "'.");
+          d.resize(d.size() + m);
+          take(get_ptr(d) + d.size() - m, m*sizeof(double));
+        }
+      }
+      ret.push_back(std::move(d));
+    }
+    return ret;
+  }
+
+} // namespace casadi
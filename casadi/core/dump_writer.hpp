@@ -0,0 +1,142 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#ifndef CASADI_DUMP_WRITER_HPP
+#define CASADI_DUMP_WRITER_HPP
+
+#include "sparsity.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#ifdef CASADI_WITH_THREAD
+#ifdef CASADI_WITH_THREAD_MINGW
+#include <mingw.mutex.h>
+#include <mingw.thread.h>
+#else // CASADI_WITH_THREAD_MINGW
+#include <mutex>
+#include <thread>
+#endif // CASADI_WITH_THREAD_MINGW
+#endif // CASADI_WITH_THREAD
+
+/// \cond INTERNAL
+namespace casadi {
+
+  /** \brief Append-only binary dump of Function inputs and outputs
+
+      Used for the option dump_format='bin'. All evaluations of a Function go to
+      a single file <dump_dir>/<name>.casadi_dump, laid out as (native byte order)
+
+        header: char[12] "CASADI_DUMP", uint32 version
+        layout: uint32 size (bytes following this field), uint32 kind (2),
+                int64 n_in, int64 n_out,
+                n_in+n_out times: int64 len, int64[len] compressed sparsity
+        record: uint32 size, uint32 kind (0: in, 1: out), int64 id, int64 n,
+                n times: int64 nnz (-1 for null), double[nnz]
+
+      A layout precedes the records of every writer appending to the file.
+      Functions dumping to the same file share one writer, provided their
+      inputs and outputs have the same sparsity.
+
+      Evaluating threads copy records into a bounded lock-free queue of
+      preallocated slots, which a background thread drains to disk. When the
+      queue is full, the record is dropped and counted instead of blocking.
+      Without thread support, records are written synchronously.
+  */
+  class CASADI_EXPORT DumpWriter {
+  public:
+    /** \brief Writer appending to a dump file, shared with other Functions using it
+
+        \param capacity Number of records that can be queued, for a new writer
+        \param sp Sparsity of the inputs and outputs
+    */
+    static std::shared_ptr<DumpWriter> open(const std::string& fname, casadi_int capacity,
+      const std::vector<Sparsity> (&sp)[2]);
+
+    /// Flush all queued records and close the file
+    ~DumpWriter();
+
+    /** \brief Queue a record, returns false if it was dropped
+
+        \param out Outputs rather than inputs
+    */
+    bool push(bool out, casadi_int id, const double* const* v);
+
+    /// Wait until all records queued so far are written and flush the file
+    void flush();
+
+    /// Number of records written or queued for writing
+    casadi_int n_written() const { return n_push_ - n_dropped_;}
+
+    /// Number of records dropped since the queue was full
+    casadi_int n_dropped() const { return n_dropped_;}
+
+    /** \brief Read all records of a kind, as concatenated nonzeros
+
+        Null entries are read as zeros (inputs) or NaN (outputs).
+        The recorded sparsity is checked against the expected one.
+        Records still queued by a writer of the file are flushed first.
+    */
+    static std::vector<std::vector<double>> read(const std::string& fname, bool out,
+      const std::vector<Sparsity>& sp);
+
+  private:
+    DumpWriter(const std::string& fname, casadi_int capacity,
+      const std::vector<Sparsity> (&sp)[2]);
+
+    // Serialize a record into a slot, returns the number of bytes
+    size_t serialize(char* slot, bool out, casadi_int id, const double* const* v) const;
+
+    std::unique_ptr<std::ostream> stream_;
+    std::vector<Sparsity> sp_[2];
+    std::vector<casadi_int> nnz_[2];
+    size_t slot_size_;
+    std::atomic<casadi_int> n_push_, n_dropped_;
+
+    // Preallocated slots and their lengths
+    std::vector<char> data_;
+    std::vector<size_t> len_;
+
+#ifdef CASADI_WITH_THREAD
+    // Bounded multi-producer queue, each slot carries a sequence number
+    std::unique_ptr<std::atomic<size_t>[]> seq_;
+    size_t mask_;
+    std::atomic<size_t> enqueue_pos_;
+    size_t dequeue_pos_;
+    // Queue position up to which the file has been flushed
+    std::atomic<size_t> flush_pos_;
+    std::atomic<bool> stop_;
+    std::thread thread_;
+
+    // Drain the queue until stopped
+    void run();
+#endif // CASADI_WITH_THREAD
+  };
+
+} // namespace casadi
+/// \endcond
+
+#endif // CASADI_DUMP_WRITER_HPP
@@ -29,10 +29,252 @@
 #include "einstein.hpp"
 #include "casadi_misc.hpp"
 #include "function_internal.hpp"
+#include "blas_impl.hpp"
 #include "runtime/shared.hpp"
 
 namespace casadi {
 
+  // Dimension and memory stride of each label of a dense tensor,
+  // false if the tensor has fixed indices or repeated labels
+  static bool einstein_labels(const std::vector<casadi_int>& dim,
+      const std::vector<casadi_int>& lab,
+      std::map<casadi_int, std::pair<casadi_int, casadi_int> >& ret) {
+    casadi_int cumprod = 1;
+    for (casadi_int i=0; i<lab.size(); ++i) {
+      if (lab[i]>=0) return false;
+      if (!ret.insert({lab[i], {dim[i], cumprod}}).second) return false;
+      cumprod *= dim[i];
+    }
+    return true;
+  }
+
+  // Gather indices that bring a tensor in the layout given by a label order,
+  // empty if the layout already matches
+  static std::vector<casadi_int> einstein_gather(
+      const std::map<casadi_int, std::pair<casadi_int, casadi_int> >& t,
+      const std::vector<casadi_int>& order) {
+    // Dimensions and strides in target order
+    std::vector<casadi_int> dim, stride;
+    bool identity = true;
+    casadi_int n = 1;
+    for (casadi_int l : order) {
+      const auto& e = t.at(l);
+      dim.push_back(e.first);
+      stride.push_back(e.second);
+      if (e.second!=n) identity = false;
+      n *= e.first;
+    }
+    if (identity) return {};
+    // Loop over target index space
+    std::vector<casadi_int> ret(n), ind(dim.size(), 0);
+    casadi_int offset = 0;
+    for (casadi_int i=0; i<n; ++i) {
+      ret[i] = offset;
+      // Increment multi-index
+      for (casadi_int j=0; j<dim.size(); ++j) {
+        offset += stride[j];
+        if (++ind[j]<dim[j]) break;
+        offset -= stride[j]*dim[j];
+        ind[j] = 0;
+      }
+    }
+    return ret;
+  }
+
+  void Einstein::init_gemm() {
+    gemm_ = false;
+    gemm_swap_ = gemm_trans_l_ = gemm_trans_r_ = false;
+    gemm_m_ = gemm_n_ = gemm_k_ = gemm_batch_ = 0;
+    gemm_perm_a_.clear();
+    gemm_perm_b_.clear();
+    gemm_perm_c_.clear();
+
+    // Labels must be free and unique within each tensor
+    std::map<casadi_int, std::pair<casadi_int, casadi_int> > ta, tb, tc;
+    if (!einstein_labels(dim_a_, a_, ta)) return;
+    if (!einstein_labels(dim_b_, b_, tb)) return;
+    if (!einstein_labels(dim_c_, c_, tc)) return;
+
+    // Classify labels, in order of appearance in C
+    std::vector<casadi_int> ac, bc, batch, ab_a, ab_b;
+    for (casadi_int l : c_) {
+      bool in_a = ta.count(l), in_b = tb.count(l);
+      if (in_a && in_b) {
+        batch.push_back(l);
+      } else if (in_a) {
+        ac.push_back(l);
+      } else if (in_b) {
+        bc.push_back(l);
+      } else {
+        return;  // broadcast
+      }
+    }
+    // Contracted labels, in order of appearance in A and B respectively
+    for (casadi_int l : a_) {
+      if (tc.count(l)) continue;
+      if (!tb.count(l)) return;  // summation over A only
+      ab_a.push_back(l);
+    }
+    for (casadi_int l : b_) {
+      if (tc.count(l)) continue;
+      if (!ta.count(l)) return;  // summation over B only
+      ab_b.push_back(l);
+    }
+
+    // Product of dimensions
+    auto numel = [&](const std::vector<casadi_int>& v) {
+      casadi_int r = 1;
+      for (casadi_int l : v) r *= tc.count(l) ? tc.at(l).first : ta.count(l) ?
+        ta.at(l).first : tb.at(l).first;
+      return r;
+    };
+    casadi_int n_ac = numel(ac), n_bc = numel(bc), n_ab = numel(ab_a), n_batch = numel(batch);
+    if (n_ac==0 || n_bc==0 || n_ab==0 || n_batch==0) return;
+
+    // Choose operand order and transposes such that the fewest entries are gathered
+    casadi_int best = -1;
+    for (bool swap : {false, true}) {
+      const auto& tl = swap ? tb : ta;
+      const auto& tr = swap ? ta : tb;
+      const auto& m = swap ? bc : ac;
+      const auto& n = swap ? ac : bc;
+      const auto& k = swap ? ab_b : ab_a;
+      std::vector<casadi_int> perm_l, perm_r, perm_c;
+      bool trans_l = false, trans_r = false;
+      // Left operand: [m, k] or [k, m]
+      perm_l = einstein_gather(tl, join(join(m, k), batch));
+      if (!perm_l.empty()) {
+        if (einstein_gather(tl, join(join(k, m), batch)).empty()) {
+          perm_l.clear();
+          trans_l = true;
+        }
+      }
+      // Right operand: [k, n] or [n, k]
+      perm_r = einstein_gather(tr, join(join(k, n), batch));
+      if (!perm_r.empty()) {
+        if (einstein_gather(tr, join(join(n, k), batch)).empty()) {
+          perm_r.clear();
+          trans_r = true;
+        }
+      }
+      // Result: [m, n]
+      perm_c = einstein_gather(tc, join(join(m, n), batch));
+      casadi_int cost = perm_l.size() + perm_r.size() + perm_c.size();
+      if (best>=0 && cost>=best) continue;
+      best = cost;
+      gemm_swap_ = swap;
+      gemm_trans_l_ = trans_l;
+      gemm_trans_r_ = trans_r;
+      gemm_m_ = swap ? n_bc : n_ac;
+      gemm_n_ = swap ? n_ac : n_bc;
+      gemm_perm_a_ = swap ? perm_r : perm_l;
+      gemm_perm_b_ = swap ? perm_l : perm_r;
+      gemm_perm_c_ = perm_c;
+    }
+    gemm_k_ = n_ab;
+    gemm_batch_ = n_batch;
+    gemm_ = true;
+  }
+
+  bool Einstein::reassociate(const MX& C, const MX& A, const MX& B,
+      const std::vector<casadi_int>& dim_c, const std::vector<casadi_int>& dim_a,
+      const std::vector<casadi_int>& dim_b,
+      const std::vector<casadi_int>& c, const std::vector<casadi_int>& a,
+      const std::vector<casadi_int>& b, MX& ret) {
+    // Is one of the factors itself a pure contraction?
+    bool left;
+    if (A.op()==OP_EINSTEIN && A->dep(0).is_zero()) {
+      left = true;
+    } else if (B.op()==OP_EINSTEIN && B->dep(0).is_zero()) {
+      left = false;
+    } else {
+      return false;
+    }
+    const Einstein* e = static_cast<const Einstein*>((left ? A : B).get());
+    const std::vector<casadi_int>& x = left ? a : b;
+    const MX& O = left ? B : A;
+    const std::vector<casadi_int>& o = left ? b : a;
+    const std::vector<casadi_int>& dim_o = left ? dim_b : dim_a;
+
+    // Only free labels, unique in the intermediate result
+    std::map<casadi_int, std::pair<casadi_int, casadi_int> > t;
+    if (!einstein_labels(left ? dim_a : dim_b, x, t)) return false;
+    std::map<casadi_int, std::pair<casadi_int, casadi_int> > t_inner;
+    if (!einstein_labels(e->dim_c_, e->c_, t_inner)) return false;
+    for (const auto* v : {&e->a_, &e->b_, &o, &c}) {
+      for (casadi_int l : *v) if (l>=0) return false;
+    }
+
+    // Translate inner labels to outer labels, contracted ones get fresh labels
+    casadi_int fresh = -1;
+    for (const auto* v : {&a, &b, &c}) {
+      for (casadi_int l : *v) fresh = std::min(fresh, l-1);
+    }
+    std::map<casadi_int, casadi_int> outer;
+    for (casadi_int i=0; i<x.size(); ++i) outer[e->c_[i]] = x[i];
+    auto translate = [&](const std::vector<casadi_int>& v) {
+      std::vector<casadi_int> r;
+      for (casadi_int l : v) {
+        auto it = outer.find(l);
+        if (it==outer.end()) it = outer.insert({l, fresh--}).first;
+        r.push_back(it->second);
+      }
+      return r;
+    };
+    std::vector<casadi_int> p = translate(e->a_), q = translate(e->b_);
+
+    // Dimension of every label
+    std::map<casadi_int, casadi_int> dim;
+    for (casadi_int i=0; i<p.size(); ++i) dim[p[i]] = e->dim_a_[i];
+    for (casadi_int i=0; i<q.size(); ++i) dim[q[i]] = e->dim_b_[i];
+    for (casadi_int i=0; i<o.size(); ++i) dim[o[i]] = dim_o[i];
+    for (casadi_int i=0; i<c.size(); ++i) dim[c[i]] = dim_c[i];
+
+    // Labels of the result of contracting u and v, needed by w or the output
+    auto keep = [&](const std::vector<casadi_int>& u, const std::vector<casadi_int>& v,
+        const std::vector<casadi_int>& w) {
+      std::vector<casadi_int> r;
+      for (const auto* s : {&u, &v}) {
+        for (casadi_int l : *s) {
+          if (std::find(r.begin(), r.end(), l)!=r.end()) continue;
+          if (std::find(w.begin(), w.end(), l)!=w.end() ||
+              std::find(c.begin(), c.end(), l)!=c.end()) r.push_back(l);
+        }
+      }
+      return r;
+    };
+    // Number of multiply-adds of a pairwise contraction
+    auto cost = [&](const std::vector<casadi_int>& u, const std::vector<casadi_int>& v) {
+      std::set<casadi_int> all(u.begin(), u.end());
+      all.insert(v.begin(), v.end());
+      double r = 1;
+      for (casadi_int l : all) r *= static_cast<double>(dim.at(l));
+      return r;
+    };
+
+    // Current order (P Q) O against P (Q O) and Q (P O)
+    double cost_pq = cost(p, q) + cost(x, o);
+    std::vector<casadi_int> y_qo = keep(q, o, p), y_po = keep(p, o, q);
+    double cost_qo = cost(q, o) + cost(p, y_qo);
+    double cost_po = cost(p, o) + cost(q, y_po);
+    if (cost_pq<=cost_qo && cost_pq<=cost_po) return false;
+
+    // Contract the cheaper pair first
+    bool qo = cost_qo<=cost_po;
+    const MX& first = qo ? e->dep(2) : e->dep(1);
+    const MX& second = qo ? e->dep(1) : e->dep(2);
+    const std::vector<casadi_int>& l_first = qo ? q : p;
+    const std::vector<casadi_int>& l_second = qo ? p : q;
+    const std::vector<casadi_int>& d_first = qo ? e->dim_b_ : e->dim_a_;
+    const std::vector<casadi_int>& d_second = qo ? e->dim_a_ : e->dim_b_;
+    const std::vector<casadi_int>& y = qo ? y_qo : y_po;
+    std::vector<casadi_int> dim_y;
+    for (casadi_int l : y) dim_y.push_back(dim.at(l));
+    MX Y = MX::einstein(first, O, d_first, dim_o, dim_y, l_first, o, y);
+    ret = MX::einstein(second, Y, C, d_second, dim_y, dim_c, l_second, y, c);
+    return true;
+  }
+
   Einstein::Einstein(const MX& C, const MX& A, const MX& B,
     const std::vector<casadi_int>& dim_c, const std::vector<casadi_int>& dim_a,
     const std::vector<casadi_int>& dim_b,
@@ -46,6 +288,8 @@ namespace casadi {
     n_iter_ = einstein_process(A, B, C, dim_a, dim_b, dim_c, a, b, c,
       iter_dims_, strides_a_, strides_b_, strides_c_);
 
+    blas_shorthand_ = Blas::default_;
+    init_gemm();
   }
 
   std::string Einstein::disp(const std::vector<std::string>& arg) const {
@@ -53,9 +297,54 @@ namespace casadi {
   }
 
   int Einstein::eval(const double** arg, double** res, casadi_int* iw, double* w) const {
+    if (gemm_) {
+      if (arg[0]!=res[0]) std::copy(arg[0], arg[0]+dep(0).nnz(), res[0]);
+      eval_gemm(arg, res, w);
+      return 0;
+    }
     return eval_gen<double>(arg, res, iw, w);
   }
 
+  void Einstein::eval_gemm(const double** arg, double** res, double* w) const {
+    // Bring operands in matrix layout
+    const double* a = arg[1];
+    if (!gemm_perm_a_.empty()) {
+      for (casadi_int i=0; i<gemm_perm_a_.size(); ++i) w[i] = a[gemm_perm_a_[i]];
+      a = w;
+      w += gemm_perm_a_.size();
+    }
+    const double* b = arg[2];
+    if (!gemm_perm_b_.empty()) {
+      for (casadi_int i=0; i<gemm_perm_b_.size(); ++i) w[i] = b[gemm_perm_b_[i]];
+      b = w;
+      w += gemm_perm_b_.size();
+    }
+    double* c = res[0];
+    if (!gemm_perm_c_.empty()) {
+      c = w;
+      casadi_clear(c, gemm_perm_c_.size());
+    }
+
+    // Batch of products
+    const double* l = gemm_swap_ ? b : a;
+    const double* r = gemm_swap_ ? a : b;
+    casadi_int sz_l = gemm_m_*gemm_k_, sz_r = gemm_k_*gemm_n_, sz_c = gemm_m_*gemm_n_;
+    for (casadi_int i=0; i<gemm_batch_; ++i) {
+      Blas::dgemm(blas_shorthand_,
+        gemm_trans_l_ ? CASADI_BLAS_TRANS : CASADI_BLAS_NO_TRANS,
+        gemm_trans_r_ ? CASADI_BLAS_TRANS : CASADI_BLAS_NO_TRANS,
+        gemm_m_, gemm_n_, gemm_k_, 1.,
+        l + i*sz_l, gemm_trans_l_ ? gemm_k_ : gemm_m_,
+        r + i*sz_r, gemm_trans_r_ ? gemm_n_ : gemm_k_,
+        1., c + i*sz_c, gemm_m_);
+    }
+
+    // Scatter result
+    if (!gemm_perm_c_.empty()) {
+      for (casadi_int i=0; i<gemm_perm_c_.size(); ++i) res[0][gemm_perm_c_[i]] += c[i];
+    }
+  }
+
   int Einstein::eval_sx(const SXElem** arg, SXElem** res, casadi_int* iw, SXElem* w) const {
     return eval_gen<SXElem>(arg, res, iw, w);
   }
@@ -138,6 +427,23 @@ namespace casadi {
       g << g.copy(g.work(arg[0], nnz(), arg_is_ref[0]), nnz(), g.work(res[0], nnz(), false));
     }
 
+    // Plain (batched) matrix product
+    if (gemm_ && !gemm_trans_l_ && !gemm_trans_r_ && gemm_perm_a_.empty()
+        && gemm_perm_b_.empty() && gemm_perm_c_.empty()) {
+      std::string a = g.work(arg[gemm_swap_ ? 2 : 1], dep(gemm_swap_ ? 2 : 1).nnz(),
+        arg_is_ref[gemm_swap_ ? 2 : 1]);
+      std::string b = g.work(arg[gemm_swap_ ? 1 : 2], dep(gemm_swap_ ? 1 : 2).nnz(),
+        arg_is_ref[gemm_swap_ ? 1 : 2]);
+      std::string c = g.work(res[0], nnz(), false);
+      for (casadi_int i=0; i<gemm_batch_; ++i) {
+        Blas::codegen_mtimes(g, blas_shorthand_,
+          a + "+" + str(i*gemm_m_*gemm_k_), gemm_m_, gemm_k_,
+          b + "+" + str(i*gemm_k_*gemm_n_), gemm_n_,
+          c + "+" + str(i*gemm_m_*gemm_n_));
+      }
+      return;
+    }
+
     // main loop
     g.local("i", "casadi_int");
     g << "for (i=0; i<" << n_iter_ << "; ++i) {\n";
@@ -170,6 +476,11 @@ namespace casadi {
     g << "}\n";
   }
 
+  void Einstein::serialize_type(SerializingStream& s) const {
+    MXNode::serialize_type(s);
+    s.version("Einstein", 2);
+  }
+
   void Einstein::serialize_body(SerializingStream& s) const {
     MXNode::serialize_body(s);
     s.pack("Einstein::dim_c", dim_c_);
@@ -183,9 +494,48 @@ namespace casadi {
     s.pack("Einstein::strides_b", strides_b_);
     s.pack("Einstein::strides_c", strides_c_);
     s.pack("Einstein::n_iter", n_iter_);
+    s.pack("Einstein::blas", std::string(Blas::name_for_shorthand(blas_shorthand_)));
+  }
+
+  MXNode* Einstein::deserialize(DeserializingStream& s) {
+    // Wire-format detection, like Multiplication::deserialize.
+    //   version 1: no type information, the body follows directly. Its first
+    //     field holds the three dependencies: a casadi_int 3 ('d' first in
+    //     non-debug mode), or the descriptor "MXNode::deps" in debug mode.
+    //   version 2: "Einstein::serialization::version", then the body, which
+    //     ends with "Einstein::blas". The int 2 starts with 'c'.
+    if (s.debug()) {
+      std::string descr;
+      s.unpack(descr);
+      if (descr=="MXNode::deps") {
+        std::vector<MX> deps;
+        s.unpack(deps);
+        return new Einstein(s, deps);
+      }
+      casadi_assert(descr=="Einstein::serialization::version",
+        "Unexpected Einstein descriptor: '" + descr + "'.");
+      int v;
+      s.unpack(v);
+      casadi_assert(v==2, "DeSerialization of Einstein failed. "
+        "Object written in version " + str(v) + " but can only read version 1...2.");
+      return new Einstein(s);
+    }
+    if (s.peek_byte()=='d') return new Einstein(s, true);
+    s.version("Einstein", 2);
+    return new Einstein(s);
+  }
+
+  Einstein::Einstein(DeserializingStream& s, bool legacy) : MXNode(s) {
+    deserialize_body(s, legacy);
   }
 
-  Einstein::Einstein(DeserializingStream& s) : MXNode(s) {
+  Einstein::Einstein(DeserializingStream& s, const std::vector<MX>& deps) {
+    dep_ = deps;
+    s.unpack("MXNode::sp", sparsity_);
+    deserialize_body(s, true);
+  }
+
+  void Einstein::deserialize_body(DeserializingStream& s, bool legacy) {
     s.unpack("Einstein::dim_c", dim_c_);
     s.unpack("Einstein::dim_a", dim_a_);
     s.unpack("Einstein::dim_b", dim_b_);
@@ -197,6 +547,14 @@ namespace casadi {
     s.unpack("Einstein::strides_b", strides_b_);
     s.unpack("Einstein::strides_c", strides_c_);
     s.unpack("Einstein::n_iter", n_iter_);
+    if (legacy) {
+      blas_shorthand_ = 0;
+    } else {
+      std::string blas;
+      s.unpack("Einstein::blas", blas);
+      blas_shorthand_ = Blas::shorthand_for(blas);
+    }
+    init_gemm();
   }
 
 } // namespace casadi
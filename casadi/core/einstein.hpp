@@ -75,6 +75,9 @@ namespace casadi {
     /// Evaluate the function numerically
     int eval(const double** arg, double** res, casadi_int* iw, double* w) const override;
 
+    /// Evaluate as a sequence of (batched) matrix-matrix products
+    void eval_gemm(const double** arg, double** res, double* w) const;
+
     /// Evaluate the function symbolically (SX)
     int eval_sx(const SXElem** arg, SXElem** res, casadi_int* iw, SXElem* w) const override;
 
@@ -126,23 +129,44 @@ namespace casadi {
         \identifier{2g6} */
     void serialize_body(SerializingStream& s) const override;
 
+    /** \brief Serialize type information
+
+        Packs a version: streams written before the BLAS plugin was serialized
+        have none, and their Einstein nodes are read with the reference BLAS.
+    */
+    void serialize_type(SerializingStream& s) const override;
+
     /** \brief Deserialize without type information
 
         \identifier{2g7} */
-    static MXNode* deserialize(DeserializingStream& s) { return new Einstein(s); }
+    static MXNode* deserialize(DeserializingStream& s);
 
   protected:
     /** \brief Deserializing constructor
 
         \identifier{2g8} */
-    explicit Einstein(DeserializingStream& s);
+    explicit Einstein(DeserializingStream& s, bool legacy = false);
+
+    /** \brief Deserializing constructor, legacy debug-mode streams
+
+        The descriptor of the dependencies has already been read.
+    */
+    Einstein(DeserializingStream& s, const std::vector<MX>& deps);
+
+    /// Unpack the Einstein fields, after the MXNode ones
+    void deserialize_body(DeserializingStream& s, bool legacy);
 
   public:
 
     /** \brief Get required length of w field
 
         \identifier{3b} */
-    size_t sz_w() const override { return sparsity().size1();}
+    size_t sz_w() const override {
+      return sparsity().size1() + gemm_perm_a_.size() + gemm_perm_b_.size() + gemm_perm_c_.size();
+    }
+
+    /** \brief Get required length of w field for generated code */
+    size_t codegen_sz_w() const override { return sparsity().size1();}
 
     /** Obtain information about node */
     Dict info() const override {
@@ -166,6 +190,39 @@ namespace casadi {
 
     casadi_int n_iter_;
 
+    /** \brief Contract chained Einstein products in the cheapest pairwise order
+
+        If A or B is itself a pure contraction of two tensors, compare the cost
+        of the three possible pairwise orders. Returns false if the given order
+        is already optimal.
+    */
+    static bool reassociate(const MX& C, const MX& A, const MX& B,
+      const std::vector<casadi_int>& dim_c, const std::vector<casadi_int>& dim_a,
+      const std::vector<casadi_int>& dim_b,
+      const std::vector<casadi_int>& c, const std::vector<casadi_int>& a,
+      const std::vector<casadi_int>& b, MX& ret);
+
+    /** \brief Detect a contraction that is a batch of matrix-matrix products
+
+        Classifies each label as batch (A, B and C), row (A and C), column (B and C)
+        or inner (A and B). Operands whose memory layout does not match are
+        gathered into a matching layout, transposed operands are handled by dgemm.
+    */
+    void init_gemm();
+
+    /// Lowered to batched GEMM?
+    bool gemm_;
+    /// Operands A and B swap roles, i.e. C^T = B^T A^T
+    bool gemm_swap_;
+    /// Transpose flags for the left and right operands
+    bool gemm_trans_l_, gemm_trans_r_;
+    /// Matrix dimensions and number of products
+    casadi_int gemm_m_, gemm_n_, gemm_k_, gemm_batch_;
+    /// Gather indices into canonical layout, empty if layout already matches
+    std::vector<casadi_int> gemm_perm_a_, gemm_perm_b_, gemm_perm_c_;
+    /// BLAS plugin shorthand, chosen at construction and serialized by name
+    casadi_int blas_shorthand_;
+
   };
 
 
@@ -474,7 +474,10 @@ namespace casadi {
           // Calculate extended Hessian
           MatType H;
           if (symmetric) {
-            H = hessian(out_.at(f), vertcat(x1));
+            Dict h_opts;
+            auto it = opts.find("edge_pushing");
+            if (it!=opts.end()) h_opts[it->first] = it->second;
+            H = hessian(out_.at(f), vertcat(x1), h_opts);
           } else {
             H = jacobian(gradient(out_.at(f), vertcat(x1)), vertcat(x2));
           }
@@ -556,30 +559,34 @@ namespace casadi {
 
   template<typename MatType>
   void Factory<MatType>::calculate(const Dict& opts) {
+    // Options for the first order derivatives: edge_pushing only applies to Hessians
+    Dict d_opts = opts;
+    d_opts.erase("edge_pushing");
+
     // Forward mode directional derivatives
     try {
-      calculate_fwd(opts);
+      calculate_fwd(d_opts);
     } catch (std::exception& e) {
       casadi_error("Forward mode AD failed:\n" + str(e.what()));
     }
 
     // Reverse mode directional derivatives
     try {
-      calculate_adj(opts);
+      calculate_adj(d_opts);
     } catch (std::exception& e) {
       casadi_error("Reverse mode AD failed:\n" + str(e.what()));
     }
 
     // Jacobian blocks
     try {
-      calculate_jac(opts);
+      calculate_jac(d_opts);
     } catch (std::exception& e) {
       casadi_error("Jacobian generation failed:\n" + str(e.what()));
     }
 
     // Gradient blocks
     try {
-      calculate_grad(opts);
+      calculate_grad(d_opts);
     } catch (std::exception& e) {
       casadi_error("Gradient generation failed:\n" + str(e.what()));
     }
@@ -284,6 +284,14 @@ void Fmu::free_instance(void* instance) const {
   }
 }
 
+void Fmu::release_instance(void* instance) const {
+  try {
+    (*this)->release_instance(instance);
+  } catch(std::exception& e) {
+    THROW_ERROR("release_instance", e.what());
+  }
+}
+
 void Fmu::set(FmuMemory* m, size_t ind, const double* value) const {
   try {
     (*this)->set(m, ind, value);
@@ -434,6 +442,7 @@ void Fmu::get_stats(FmuMemory* m, Dict* stats,
     const std::vector<std::string>& name_in, const InputStruct* in) const {
   try {
     (*this)->get_stats(m, stats, name_in, in);
+    (*this)->get_pool_stats(stats);
   } catch(std::exception& e) {
     THROW_ERROR("get_stats", e.what());
   }
@@ -461,6 +470,7 @@ void FmuInternal::init(const DaeBuilderInternal* dae) {
   provides_directional_derivatives_ = dae->provides_directional_derivatives_;
   provides_adjoint_derivatives_ = dae->provides_adjoint_derivatives_;
   can_be_instantiated_only_once_per_process_ = dae->can_be_instantiated_only_once_per_process_;
+  can_get_and_set_fmu_state_ = dae->can_get_and_set_fmu_state_;
   start_time_ = dae->start_time_;
   nx_ = dae->size(Category::X);
   do_evaluation_dance_ = dae->generation_tool_.rfind("Simulink", 0) == 0;
@@ -644,8 +654,18 @@ void FmuInternal::finalize() {
   if (get_aux(c)) {
     casadi_error("FmuInternal::get_aux failed");
   }
-  // Free memory
-  free_instance(c);
+  // Finish initialization and keep the instance for the first memory object
+  if (exit_initialization_mode(c) || discrete_states_iter(c)
+      || enter_continuous_time_mode(c)) {
+    free_instance(c);
+    return;
+  }
+  void* state = can_get_and_set_fmu_state_ ? get_fmu_state(c) : nullptr;
+#ifdef CASADI_WITH_THREAD
+  std::lock_guard<std::mutex> lock(instance_pool_mtx_);
+#endif //CASADI_WITH_THREAD
+  instance_snapshot_[c] = state;
+  instance_pool_.push_back(c);
 }
 
 void FmuInternal::disp(std::ostream& stream, bool more) const {
@@ -1244,24 +1264,104 @@ int FmuInternal::discrete_states_iter(void* instance) const {
   return 1;
 }
 
-int FmuInternal::init_mem(FmuMemory* m) const {
-  // Ensure not already instantiated
-  casadi_assert(m->instance == nullptr, "Already instantiated");
-  // Create instance
-  m->instance = instantiate();
+int FmuInternal::initialize_instance(void* instance) const {
   // Set all values
-  if (set_values(m->instance)) {
+  if (set_values(instance)) {
     casadi_warning("FmuInternal::set_values failed");
     return 1;
   }
   // Initialization mode begins
-  if (enter_initialization_mode(m->instance)) return 1;
+  if (enter_initialization_mode(instance)) return 1;
   // Initialization mode ends
-  if (exit_initialization_mode(m->instance)) return 1;
+  if (exit_initialization_mode(instance)) return 1;
   // Initial event iteration
-  if (discrete_states_iter(m->instance)) return 1;
+  if (discrete_states_iter(instance)) return 1;
   // Continuous-time mode
-  if (enter_continuous_time_mode(m->instance)) return 1;
+  if (enter_continuous_time_mode(instance)) return 1;
+  return 0;
+}
+
+void* FmuInternal::checkout_instance() const {
+  // Try to reuse an instance from the pool
+  void *instance = nullptr, *state = nullptr;
+  {
+#ifdef CASADI_WITH_THREAD
+    std::lock_guard<std::mutex> lock(instance_pool_mtx_);
+#endif //CASADI_WITH_THREAD
+    if (!instance_pool_.empty()) {
+      instance = instance_pool_.back();
+      instance_pool_.pop_back();
+      state = instance_snapshot_[instance];
+    }
+  }
+  if (instance != nullptr) {
+    // Restore the initialized state, much cheaper than reinitializing
+    if (state != nullptr && set_fmu_state(instance, state) == 0) return instance;
+    // Reinitialize from scratch
+    if (reset(instance) == 0 && initialize_instance(instance) == 0) return instance;
+    // Instance no longer usable
+    {
+#ifdef CASADI_WITH_THREAD
+      std::lock_guard<std::mutex> lock(instance_pool_mtx_);
+#endif //CASADI_WITH_THREAD
+      instance_snapshot_.erase(instance);
+    }
+    if (state != nullptr) free_fmu_state(instance, state);
+    free_instance(instance);
+  }
+  // Create and initialize a new instance
+  instance = instantiate();
+  if (initialize_instance(instance)) {
+    free_instance(instance);
+    return nullptr;
+  }
+  // Snapshot of the initialized state, if supported
+  state = can_get_and_set_fmu_state_ ? get_fmu_state(instance) : nullptr;
+#ifdef CASADI_WITH_THREAD
+  std::lock_guard<std::mutex> lock(instance_pool_mtx_);
+#endif //CASADI_WITH_THREAD
+  instance_snapshot_[instance] = state;
+  return instance;
+}
+
+void FmuInternal::release_instance(void* instance) const {
+#ifdef CASADI_WITH_THREAD
+  std::lock_guard<std::mutex> lock(instance_pool_mtx_);
+#endif //CASADI_WITH_THREAD
+  casadi_assert(instance_snapshot_.count(instance), "Instance not created by checkout_instance");
+  instance_pool_.push_back(instance);
+}
+
+void FmuInternal::get_pool_stats(Dict* stats) const {
+#ifdef CASADI_WITH_THREAD
+  std::lock_guard<std::mutex> lock(instance_pool_mtx_);
+#endif //CASADI_WITH_THREAD
+  // Every live instance has an entry in instance_snapshot_, possibly without a snapshot
+  (*stats)["fmu_instances"] = static_cast<casadi_int>(instance_snapshot_.size());
+  (*stats)["fmu_instances_pooled"] = static_cast<casadi_int>(instance_pool_.size());
+}
+
+void FmuInternal::clear_instance_pool() const {
+#ifdef CASADI_WITH_THREAD
+  std::lock_guard<std::mutex> lock(instance_pool_mtx_);
+#endif //CASADI_WITH_THREAD
+  for (void* instance : instance_pool_) {
+    auto it = instance_snapshot_.find(instance);
+    if (it != instance_snapshot_.end()) {
+      if (it->second != nullptr) free_fmu_state(instance, it->second);
+      instance_snapshot_.erase(it);
+    }
+    free_instance(instance);
+  }
+  instance_pool_.clear();
+}
+
+int FmuInternal::init_mem(FmuMemory* m) const {
+  // Ensure not already instantiated
+  casadi_assert(m->instance == nullptr, "Already instantiated");
+  // Get an initialized instance
+  m->instance = checkout_instance();
+  if (m->instance == nullptr) return 1;
   // Allocate/reset input buffer
   m->ibuf_.resize(iind_.size());
   std::fill(m->ibuf_.begin(), m->ibuf_.end(), casadi::nan);
@@ -1505,7 +1605,7 @@ void FmuInternal::serialize_type(SerializingStream& s) const {
 }
 
 void FmuInternal::serialize_body(SerializingStream& s) const {
-  s.version("FmuInternal", 4);
+  s.version("FmuInternal", 5);
   s.pack("FmuInternal::name", name_);
   s.pack("FmuInternal::scheme_in", scheme_in_);
   s.pack("FmuInternal::scheme_out", scheme_out_);
@@ -1543,13 +1643,14 @@ void FmuInternal::serialize_body(SerializingStream& s) const {
   s.pack("FmuInternal::provides_adjoint_derivatives", provides_adjoint_derivatives_);
   s.pack("FmuInternal::can_be_instantiated_only_once_per_process",
     can_be_instantiated_only_once_per_process_);
+  s.pack("FmuInternal::can_get_and_set_fmu_state", can_get_and_set_fmu_state_);
   s.pack("FmuInternal::start_time", start_time_);
   s.pack("FmuInternal::nx", nx_);
   s.pack("FmuInternal::do_evaluation_dance", do_evaluation_dance_);
 }
 
 FmuInternal::FmuInternal(DeserializingStream& s) {
-  s.version("FmuInternal", 4);
+  int version = s.version("FmuInternal", 4, 5);
   s.unpack("FmuInternal::name", name_);
   s.unpack("FmuInternal::scheme_in", scheme_in_);
   s.unpack("FmuInternal::scheme_out", scheme_out_);
@@ -1587,6 +1688,11 @@ FmuInternal::FmuInternal(DeserializingStream& s) {
   s.unpack("FmuInternal::provides_adjoint_derivatives", provides_adjoint_derivatives_);
   s.unpack("FmuInternal::can_be_instantiated_only_once_per_process",
     can_be_instantiated_only_once_per_process_);
+  if (version >= 5) {
+    s.unpack("FmuInternal::can_get_and_set_fmu_state", can_get_and_set_fmu_state_);
+  } else {
+    can_get_and_set_fmu_state_ = false;
+  }
   s.unpack("FmuInternal::start_time", start_time_);
   s.unpack("FmuInternal::nx", nx_);
   s.unpack("FmuInternal::do_evaluation_dance", do_evaluation_dance_);
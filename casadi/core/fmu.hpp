@@ -179,6 +179,9 @@ class CASADI_EXPORT Fmu
   // Free FMU instance
   void free_instance(void* instance) const;
 
+  // Return an FMU instance to the instance pool for later reuse
+  void release_instance(void* instance) const;
+
   // Set value
   void set(FmuMemory* m, size_t ind, const double* value) const;
 
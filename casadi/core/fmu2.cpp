@@ -60,6 +60,8 @@ void Fmu2::free_mem(void *mem) const {
 }
 
 Fmu2::~Fmu2() {
+  // Free pooled instances while the derived class is still alive
+  clear_instance_pool();
 }
 
 std::string Fmu2::dll_infix() {
@@ -207,6 +209,11 @@ void Fmu2::load_functions() {
       load_function<fmi2GetDirectionalDerivativeTYPE>("fmi2GetDirectionalDerivative");
   }
   new_discrete_states_ = load_function<fmi2NewDiscreteStatesTYPE>("fmi2NewDiscreteStates");
+  if (can_get_and_set_fmu_state_) {
+    get_fmu_state_ = load_function<fmi2GetFMUstateTYPE>("fmi2GetFMUstate");
+    set_fmu_state_ = load_function<fmi2SetFMUstateTYPE>("fmi2SetFMUstate");
+    free_fmu_state_ = load_function<fmi2FreeFMUstateTYPE>("fmi2FreeFMUstate");
+  }
 
   // Callback functions
   functions_.logger = logger;
@@ -275,16 +282,54 @@ void Fmu2::free_instance(void* instance) const {
   }
 }
 
-int Fmu2::reset(void* instance) {
+int Fmu2::reset(void* instance) const {
   auto *c = static_cast<fmi2Component>(instance);
   fmi2Status status = reset_(c);
   if (status != fmi2OK) {
     casadi_warning("fmi2Reset failed");
     return 1;
   }
+  // fmi2Reset returns to the instantiated state, before fmi2SetupExperiment
+  status = setup_experiment_(c, fmutol_ > 0, fmutol_, 0., fmi2True, 1.);
+  if (status != fmi2OK) {
+    casadi_warning("fmi2SetupExperiment failed");
+    return 1;
+  }
+  return 0;
+}
+
+void* Fmu2::get_fmu_state(void* instance) const {
+  if (get_fmu_state_ == nullptr) return nullptr;
+  auto *c = static_cast<fmi2Component>(instance);
+  fmi2FMUstate state = nullptr;
+  fmi2Status status = get_fmu_state_(c, &state);
+  if (status != fmi2OK) {
+    casadi_warning("fmi2GetFMUstate failed");
+    return nullptr;
+  }
+  return state;
+}
+
+int Fmu2::set_fmu_state(void* instance, void* state) const {
+  if (set_fmu_state_ == nullptr) return 1;
+  auto *c = static_cast<fmi2Component>(instance);
+  fmi2Status status = set_fmu_state_(c, static_cast<fmi2FMUstate>(state));
+  if (status != fmi2OK) {
+    casadi_warning("fmi2SetFMUstate failed");
+    return 1;
+  }
   return 0;
 }
 
+void Fmu2::free_fmu_state(void* instance, void* state) const {
+  if (free_fmu_state_ == nullptr) return;
+  auto *c = static_cast<fmi2Component>(instance);
+  auto s = static_cast<fmi2FMUstate>(state);
+  if (free_fmu_state_(c, &s) != fmi2OK) {
+    casadi_warning("fmi2FreeFMUstate failed");
+  }
+}
+
 int Fmu2::enter_initialization_mode(void* instance) const {
   auto *c = static_cast<fmi2Component>(instance);
   fmi2Status status = enter_initialization_mode_(c);
@@ -538,6 +583,9 @@ Fmu2::Fmu2(const std::string& name,
   instantiate_ = nullptr;
   free_instance_ = nullptr;
   reset_ = nullptr;
+  get_fmu_state_ = nullptr;
+  set_fmu_state_ = nullptr;
+  free_fmu_state_ = nullptr;
   setup_experiment_ = nullptr;
   enter_initialization_mode_ = nullptr;
   exit_initialization_mode_ = nullptr;
@@ -560,6 +608,9 @@ Fmu2::Fmu2(DeserializingStream& s) : FmuInternal(s) {
   instantiate_ = nullptr;
   free_instance_ = nullptr;
   reset_ = nullptr;
+  get_fmu_state_ = nullptr;
+  set_fmu_state_ = nullptr;
+  free_fmu_state_ = nullptr;
   setup_experiment_ = nullptr;
   enter_initialization_mode_ = nullptr;
   exit_initialization_mode_ = nullptr;
@@ -95,6 +95,9 @@ class CASADI_EXPORT Fmu2 : public FmuInternal {
   fmi2InstantiateTYPE* instantiate_;
   fmi2FreeInstanceTYPE* free_instance_;
   fmi2ResetTYPE* reset_;
+  fmi2GetFMUstateTYPE* get_fmu_state_;
+  fmi2SetFMUstateTYPE* set_fmu_state_;
+  fmi2FreeFMUstateTYPE* free_fmu_state_;
   fmi2SetupExperimentTYPE* setup_experiment_;
   fmi2EnterInitializationModeTYPE* enter_initialization_mode_;
   fmi2ExitInitializationModeTYPE* exit_initialization_mode_;
@@ -136,7 +139,7 @@ class CASADI_EXPORT Fmu2 : public FmuInternal {
   void free_instance(void* instance) const override;
 
   // Reset solver
-  int reset(void* instance);
+  int reset(void* instance) const override;
 
   // Enter initialization mode
   int enter_initialization_mode(void* instance) const override;
@@ -174,6 +177,15 @@ class CASADI_EXPORT Fmu2 : public FmuInternal {
   // Retrieve auxilliary variables from FMU
   int get_aux(void* instance) override;
 
+  // Take a snapshot of the FMU state
+  void* get_fmu_state(void* instance) const override;
+
+  // Restore an FMU state snapshot
+  int set_fmu_state(void* instance, void* state) const override;
+
+  // Free an FMU state snapshot
+  void free_fmu_state(void* instance, void* state) const override;
+
   // Retrieve auxilliary variables from FMU, implementation
   int get_aux_impl(void* instance, Value& aux_value) const;
 
@@ -56,6 +56,8 @@ void Fmu3::free_mem(void *mem) const {
 }
 
 Fmu3::~Fmu3() {
+  // Free pooled instances while the derived class is still alive
+  clear_instance_pool();
 }
 
 std::string Fmu3::dll_infix() {
@@ -232,6 +234,11 @@ void Fmu3::load_functions() {
   }
   update_discrete_states_ =
     load_function<fmi3UpdateDiscreteStatesTYPE>("fmi3UpdateDiscreteStates");
+  if (can_get_and_set_fmu_state_) {
+    get_fmu_state_ = load_function<fmi3GetFMUStateTYPE>("fmi3GetFMUState");
+    set_fmu_state_ = load_function<fmi3SetFMUStateTYPE>("fmi3SetFMUState");
+    free_fmu_state_ = load_function<fmi3FreeFMUStateTYPE>("fmi3FreeFMUState");
+  }
 }
 
 void Fmu3::log_message_callback(fmi3InstanceEnvironment instanceEnvironment,
@@ -262,7 +269,7 @@ void Fmu3::free_instance(void* instance) const {
   }
 }
 
-int Fmu3::reset(void* instance) {
+int Fmu3::reset(void* instance) const {
   auto *c = static_cast<fmi3Instance>(instance);
   fmi3Status status = reset_(c);
   if (status != fmi3OK) {
@@ -272,6 +279,38 @@ int Fmu3::reset(void* instance) {
   return 0;
 }
 
+void* Fmu3::get_fmu_state(void* instance) const {
+  if (get_fmu_state_ == nullptr) return nullptr;
+  auto *c = static_cast<fmi3Instance>(instance);
+  fmi3FMUState state = nullptr;
+  fmi3Status status = get_fmu_state_(c, &state);
+  if (status != fmi3OK) {
+    casadi_warning("fmi3GetFMUState failed");
+    return nullptr;
+  }
+  return state;
+}
+
+int Fmu3::set_fmu_state(void* instance, void* state) const {
+  if (set_fmu_state_ == nullptr) return 1;
+  auto *c = static_cast<fmi3Instance>(instance);
+  fmi3Status status = set_fmu_state_(c, static_cast<fmi3FMUState>(state));
+  if (status != fmi3OK) {
+    casadi_warning("fmi3SetFMUState failed");
+    return 1;
+  }
+  return 0;
+}
+
+void Fmu3::free_fmu_state(void* instance, void* state) const {
+  if (free_fmu_state_ == nullptr) return;
+  auto *c = static_cast<fmi3Instance>(instance);
+  auto s = static_cast<fmi3FMUState>(state);
+  if (free_fmu_state_(c, &s) != fmi3OK) {
+    casadi_warning("fmi3FreeFMUState failed");
+  }
+}
+
 int Fmu3::enter_initialization_mode(void* instance) const {
   auto *c = static_cast<fmi3Instance>(instance);
   fmi3Status status = enter_initialization_mode_(c, fmutol_ > 0, fmutol_, 0., fmi3True, 1.);
@@ -517,6 +556,9 @@ Fmu3::Fmu3(const std::string& name,
   instantiate_model_exchange_ = nullptr;
   free_instance_ = nullptr;
   reset_ = nullptr;
+  get_fmu_state_ = nullptr;
+  set_fmu_state_ = nullptr;
+  free_fmu_state_ = nullptr;
   enter_initialization_mode_ = nullptr;
   exit_initialization_mode_ = nullptr;
   enter_continuous_time_mode_ = nullptr;
@@ -540,6 +582,9 @@ Fmu3::Fmu3(DeserializingStream& s) : FmuInternal(s) {
   instantiate_model_exchange_ = nullptr;
   free_instance_ = nullptr;
   reset_ = nullptr;
+  get_fmu_state_ = nullptr;
+  set_fmu_state_ = nullptr;
+  free_fmu_state_ = nullptr;
   enter_initialization_mode_ = nullptr;
   exit_initialization_mode_ = nullptr;
   enter_continuous_time_mode_ = nullptr;
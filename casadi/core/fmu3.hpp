@@ -95,6 +95,9 @@ class CASADI_EXPORT Fmu3 : public FmuInternal {
   fmi3InstantiateModelExchangeTYPE* instantiate_model_exchange_;
   fmi3FreeInstanceTYPE* free_instance_;
   fmi3ResetTYPE* reset_;
+  fmi3GetFMUStateTYPE* get_fmu_state_;
+  fmi3SetFMUStateTYPE* set_fmu_state_;
+  fmi3FreeFMUStateTYPE* free_fmu_state_;
   fmi3EnterInitializationModeTYPE* enter_initialization_mode_;
   fmi3ExitInitializationModeTYPE* exit_initialization_mode_;
   fmi3EnterContinuousTimeModeTYPE* enter_continuous_time_mode_;
@@ -132,7 +135,7 @@ class CASADI_EXPORT Fmu3 : public FmuInternal {
   void free_instance(void* instance) const override;
 
   // Reset solver
-  int reset(void* instance);
+  int reset(void* instance) const override;
 
   // Enter initialization mode
   int enter_initialization_mode(void* instance) const override;
@@ -175,6 +178,15 @@ class CASADI_EXPORT Fmu3 : public FmuInternal {
   // Retrieve auxilliary variables from FMU
   int get_aux(void* instance) override;
 
+  // Take a snapshot of the FMU state
+  void* get_fmu_state(void* instance) const override;
+
+  // Restore an FMU state snapshot
+  int set_fmu_state(void* instance, void* state) const override;
+
+  // Free an FMU state snapshot
+  void free_fmu_state(void* instance, void* state) const override;
+
   // Retrieve auxilliary variables from FMU, implementation
   int get_aux_impl(void* instance, Value& aux_value) const;
 
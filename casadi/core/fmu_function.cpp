@@ -92,17 +92,17 @@ void FmuFunction::free_mem(void *mem) const {
   // Free slave memory
   for (FmuMemory*& s : m->slaves) {
     if (!s) continue;
-    // Free FMU memory
+    // Return FMU instance to the pool
     if (s->instance) {
-      fmu_.free_instance(s->instance);
+      fmu_.release_instance(s->instance);
       s->instance = nullptr;
     }
     // Free the slave
     fmu_.free_mem(s);
   }
-  // Free FMI memory
+  // Return FMU instance to the pool
   if (m->instance) {
-    fmu_.free_instance(m->instance);
+    fmu_.release_instance(m->instance);
     m->instance = nullptr;
   }
   // Free the memory object
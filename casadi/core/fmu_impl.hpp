@@ -30,6 +30,14 @@
 #include "shared_object.hpp"
 #include "resource.hpp"
 
+#ifdef CASADI_WITH_THREAD
+#ifdef CASADI_WITH_THREAD_MINGW
+#include <mingw.mutex.h>
+#else // CASADI_WITH_THREAD_MINGW
+#include <mutex>
+#endif // CASADI_WITH_THREAD_MINGW
+#endif //CASADI_WITH_THREAD
+
 /// \cond INTERNAL
 
 namespace casadi {
@@ -75,6 +83,9 @@ class CASADI_EXPORT FmuInternal : public SharedObjectInternal {
   // Set C API functions
   virtual void load_functions() = 0;
 
+  // Reset an instance to the state right after instantiation
+  virtual int reset(void* instance) const = 0;
+
   // Enter initialization mode
   virtual int enter_initialization_mode(void* instance) const = 0;
 
@@ -116,6 +127,15 @@ class CASADI_EXPORT FmuInternal : public SharedObjectInternal {
   // Retrieve auxilliary variables from FMU
   virtual int get_aux(void* instance) = 0;
 
+  // Take a snapshot of the FMU state, returns nullptr if not supported
+  virtual void* get_fmu_state(void* instance) const { return nullptr;}
+
+  // Restore an FMU state snapshot
+  virtual int set_fmu_state(void* instance, void* state) const { return 1;}
+
+  // Free an FMU state snapshot
+  virtual void free_fmu_state(void* instance, void* state) const {}
+
   // Finalize
   virtual void finalize();
 
@@ -200,6 +220,21 @@ class CASADI_EXPORT FmuInternal : public SharedObjectInternal {
   // Free FMU instance
   virtual void free_instance(void* c) const = 0;
 
+  // Bring a new or reset instance into continuous-time mode
+  int initialize_instance(void* instance) const;
+
+  // Get an initialized instance, reusing a pooled instance if available
+  void* checkout_instance() const;
+
+  // Return an instance to the pool
+  void release_instance(void* instance) const;
+
+  // Free all pooled instances and their snapshots
+  void clear_instance_pool() const;
+
+  // Number of live instances and of pooled instances, for the function statistics
+  void get_pool_stats(Dict* stats) const;
+
   // Set value
   void set(FmuMemory* m, size_t ind, const double* value) const;
 
@@ -335,6 +370,9 @@ class CASADI_EXPORT FmuInternal : public SharedObjectInternal {
   // Does the FMU declare restrictions on instantiation?
   bool can_be_instantiated_only_once_per_process_;
 
+  // Can the FMU state be retrieved and restored?
+  bool can_get_and_set_fmu_state_;
+
   // Start time
   double start_time_;
 
@@ -372,6 +410,17 @@ class CASADI_EXPORT FmuInternal : public SharedObjectInternal {
   mutable bool warning_fired_values_of_continuous_states_changed_;
   mutable bool warning_fired_next_event_time_defined_;
 
+  // Initialized instances not in use
+  mutable std::vector<void*> instance_pool_;
+
+  // Snapshot of the initialized state, for each instance created by checkout_instance
+  mutable std::map<void*, void*> instance_snapshot_;
+
+#ifdef CASADI_WITH_THREAD
+  // Protects instance_pool_ and instance_snapshot_
+  mutable std::mutex instance_pool_mtx_;
+#endif //CASADI_WITH_THREAD
+
   size_t nx_;
   // Instead of set_real+get_real, do set_real+get_real+get_derivatives+get_real
   bool do_evaluation_dance_;
@@ -31,10 +31,12 @@
 #include "bspline.hpp"
 #include "nlpsol.hpp"
 #include "mapsum.hpp"
+#include "mapaccum.hpp"
 #include "conic.hpp"
 #include "jit_function.hpp"
 #include "serializing_stream.hpp"
 #include "serializer.hpp"
+#include "dump_writer.hpp"
 #include "tools.hpp"
 #include "filesystem_impl.hpp"
 
@@ -368,6 +370,7 @@ namespace casadi {
       bool cse = true;
       bool ref_count = true;
       bool const_folding = true;
+      bool algebraic = false;
       bool verbose = false;
       for (auto&& op : opts) {
         if (op.first=="empty_inputs") {
@@ -380,6 +383,8 @@ namespace casadi {
           ref_count = op.second;
         } else if (op.first=="const_folding") {
           const_folding = op.second;
+        } else if (op.first=="algebraic") {
+          algebraic = op.second;
         } else if (op.first=="verbose") {
           verbose = op.second;
         } else {
@@ -392,6 +397,7 @@ namespace casadi {
       if (cse) simp.push_back("cse");
       if (ref_count) { simp.push_back(0); simp.push_back("ref_count"); }  // 0 = fixed point
       if (const_folding) simp.push_back("const_folding");
+      if (algebraic) { simp.push_back(0); simp.push_back("algebraic"); }  // 0 = fixed point
       return transform(fname, std::vector<std::vector<GenericType> >{simp}, {{"verbose", verbose}});
     } catch(std::exception& e) {
       THROW_ERROR("transform", e.what());
@@ -658,12 +664,80 @@ namespace casadi {
     return rev(get_ptr(arg), get_ptr(res), get_ptr(iw), get_ptr(w), 0);
   }
 
+  // Base of the tower of calls in mapaccum/fold, removes the corresponding options
+  static casadi_int accum_base(casadi_int N, Dict& opts) {
+    // Default base
+    casadi_int base = 10;
+    auto it = opts.find("base");
+    bool has_base = it!=opts.end();
+    if (has_base) {
+      base = it->second;
+      opts.erase(it);
+    }
+    it = opts.find("checkpoints");
+    if (it==opts.end()) return base;
+    casadi_assert(!has_base, "mapaccum: options 'base' and 'checkpoints' are mutually exclusive");
+    casadi_int c = it->second;
+    opts.erase(it);
+    casadi_assert(c>=1, "mapaccum: checkpoints must be positive");
+    // Unroll all the way if within budget
+    if (c>=N) return -1;
+    // Each level of the tower recomputes its chunk once in reverse mode and keeps
+    // up to base values: pick the fewest levels L with base^L >= N and base*L <= c
+    for (casadi_int L=2; ; ++L) {
+      casadi_int b = static_cast<casadi_int>(std::ceil(std::pow(static_cast<double>(N), 1./L)));
+      // Guard against rounding
+      auto covers = [&](casadi_int b) {
+        double p = 1;
+        for (casadi_int l=0; l<L; ++l) p *= static_cast<double>(b);
+        return p>=static_cast<double>(N);
+      };
+      while (b>2 && covers(b-1)) b--;
+      while (!covers(b)) b++;
+      if (b*L<=c || b<=2) return std::max(b, casadi_int(2));
+    }
+  }
+
+  // Evaluate mapaccum/fold in a loop, removes the corresponding option
+  static bool accum_loop(Dict& opts) {
+    auto it = opts.find("loop");
+    if (it==opts.end()) return false;
+    bool loop = it->second;
+    opts.erase(it);
+    return loop;
+  }
+
   Function Function::fold(casadi_int N, const Dict& opts) const {
-    Function base = mapaccum(N, opts);
-    std::vector<MX> base_in = base.mx_in();
-    std::vector<MX> out = base(base_in);
-    out[0] = out[0](Slice(), range((N-1)*size2_out(0), N*size2_out(0))); // NOLINT
-    return Function("fold_"+name(), base_in, out, name_in(), name_out(), opts);
+    Dict options = opts;
+    if (accum_loop(options)) {
+      casadi_assert(options.find("base")==options.end()
+        && options.find("checkpoints")==options.end(),
+        "fold: 'loop' cannot be combined with 'base' or 'checkpoints'");
+      // States are stored for the derivatives anyway, only the last one is returned
+      Function acc = MapAccum::create("mapaccum_" + name(), *this, N, 1, false, options);
+      std::vector<MX> arg = acc.mx_in();
+      std::vector<MX> res = acc(arg);
+      res[0] = res[0](Slice(), range((N-1)*size2_out(0), N*size2_out(0))); // NOLINT
+      return Function("fold_" + name(), arg, res, name_in(), name_out(), options);
+    }
+    casadi_int base = accum_base(N, options);
+    casadi_assert(N>0, "fold: N must be positive");
+    if (base==-1) return accum_chain("fold_"+name(), std::vector<Function>(N, *this), 1,
+      true, options);
+    casadi_assert(base>=2, "fold: base must be at least 2");
+
+    // Like mapaccum, but each level of the tower only returns the final accumulator,
+    // so that reverse mode keeps at most base values per level
+    std::vector<Function> chain;
+    Function c = *this;
+    while (N!=0) {
+      casadi_int r = N % base;
+      chain.insert(chain.end(), r, c);
+      N = (N-r)/base;
+      c = c.accum_chain(c.name()+"_fold"+str(base), std::vector<Function>(base, c), 1,
+        true, options);
+    }
+    return accum_chain("fold_"+name(), chain, 1, true, options);
   }
   Function Function::mapaccum(casadi_int N, const Dict& opts) const {
     return mapaccum("mapaccum_"+name(), N, opts);
@@ -674,20 +748,18 @@ namespace casadi {
   Function Function::mapaccum(const std::string& name, casadi_int N, casadi_int n_accum,
                               const Dict& opts) const {
     Dict options = opts;
-
-    // Default base
-    casadi_int base = 10;
-    auto it = options.find("base");
-    if (it!=options.end()) {
-      base = it->second;
-      options.erase(it);
+    if (accum_loop(options)) {
+      casadi_assert(options.find("base")==options.end()
+        && options.find("checkpoints")==options.end(),
+        "mapaccum: 'loop' cannot be combined with 'base' or 'checkpoints'");
+      return MapAccum::create(name, *this, N, n_accum, false, options);
     }
-
+    casadi_int base = accum_base(N, options);
     casadi_assert(N>0, "mapaccum: N must be positive");
 
     if (base==-1)
       return mapaccum(name, std::vector<Function>(N, *this), n_accum, options);
-    casadi_assert(base>=2, "mapaccum: base must be positive");
+    casadi_assert(base>=2, "mapaccum: base must be at least 2");
 
     // Decompose N into
     std::vector<Function> chain;
@@ -704,6 +776,12 @@ namespace casadi {
   Function Function::mapaccum(const std::string& name,
                       const std::vector<Function>& chain, casadi_int n_accum,
                       const Dict& opts) const {
+    return accum_chain(name, chain, n_accum, false, opts);
+  }
+
+  Function Function::accum_chain(const std::string& name,
+                      const std::vector<Function>& chain, casadi_int n_accum,
+                      bool final_only, const Dict& opts) const {
     // Shorthands
     casadi_int n_in = this->n_in(), n_out = this->n_out();
     // Consistency checks
@@ -729,7 +807,7 @@ namespace casadi {
       // Call f
       res = f(arg);
       // Save output expressions
-      for (casadi_int i=0; i<n_out; ++i) vres[i].push_back(res[i]);
+      for (casadi_int i=final_only ? n_accum : 0; i<n_out; ++i) vres[i].push_back(res[i]);
       // Copy function output to input
       std::copy_n(res.begin(), n_accum, arg.begin());
       for (casadi_int i=0; i<n_accum; ++i) {
@@ -742,7 +820,7 @@ namespace casadi {
     }
     // Construct return
     for (casadi_int i=0; i<n_in; ++i) arg[i] = horzcat(varg[i]);
-    for (casadi_int i=0; i<n_out; ++i) res[i] = horzcat(vres[i]);
+    for (casadi_int i=final_only ? n_accum : 0; i<n_out; ++i) res[i] = horzcat(vres[i]);
     return Function(name, arg, res, name_in(), name_out(), opts);
   }
 
@@ -797,6 +875,13 @@ namespace casadi {
   Function Function::map(const std::string& name, const std::string& parallelization, casadi_int n,
       const std::vector<casadi_int>& reduce_in, const std::vector<casadi_int>& reduce_out,
         const Dict& opts) const {
+    // Parallel map with reduction, partial sums per block
+    if (parallelization=="openmp" && n>1) {
+      std::vector<bool> r_in(n_in(), false), r_out(n_out(), false);
+      for (casadi_int i : reduce_in) r_in.at(i) = true;
+      for (casadi_int i : reduce_out) r_out.at(i) = true;
+      return MapSum::create(name, parallelization, *this, n, r_in, r_out, opts);
+    }
     // Wrap in an MXFunction
     Function f = map(n, parallelization);
     // Start with the fully mapped inputs
@@ -814,7 +899,7 @@ namespace casadi {
       res[i] = repsum(res[i], 1, n);
     }
     // Construct return
-    return Function(name, arg, res, name_in(), name_out());
+    return Function(name, arg, res, name_in(), name_out(), opts);
   }
 
   Function Function::map(const std::string& name, const std::string& parallelization, casadi_int n,
@@ -1451,6 +1536,17 @@ namespace casadi {
     return nz_to_out(data.nonzeros());
   }
 
+  std::vector<std::vector<DM> > Function::read_dump(const std::string& fname, bool out) const {
+    casadi_int n = out ? n_out() : n_in();
+    std::vector<Sparsity> sp(n);
+    for (casadi_int i=0; i<n; ++i) sp[i] = out ? sparsity_out(i) : sparsity_in(i);
+    std::vector<std::vector<DM> > ret;
+    for (const std::vector<double>& d : DumpWriter::read(fname, out, sp)) {
+      ret.push_back(out ? nz_to_out(d) : nz_to_in(d));
+    }
+    return ret;
+  }
+
   void Function::export_code(const std::string& lang,
       std::ostream &stream, const Dict& options) const {
     (*this)->export_code(lang, stream, options);
@@ -1746,6 +1842,21 @@ namespace casadi {
     }
   }
 
+  int Function::operator()(const float** arg, float** res,
+      casadi_int* iw, float* w) const {
+    scoped_checkout<Function> mem(*this);
+    return operator()(arg, res, iw, w, mem);
+  }
+
+  int Function::operator()(const float** arg, float** res,
+      casadi_int* iw, float* w, int mem) const {
+    try {
+      return (*this)->eval_single(arg, res, iw, w, memory(mem));
+    } catch(std::exception& e) {
+      THROW_ERROR("operator()", e.what());
+    }
+  }
+
   const SX Function::sx_in(casadi_int iind) const {
     try {
       return (*this)->sx_in(iind);
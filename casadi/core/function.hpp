@@ -214,14 +214,14 @@ namespace casadi {
     * - passes (OT_VECTORVECTOR): an ordered list of passes. Each pass is a list
     *   whose first entry is the verb:
     *   - {"simplify", task, ...}: graph simplification passes applied in order
-    *     (cse, ref_count, const_folding, combine_terms, empty_inputs).
+    *     (cse, ref_count, const_folding, combine_terms, algebraic, empty_inputs).
     *     An integer before a task sets its run count (N>0: N times, 0: until a
     *     fixed point); the default is 1.
     *   - {"expand"}: expand to an SXFunction
     *   - {"external", library, operation, opts}: apply an externally defined
     *     transform (opts is an optional dict)
     * - boolean shorthands (used only when "passes" is absent): empty_inputs,
-    *   combine_terms, cse, ref_count, const_folding. These build a single
+    *   combine_terms, cse, ref_count, const_folding, algebraic. These build a single
     *   "simplify" pass.
     *
     * The dict-only form applies a default simplification flow when empty.
@@ -679,6 +679,17 @@ namespace casadi {
     int operator()(const SXElem** arg, SXElem** res,
         casadi_int* iw, SXElem* w, int mem=0) const;
 
+    /** \brief Evaluate memory-less in single precision
+
+        Same syntax as the double version. Functions without a single precision
+        implementation evaluate internally in double precision. */
+    int operator()(const float** arg, float** res,
+        casadi_int* iw, float* w, int mem) const;
+
+    /** \brief Evaluate in single precision with checkout/release */
+    int operator()(const float** arg, float** res,
+        casadi_int* iw, float* w) const;
+
     /** \brief  Propagate sparsity forward
 
         \identifier{1we} */
@@ -751,6 +762,18 @@ namespace casadi {
 
         Set base to -1 to unroll all the way; no gains in memory efficiency here.
 
+        Alternatively, set checkpoints (options dictionary) to the maximum number
+        of intermediate states that may be kept per chunk; the base is then chosen
+        to give the fewest levels of recomputation in reverse mode within that budget.
+        The reverse mode of fold (which only returns the final state) then keeps
+        O(checkpoints) states instead of N. The base and checkpoints options cannot be
+        combined.
+
+        Set loop to true to evaluate the function in a loop instead of a tower of calls:
+        construction and generated code no longer grow with N, and the derivatives are
+        loops as well, evaluated around the states stored in the accumulated outputs.
+        Requires accumulated inputs and outputs of identical sparsity.
+
         \identifier{1wi} */
     Function mapaccum(const std::string& name, casadi_int N, const Dict& opts = Dict()) const;
     Function mapaccum(const std::string& name, casadi_int N, casadi_int n_accum,
@@ -800,7 +823,8 @@ namespace casadi {
     /** \brief Map with reduction
 
       A subset of the inputs are non-repeated and a subset of the outputs summed
-      up.
+      up. With openmp parallelization, the sums are formed from partial sums over
+      a fixed number of blocks, so the result does not depend on the number of threads.
 
         \identifier{1wk} */
     Function map(const std::string& name, const std::string& parallelization, casadi_int n,
@@ -935,6 +959,15 @@ namespace casadi {
     std::vector<DM> generate_out(const std::string& fname);
     /// @}
 
+    /** \brief Read the inputs or outputs recorded with dump_format 'bin'
+     *
+     * Returns one entry per recorded evaluation, in the order they were written.
+     *
+     * \param fname Dump file, <dump_dir>/<name>.casadi_dump
+     * \param out Read the outputs instead of the inputs
+     */
+    std::vector<std::vector<DM> > read_dump(const std::string& fname, bool out=false) const;
+
     /** \brief Export function in specific language
      *
      * Only allowed for (a subset of) SX/MX Functions
@@ -1363,6 +1396,10 @@ namespace casadi {
     Function mapaccum(const std::string& name, const std::vector<Function>& chain,
                       casadi_int n_accum=1, const Dict& opts = Dict()) const;
 
+    /// Helper function for mapaccum and fold, optionally only returning the final accumulators
+    Function accum_chain(const std::string& name, const std::vector<Function>& chain,
+                      casadi_int n_accum, bool final_only, const Dict& opts) const;
+
 #ifdef WITH_EXTRA_CHECKS
     public:
     // How many times have we passed through
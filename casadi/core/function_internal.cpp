@@ -36,6 +36,7 @@
 #include "rootfinder_impl.hpp"
 #include "map.hpp"
 #include "mapsum.hpp"
+#include "mapaccum.hpp"
 #include "switch.hpp"
 #include "interpolant_impl.hpp"
 #include "nlpsol_impl.hpp"
@@ -46,6 +47,7 @@
 #include "blazing_spline_impl.hpp"
 #include "onnx_function_impl.hpp"
 #include "filesystem_impl.hpp"
+#include "dump_writer.hpp"
 
 #include <cctype>
 #include <typeinfo>
@@ -90,6 +92,10 @@ namespace casadi {
     jit_serialize_ = "source";
     jit_base_name_ = "jit_tmp";
     jit_temp_suffix_ = true;
+    jit_threshold_ = 0;
+    jit_count_ = 0;
+    jit_eval_ = nullptr;
+    profiler_name_ = nullptr;
     compiler_plugin_ = CASADI_STR(CASADI_DEFAULT_COMPILER_PLUGIN);
 
     eval_ = nullptr;
@@ -110,7 +116,9 @@ namespace casadi {
     dump_out_ = false;
     dump_dir_ = ".";
     dump_format_ = "mtx";
+    dump_buffer_ = 1024;
     dump_ = false;
+    single_precision_ = false;
     sz_arg_tmp_ = 0;
     sz_res_tmp_ = 0;
     sz_iw_tmp_ = 0;
@@ -121,18 +129,29 @@ namespace casadi {
     sz_w_per_ = 0;
 
     dump_count_ = 0;
+    dump_writer_ = nullptr;
   }
 
   ProtoFunction::~ProtoFunction() {
-    for (void* m : mem_) {
-      if (m!=nullptr) casadi_warning("Memory object has not been properly freed");
+    for (int i=0; i<n_mem_; ++i) {
+      if (mem_slot(i).mem!=nullptr) casadi_warning("Memory object has not been properly freed");
     }
-    mem_.clear();
+    for (auto&& b : mem_blocks_) delete[] b.load();
   }
 
   FunctionInternal::~FunctionInternal() {
+#ifdef CASADI_WITH_THREAD
+    if (jit_thread_.joinable()) {
+      // The compiler thread holds a reference and may be the one releasing the last
+      if (jit_thread_.get_id()==std::this_thread::get_id()) {
+        jit_thread_.detach();
+      } else {
+        jit_thread_.join();
+      }
+    }
+#endif // CASADI_WITH_THREAD
     if (decref_) decref_();
-    if (jit_cleanup_ && jit_) {
+    if (jit_cleanup_ && jit_ && compiler_plugin_!="llvm") {
       std::string jit_name = jit_directory_ + jit_name_ + ".c";
       if (remove(jit_name.c_str())) casadi_warning("Failed to remove " + jit_name);
     }
@@ -256,6 +275,12 @@ namespace casadi {
       {"jit_options",
        {OT_DICT,
         "Options to be passed to the jit compiler."}},
+      {"jit_threshold",
+       {OT_INT,
+        "Number of evaluations with the interpreter before the function is compiled. "
+        "Requires jit=true and the in-process compiler 'llvm', which then compiles "
+        "in a background thread while the interpreter keeps serving evaluations. "
+        "Default: 0 (compile during construction)"}},
       {"derivative_of",
        {OT_FUNCTION,
         "The function is a derivative of another function. "
@@ -320,7 +345,19 @@ namespace casadi {
         "Directory to dump inputs/outputs to. Make sure the directory exists [.]"}},
       {"dump_format",
        {OT_STRING,
-        "Choose file format to dump matrices. See DM.from_file [mtx]"}},
+        "Choose file format to dump matrices. See DM.from_file [mtx]. "
+        "'bin' appends all inputs/outputs to a single binary file <name>.casadi_dump, "
+        "written in the background (readable with Function.read_dump)"}},
+      {"dump_buffer",
+       {OT_INT,
+        "Number of records queued for dump_format 'bin' before further records "
+        "are dropped (see stats) [1024]"}},
+      {"single_precision",
+       {OT_BOOL,
+        "Evaluate numerically in single precision: inputs and outputs are rounded to float. "
+        "SX functions evaluate all operations in float, other functions "
+        "evaluate internally in double precision. Ignored by just-in-time compiled functions. "
+        "[false]"}},
       {"forward_options",
        {OT_DICT,
         "Options to be passed to a forward mode constructor"}},
@@ -396,6 +433,7 @@ namespace casadi {
     opts["jit_serialize"] = jit_serialize_;
     opts["compiler"] = compiler_plugin_;
     opts["jit_options"] = jit_options_;
+    opts["jit_threshold"] = jit_threshold_;
     opts["jit_name"] = jit_base_name_;
     opts["jit_temp_suffix"] = jit_temp_suffix_;
     opts["ad_weight"] = ad_weight_;
@@ -424,8 +462,10 @@ namespace casadi {
     opts["dump_out"] = dump_out_;
     opts["dump_dir"] = dump_dir_;
     opts["dump_format"] = dump_format_;
+    opts["dump_buffer"] = dump_buffer_;
     opts["dump"] = dump_;
     if (target=="clone") {
+      opts["single_precision"] = single_precision_;
       opts["is_diff_in"] = is_diff_in_;
       opts["is_diff_out"] = is_diff_out_;
     }
@@ -459,9 +499,16 @@ namespace casadi {
     } else if (option_name=="dump_out") {
       dump_out_ = option_value;
     } else if (option_name=="dump_dir") {
+      dump_writer_check(option_name);
       dump_dir_ = option_value.to_string();
     } else if (option_name=="dump_format") {
+      dump_writer_check(option_name);
       dump_format_ = option_value.to_string();
+    } else if (option_name=="dump_buffer") {
+      dump_writer_check(option_name);
+      dump_buffer_ = option_value;
+    } else if (option_name=="single_precision") {
+      single_precision_ = option_value;
     } else {
       // Option not found - continue to base classes
       ProtoFunction::change_option(option_name, option_value);
@@ -501,6 +548,8 @@ namespace casadi {
         compiler_plugin_ = op.second.to_string();
       } else if (op.first=="jit_options") {
         jit_options_ = op.second;
+      } else if (op.first=="jit_threshold") {
+        jit_threshold_ = op.second;
       } else if (op.first=="jit_name") {
         jit_base_name_ = op.second.to_string();
       } else if (op.first=="jit_temp_suffix") {
@@ -543,6 +592,10 @@ namespace casadi {
         dump_dir_ = op.second.to_string();
       } else if (op.first=="dump_format") {
         dump_format_ = op.second.to_string();
+      } else if (op.first=="dump_buffer") {
+        dump_buffer_ = op.second;
+      } else if (op.first=="single_precision") {
+        single_precision_ = op.second;
       } else if (op.first=="forward_options") {
         forward_options_ = op.second;
       } else if (op.first=="reverse_options") {
@@ -572,6 +625,11 @@ namespace casadi {
     // print_time implies record_time
     if (print_time_) record_time_ = true;
 
+    // Deferred compilation only exists for the in-process compiler
+    casadi_assert(jit_threshold_>=0, "Option 'jit_threshold' must be non-negative.");
+    casadi_assert(jit_threshold_==0 || (jit_ && compiler_plugin_=="llvm"),
+      "Option 'jit_threshold' requires jit=true and the compiler 'llvm'.");
+
     // Verbose?
     if (verbose_) casadi_message(name_ + "::init");
 
@@ -743,7 +801,18 @@ namespace casadi {
       }
     }
 
-    if (jit_) {
+    if (jit_ && compiler_plugin_=="llvm") {
+      // In-process compilation, no source file involved
+      casadi_assert(jit_serialize_=="source",
+        "Option 'jit_serialize' must be 'source' for the in-process compiler 'llvm'.");
+      if (jit_threshold_==0) {
+        if (verbose_) casadi_message("Compiling function '" + name_ + "'..");
+        compiler_ = jit_in_process();
+        eval_ = (eval_t) compiler_.get_function(name_);
+        casadi_assert(eval_!=nullptr, "Cannot load JIT'ed function.");
+        if (verbose_) casadi_message("Compiling function '" + name_ + "' done.");
+      }
+    } else if (jit_) {
       jit_name_ = jit_base_name_;
       jit_directory_ = get_jit_directory(jit_options_);
       if (jit_temp_suffix_) {
@@ -785,6 +854,47 @@ namespace casadi {
     if (dump_) dump();
   }
 
+  const char* FunctionInternal::profiler_name() const {
+    const char* ret = profiler_name_.load(std::memory_order_relaxed);
+    if (ret==nullptr) {
+      ret = Profiler::intern(name_);
+      profiler_name_.store(ret, std::memory_order_relaxed);
+    }
+    return ret;
+  }
+
+  Importer FunctionInternal::jit_in_process() const {
+    Dict opts = jit_options_;
+    opts["function"] = self();
+    return Importer(name_, compiler_plugin_, opts);
+  }
+
+  eval_t FunctionInternal::jit_hot() const {
+    eval_t ret = jit_eval_.load(std::memory_order_acquire);
+    if (ret || ++jit_count_ != jit_threshold_) return ret;
+#ifdef CASADI_WITH_THREAD
+    // Keep interpreting while compiling, the thread keeps the instance alive
+    Function f = self();
+    jit_thread_ = std::thread([this, f]() { jit_compile_hot();});
+    return nullptr;
+#else // CASADI_WITH_THREAD
+    jit_compile_hot();
+    return jit_eval_.load(std::memory_order_acquire);
+#endif // CASADI_WITH_THREAD
+  }
+
+  void FunctionInternal::jit_compile_hot() const {
+    try {
+      if (verbose_) casadi_message("Compiling function '" + name_ + "'..");
+      jit_compiler_ = jit_in_process();
+      jit_eval_.store((eval_t) jit_compiler_.get_function(name_), std::memory_order_release);
+      if (verbose_) casadi_message("Compiling function '" + name_ + "' done.");
+    } catch (std::exception& e) {
+      casadi_warning("Compiling function '" + name_ + "' failed, "
+                     "evaluation continues with the interpreter: " + std::string(e.what()));
+    }
+  }
+
   void ProtoFunction::finalize() {
     // Create memory object
     int mem = checkout();
@@ -823,7 +933,37 @@ namespace casadi {
     }
   }
 
+  DumpWriter* FunctionInternal::dump_writer() const {
+    DumpWriter* w = dump_writer_;
+    if (w) return w;
+#ifdef CASADI_WITH_THREAD
+    std::lock_guard<std::mutex> lock(mtx_);
+    w = dump_writer_;
+    if (w) return w;
+#endif // CASADI_WITH_THREAD
+    std::vector<Sparsity> sp[2] = {sparsity_in_, sparsity_out_};
+    std::string fname = dump_dir_+ filesep() + name_ + ".casadi_dump";
+    if (verbose_) {
+      casadi_message("binary dump for " + name_ + " -> " + fname);
+    }
+    // Shared with other Functions dumping to the same file
+    dump_writer_owner_ = DumpWriter::open(fname, dump_buffer_, sp);
+    w = dump_writer_owner_.get();
+    dump_writer_ = w;
+    return w;
+  }
+
+  void FunctionInternal::dump_writer_check(const std::string& option_name) const {
+    // Evaluations may be pushing to the writer at any time
+    casadi_assert(!dump_writer_, "Cannot change option '" + option_name + "' of '" + name_
+      + "' after binary dumping has started.");
+  }
+
   void FunctionInternal::dump_in(casadi_int id, const double** arg) const {
+    if (dump_format_=="bin") {
+      dump_writer()->push(false, id, arg);
+      return;
+    }
     std::stringstream ss;
     ss << std::setfill('0') << std::setw(6) << id;
     std::string count = ss.str();
@@ -839,6 +979,10 @@ namespace casadi {
   }
 
   void FunctionInternal::dump_out(casadi_int id, double** res) const {
+    if (dump_format_=="bin") {
+      dump_writer()->push(true, id, res);
+      return;
+    }
     std::stringstream ss;
     ss << std::setfill('0') << std::setw(6) << id;
     std::string count = ss.str();
@@ -866,6 +1010,8 @@ namespace casadi {
     if (record_time_) {
       m->add_stat("total");
       m->t_total = &m->fstats.at("total");
+      // Recorded as a span with the name of the function instead
+      m->t_total->name = nullptr;
     } else {
       m->t_total = nullptr;
     }
@@ -984,9 +1130,11 @@ namespace casadi {
     }
     // Reset statistics
     for (auto&& s : m->fstats) s.second.reset();
+    ProfilerScope profile(Profiler::is_active() ? profiler_name() : nullptr);
     if (m->t_total) m->t_total->tic();
     int ret;
-    if (eval_) {
+    eval_t eval_jit = eval_ ? eval_ : jit_threshold_>0 ? jit_hot() : nullptr;
+    if (eval_jit) {
       auto *m = static_cast<FunctionMemory*>(mem);
       m->stats_available = true;
       int mem_ = 0;
@@ -996,13 +1144,15 @@ namespace casadi {
 #endif //CASADI_WITH_THREAD
         mem_ = checkout_();
       }
-      ret = eval_(arg, res, iw, w, mem_);
+      ret = eval_jit(arg, res, iw, w, mem_);
       if (release_) {
 #ifdef CASADI_WITH_THREAD
     std::lock_guard<std::mutex> lock(mtx_);
 #endif //CASADI_WITH_THREAD
         release_(mem_);
       }
+    } else if (single_precision_) {
+      ret = eval_as_single(arg, res, iw, w, mem);
     } else {
       ret = eval(arg, res, iw, w, mem);
     }
@@ -1031,6 +1181,18 @@ namespace casadi {
     return ret;
   }
 
+  int FunctionInternal::eval_batch(const double** arg, double** res, casadi_int* iw, double* w,
+      void* mem, casadi_int n) const {
+    casadi_error("'eval_batch' not defined for " + class_name());
+    return 1;
+  }
+
+  bool FunctionInternal::use_eval_batch() const {
+    if (dump_in_ || dump_out_ || dump_ || print_in_ || print_out_) return false;
+    if (eval_ || jit_threshold_>0 || single_precision_ || regularity_check_) return false;
+    return has_eval_batch();
+  }
+
   void FunctionInternal::print_dimensions(std::ostream &stream) const {
     stream << " Number of inputs: " << n_in_ << std::endl;
     for (casadi_int i=0; i<n_in_; ++i) {
@@ -2672,6 +2834,8 @@ namespace casadi {
     // Checkout/release routines
     g << g.declare("int " + name_ + "_checkout(void)") << " {\n";
     if (needs_mem) {
+      // Initialization may read constants
+      g << g.blob_check("return -1;");
       std::string checkout = g.shorthand(name + "_checkout");
       g << "return " << checkout << "();\n";
     } else {
@@ -2690,6 +2854,8 @@ namespace casadi {
 
     // Reference counter routines
     g << g.declare("void " + name_ + "_incref(void)") << " {\n";
+    // Read the constant blob while the caller is still single-threaded
+    if (g.constant_blob=="file") g << "(void)" << g.shorthand("blob") << "();\n";
     if (has_refcount_in_deps_) {
       std::string incref = g.shorthand(name + "_incref");
       g << incref << "();\n";
@@ -2824,6 +2990,10 @@ namespace casadi {
       // Allocate output buffers
       g << "casadi_real* res[" << sz_res() << "] = {0};\n";
 
+      // Conversions from and to MATLAB read the sparsity patterns
+      g << g.blob_check("mexErrMsgIdAndTxt(\"Casadi:RuntimeError\",\"Evaluation of \\\""
+        + name_ + "\\\" failed: constant data could not be read.\");");
+
       // Check arguments
       g << "if (argc>" << n_in_ << ") mexErrMsgIdAndTxt(\"Casadi:RuntimeError\","
         << "\"Evaluation of \\\"" << name_ << "\\\" failed. Too many input arguments "
@@ -3171,6 +3341,10 @@ namespace casadi {
     casadi_assert(m->stats_available,
       "No stats available: Function '" + name_ + "' not set up. "
       "To get statistics, first evaluate it numerically.");
+    if (DumpWriter* w = dump_writer_) {
+      stats["n_dump_written"] = w->n_written();
+      stats["n_dump_dropped"] = w->n_dropped();
+    }
     return stats;
   }
 
@@ -3744,10 +3918,14 @@ namespace casadi {
   }
 
   void ProtoFunction::clear_mem() {
-    for (auto&& i : mem_) {
-      if (i!=nullptr) free_mem(i);
+    for (int i=0; i<n_mem_; ++i) {
+      if (mem_slot(i).mem!=nullptr) free_mem(mem_slot(i).mem);
+    }
+    n_mem_ = 0;
+    for (auto&& b : mem_blocks_) {
+      delete[] b.load();
+      b = nullptr;
     }
-    mem_.clear();
   }
 
   size_t FunctionInternal::get_n_in() {
@@ -3844,43 +4022,58 @@ namespace casadi {
     return Sparsity::scalar();
   }
 
+  ProtoFunction::MemorySlot& ProtoFunction::mem_slot(int ind) const {
+    // Block k holds the memory objects 2^k-1, ..., 2^(k+1)-2
+    unsigned int i = static_cast<unsigned int>(ind) + 1;
+    int k = 0;
+    while (i >> (k+1)) k++;
+    return mem_blocks_[k].load(std::memory_order_acquire)[i - (1u << k)];
+  }
+
   void* ProtoFunction::memory(int ind) const {
-#ifdef CASADI_WITH_THREAD
-    std::lock_guard<std::mutex> lock(mtx_);
-#endif //CASADI_WITH_THREAD
-    return mem_.at(ind);
+    if (!has_memory(ind)) throw std::out_of_range("Memory object " + str(ind) + " not found");
+    return mem_slot(ind).mem;
   }
 
   bool ProtoFunction::has_memory(int ind) const {
-    return ind<mem_.size();
+    return ind>=0 && ind<n_mem_.load(std::memory_order_acquire);
   }
 
   int ProtoFunction::checkout() const {
+    // Use the first unused memory object, without locking
+    int n = n_mem_.load(std::memory_order_acquire);
+    for (int i=0; i<n; ++i) {
+      std::atomic<bool>& busy = mem_slot(i).busy;
+      bool expected = false;
+      if (!busy.load(std::memory_order_relaxed)
+          && busy.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+        return i;
+      }
+    }
+    // Allocate a new memory object
 #ifdef CASADI_WITH_THREAD
     std::lock_guard<std::mutex> lock(mtx_);
 #endif //CASADI_WITH_THREAD
-    if (unused_.empty()) {
-      check_mem_count(mem_.size()+1);
-      // Allocate a new memory object
-      void* m = alloc_mem();
-      mem_.push_back(m);
-      if (init_mem(m)) {
-        casadi_error("Failed to create or initialize memory object");
-      }
-      return static_cast<int>(mem_.size()) - 1;
-    } else {
-      // Use an unused memory object
-      int m = unused_.top();
-      unused_.pop();
-      return m;
+    n = n_mem_.load(std::memory_order_relaxed);
+    check_mem_count(n+1);
+    unsigned int k = 0;
+    while ((static_cast<unsigned int>(n) + 1) >> (k+1)) k++;
+    if (mem_blocks_[k].load(std::memory_order_relaxed)==nullptr) {
+      mem_blocks_[k].store(new MemorySlot[1u << k], std::memory_order_release);
+    }
+    MemorySlot& s = mem_slot(n);
+    s.mem = alloc_mem();
+    s.busy.store(true, std::memory_order_relaxed);
+    // Publish the slot
+    n_mem_.store(n+1, std::memory_order_release);
+    if (init_mem(s.mem)) {
+      casadi_error("Failed to create or initialize memory object");
     }
+    return n;
   }
 
   void ProtoFunction::release(int mem) const {
-#ifdef CASADI_WITH_THREAD
-    std::lock_guard<std::mutex> lock(mtx_);
-#endif //CASADI_WITH_THREAD
-    unused_.push(mem);
+    mem_slot(mem).busy.store(false, std::memory_order_release);
   }
 
   Function FunctionInternal::
@@ -4016,6 +4209,54 @@ namespace casadi {
     }
   }
 
+  int FunctionInternal::eval_single(const float** arg, float** res, casadi_int* iw, float* w,
+      void* mem) const {
+    auto m = static_cast<ProtoFunctionMemory*>(mem);
+    // Double precision copies of the inputs and outputs, followed by the work vector
+    m->w_double.resize(nnz_in() + nnz_out() + sz_w());
+    m->arg_double.resize(sz_arg());
+    m->res_double.resize(sz_res());
+    double* v = get_ptr(m->w_double);
+    for (casadi_int i=0; i<n_in_; ++i) {
+      m->arg_double[i] = arg[i] ? v : nullptr;
+      if (arg[i]) std::copy_n(arg[i], nnz_in(i), v);
+      v += nnz_in(i);
+    }
+    for (casadi_int i=0; i<n_out_; ++i) {
+      m->res_double[i] = res[i] ? v : nullptr;
+      v += nnz_out(i);
+    }
+    int ret = eval(get_ptr(m->arg_double), get_ptr(m->res_double), iw, v, mem);
+    for (casadi_int i=0; i<n_out_; ++i) {
+      if (res[i]) std::copy_n(m->res_double[i], nnz_out(i), res[i]);
+    }
+    return ret;
+  }
+
+  int FunctionInternal::eval_as_single(const double** arg, double** res, casadi_int* iw,
+      double* w, void* mem) const {
+    auto m = static_cast<ProtoFunctionMemory*>(mem);
+    // Single precision copies of the inputs and outputs, followed by the work vector
+    m->w_single.resize(nnz_in() + nnz_out() + sz_w());
+    m->arg_single.resize(sz_arg());
+    m->res_single.resize(sz_res());
+    float* v = get_ptr(m->w_single);
+    for (casadi_int i=0; i<n_in_; ++i) {
+      m->arg_single[i] = arg[i] ? v : nullptr;
+      if (arg[i]) std::copy_n(arg[i], nnz_in(i), v);
+      v += nnz_in(i);
+    }
+    for (casadi_int i=0; i<n_out_; ++i) {
+      m->res_single[i] = res[i] ? v : nullptr;
+      v += nnz_out(i);
+    }
+    int ret = eval_single(get_ptr(m->arg_single), get_ptr(m->res_single), iw, v, mem);
+    for (casadi_int i=0; i<n_out_; ++i) {
+      if (res[i]) std::copy_n(m->res_single[i], nnz_out(i), res[i]);
+    }
+    return ret;
+  }
+
 
   void ProtoFunction::print_time(const std::map<std::string, FStats>& fstats) const {
     if (!print_time_) return;
@@ -4188,7 +4429,7 @@ namespace casadi {
 
   void FunctionInternal::serialize_body(SerializingStream& s) const {
     ProtoFunction::serialize_body(s);
-    s.version("FunctionInternal", 8);
+    s.version("FunctionInternal", 11);
     s.pack("FunctionInternal::is_diff_in", is_diff_in_);
     s.pack("FunctionInternal::is_diff_out", is_diff_out_);
     s.pack("FunctionInternal::sp_in", sparsity_in_);
@@ -4212,6 +4453,7 @@ namespace casadi {
     s.pack("FunctionInternal::jit_base_name", jit_base_name_);
     s.pack("FunctionInternal::jit_options", jit_options_);
     s.pack("FunctionInternal::compiler_plugin", compiler_plugin_);
+    s.pack("FunctionInternal::jit_threshold", jit_threshold_);
     s.pack("FunctionInternal::has_refcount", has_refcount_);
 
     s.pack("FunctionInternal::cache_init", cache_init_);
@@ -4249,6 +4491,8 @@ namespace casadi {
     s.pack("FunctionInternal::dump_out", dump_out_);
     s.pack("FunctionInternal::dump_dir", dump_dir_);
     s.pack("FunctionInternal::dump_format", dump_format_);
+    s.pack("FunctionInternal::dump_buffer", dump_buffer_);
+    s.pack("FunctionInternal::single_precision", single_precision_);
     s.pack("FunctionInternal::forward_options", forward_options_);
     s.pack("FunctionInternal::reverse_options", reverse_options_);
     s.pack("FunctionInternal::jacobian_options", jacobian_options_);
@@ -4267,12 +4511,15 @@ namespace casadi {
   }
 
   FunctionInternal::FunctionInternal(DeserializingStream& s) : ProtoFunction(s) {
+    jit_count_ = 0;
+    jit_eval_ = nullptr;
+    profiler_name_ = nullptr;
     eval_ = nullptr;
     checkout_ = nullptr;
     release_ = nullptr;
     incref_ = nullptr;
     decref_ = nullptr;
-    int version = s.version("FunctionInternal", 1, 8);
+    int version = s.version("FunctionInternal", 1, 11);
     s.unpack("FunctionInternal::is_diff_in", is_diff_in_);
     s.unpack("FunctionInternal::is_diff_out", is_diff_out_);
     s.unpack("FunctionInternal::sp_in", sparsity_in_);
@@ -4308,6 +4555,11 @@ namespace casadi {
     s.unpack("FunctionInternal::jit_base_name", jit_base_name_);
     s.unpack("FunctionInternal::jit_options", jit_options_);
     s.unpack("FunctionInternal::compiler_plugin", compiler_plugin_);
+    if (version >= 9) {
+      s.unpack("FunctionInternal::jit_threshold", jit_threshold_);
+    } else {
+      jit_threshold_ = 0;
+    }
     s.unpack("FunctionInternal::has_refcount", has_refcount_);
 
     if (version >= 6) {
@@ -4357,6 +4609,16 @@ namespace casadi {
     s.unpack("FunctionInternal::dump_out", dump_out_);
     s.unpack("FunctionInternal::dump_dir", dump_dir_);
     s.unpack("FunctionInternal::dump_format", dump_format_);
+    if (version >= 10) {
+      s.unpack("FunctionInternal::dump_buffer", dump_buffer_);
+    } else {
+      dump_buffer_ = 1024;
+    }
+    if (version >= 11) {
+      s.unpack("FunctionInternal::single_precision", single_precision_);
+    } else {
+      single_precision_ = false;
+    }
     // Makes no sense to dump a Function that is being deserialized
     dump_ = false;
     s.unpack("FunctionInternal::forward_options", forward_options_);
@@ -4388,6 +4650,7 @@ namespace casadi {
     checkout_ = nullptr;
     release_ = nullptr;
     dump_count_ = 0;
+    dump_writer_ = nullptr;
   }
 
   void ProtoFunction::serialize(SerializingStream& s) const {
@@ -4419,6 +4682,7 @@ namespace casadi {
     {"Switch", Switch::deserialize},
     {"Map", Map::deserialize},
     {"MapSum", MapSum::deserialize},
+    {"MapAccum", MapAccum::deserialize},
     {"Nlpsol", Nlpsol::deserialize},
     {"Rootfinder", Rootfinder::deserialize},
     {"Integrator", Integrator::deserialize},
@@ -34,11 +34,15 @@
 #include "options.hpp"
 #include "shared_object.hpp"
 #include "timing.hpp"
+#include <atomic>
+#include <memory>
 #ifdef CASADI_WITH_THREAD
 #ifdef CASADI_WITH_THREAD_MINGW
 #include <mingw.mutex.h>
+#include <mingw.thread.h>
 #else // CASADI_WITH_THREAD_MINGW
 #include <mutex>
+#include <thread>
 #endif // CASADI_WITH_THREAD_MINGW
 #endif //CASADI_WITH_THREAD
 
@@ -51,6 +55,9 @@
 /// \cond INTERNAL
 
 namespace casadi {
+  // Forward declaration
+  class DumpWriter;
+
   template<typename T>
   std::vector<std::pair<std::string, T>> zip(const std::vector<std::string>& id,
                                              const std::vector<T>& mat) {
@@ -72,9 +79,20 @@ namespace casadi {
 
     // Add a statistic
     void add_stat(const std::string& s) {
-      bool added = fstats.insert(std::make_pair(s, FStats())).second;
-      casadi_assert(added, "Duplicate stat: '" + s + "'");
+      auto it = fstats.insert(std::make_pair(s, FStats()));
+      casadi_assert(it.second, "Duplicate stat: '" + s + "'");
+      it.first->second.name = Profiler::intern(s);
     }
+
+    // Inputs, outputs and work vector when evaluating in single precision.
+    // Kept here since the memory of some functions does not derive from FunctionMemory
+    std::vector<float> w_single;
+    std::vector<const float*> arg_single;
+    std::vector<float*> res_single;
+    // Inputs, outputs and work vector when a single precision evaluation falls back to double
+    std::vector<double> w_double;
+    std::vector<const double*> arg_double;
+    std::vector<double*> res_double;
   };
 
   /** \brief Function memory with temporary work vectors
@@ -272,11 +290,26 @@ namespace casadi {
 #endif // CASADI_WITH_THREAD
 
   private:
-    /// Memory objects
-    mutable std::vector<void*> mem_;
+    /** \brief Memory object, checked out by at most one thread at a time
+
+        Aligned to a cache line, so that the flags of different slots never share one.
+        The blocks are allocated with new[], which honours the alignment since C++17. */
+    struct alignas(64) MemorySlot {
+      void* mem = nullptr;
+      std::atomic<bool> busy{false};
+    };
+
+    /// Maximum number of memory blocks, block k holds 2^k memory objects
+    static const int mem_blocks_max = 31;
 
-    /// Unused memory objects
-    mutable std::stack<int> unused_;
+    /// Memory objects, in blocks that are never reallocated so they can be read without locking
+    mutable std::atomic<MemorySlot*> mem_blocks_[mem_blocks_max] = {};
+
+    /// Number of memory objects
+    mutable std::atomic<int> n_mem_{0};
+
+    /// Slot of a memory object
+    MemorySlot& mem_slot(int ind) const;
   };
 
   /** \brief Internal class for Function
@@ -414,6 +447,39 @@ namespace casadi {
     virtual int eval(const double** arg, double** res, casadi_int* iw, double* w, void* mem) const;
     ///@}
 
+    /** \brief  Can several instances be evaluated at once with eval_batch?
+
+        \identifier{2k3} */
+    virtual bool has_eval_batch() const { return false;}
+
+    /** \brief  Get required length of w field for eval_batch with n instances
+
+        \identifier{2k4} */
+    virtual size_t sz_w_batch(casadi_int n) const { return sz_w();}
+
+    /** \brief  Evaluate n instances numerically, inputs and outputs laid out back to back
+
+        \identifier{2k5} */
+    virtual int eval_batch(const double** arg, double** res, casadi_int* iw, double* w,
+      void* mem, casadi_int n) const;
+
+    /** \brief  Use eval_batch rather than repeated calls?
+
+        eval_batch bypasses the per-call options of eval_gen (printing, dumping, JIT, ...)
+
+        \identifier{2k6} */
+    bool use_eval_batch() const;
+
+    /** \brief  Evaluate numerically in single precision
+
+        Default implementation evaluates in double precision, converting inputs and outputs */
+    virtual int eval_single(const float** arg, float** res, casadi_int* iw, float* w,
+      void* mem) const;
+
+    /** \brief  Evaluate numerically, rounding to single precision (option single_precision) */
+    int eval_as_single(const double** arg, double** res, casadi_int* iw, double* w,
+      void* mem) const;
+
     /** \brief  Evaluate with symbolic scalars
 
         \identifier{kc} */
@@ -1406,6 +1472,30 @@ namespace casadi {
     Importer compiler_;
     Dict jit_options_;
 
+    /// Name of the function as recorded by the profiler
+    const char* profiler_name() const;
+    mutable std::atomic<const char*> profiler_name_;
+
+    /// Number of interpreted evaluations before compiling with the in-process compiler
+    casadi_int jit_threshold_;
+
+    /// Compile with the in-process compiler
+    Importer jit_in_process() const;
+
+    /// Count an interpreted evaluation, returns the compiled entry point once available
+    eval_t jit_hot() const;
+
+    /// Compile after reaching the threshold, publishes jit_eval_
+    void jit_compile_hot() const;
+
+    /// State of the compilation triggered by jit_threshold
+    mutable std::atomic<casadi_int> jit_count_;
+    mutable std::atomic<eval_t> jit_eval_;
+    mutable Importer jit_compiler_;
+#ifdef CASADI_WITH_THREAD
+    mutable std::thread jit_thread_;
+#endif // CASADI_WITH_THREAD
+
     /// Penalty factor for using a complete Jacobian to calculate directional derivatives
     double jac_penalty_;
 
@@ -1450,6 +1540,12 @@ namespace casadi {
     // Format to dump with
     std::string dump_format_;
 
+    // Number of records queued for the binary dump format
+    casadi_int dump_buffer_;
+
+    // Evaluate numerically in single precision
+    bool single_precision_;
+
     // Forward/reverse/Jacobian options
     Dict forward_options_, reverse_options_, jacobian_options_, der_options_;
 
@@ -1466,6 +1562,14 @@ namespace casadi {
     mutable casadi_int dump_count_;
 #endif // CASADI_WITH_THREAD
 
+    // Writer for the binary dump format, created on first use
+#ifdef CASADI_WITH_THREAD
+    mutable std::atomic<DumpWriter*> dump_writer_;
+#else
+    mutable DumpWriter* dump_writer_;
+#endif // CASADI_WITH_THREAD
+    mutable std::shared_ptr<DumpWriter> dump_writer_owner_;
+
     /** \brief Check if the function is of a particular type
 
         \identifier{np} */
@@ -1548,6 +1652,8 @@ namespace casadi {
     void dump_in(casadi_int id, const double** arg) const;
     void dump_out(casadi_int id, double** res) const;
     void dump() const;
+    DumpWriter* dump_writer() const;
+    void dump_writer_check(const std::string& option_name) const;
     // @}
 
     /** \brief Memory that is persistent during a call (but not between calls)
@@ -921,6 +921,10 @@ namespace casadi {
     ///@{
     /** \brief Hessian and (optionally) gradient
 
+        For SX, the option "edge_pushing" constructs the Hessian directly
+        from a single reverse sweep over the expression graph instead of
+        forward-over-reverse with a star coloring.
+
         \identifier{23z} */
     inline friend MatType hessian(const MatType &ex, const MatType &arg,
         const Dict& opts = Dict()) {
@@ -422,6 +422,7 @@ int Integrator::eval(const double** arg, double** res,
     do {
       // Reset the solver
       if (m->reset_solver) {
+        ScopedTiming tic(m->fstats.at("reset"));
         reset(m, first_call);
         m->reset_solver = false;
         first_call = false;
@@ -431,7 +432,10 @@ int Integrator::eval(const double** arg, double** res,
         casadi_message("Interval " + str(m->k) + ": Integrating forward from "
           + str(m->t) + " to " + str(m->t_next) + ", t_stop = " + str(m->t_stop));
       }
-      if (advance(m)) return 1;
+      {
+        ScopedTiming tic(m->fstats.at("advance"));
+        if (advance(m)) return 1;
+      }
       // Trigger all event, if any
       if (m->event_index >= 0) {
         // Clear list of triggered events
@@ -469,7 +473,10 @@ int Integrator::eval(const double** arg, double** res,
     // Next stop time due to step change in input
     k_stop = nt();
     // Reset the solver
-    resetB(m);
+    {
+      ScopedTiming tic(m->fstats.at("resetB"));
+      resetB(m);
+    }
     // Any adjoint seed so far?
     bool any_impulse = false;
     // Integrate backward
@@ -496,6 +503,7 @@ int Integrator::eval(const double** arg, double** res,
       if (any_impulse) {
         if (verbose_) casadi_message("Integrating backward from output time " + str(m->k)
           + ": t_next = " + str(m->t_next) + ", t_stop = " + str(m->t_stop));
+        ScopedTiming tic(m->fstats.at("retreat"));
         if (m->k > 0) {
           retreat(m, u, nullptr, nullptr, adj_u);
         } else {
@@ -912,7 +920,11 @@ void Integrator::set_work(void* mem, const double**& arg, double**& res,
 int Integrator::init_mem(void* mem) const {
   if (OracleFunction::init_mem(mem)) return 1;
 
-  //auto m = static_cast<IntegratorMemory*>(mem);
+  auto m = static_cast<IntegratorMemory*>(mem);
+  m->add_stat("reset");
+  m->add_stat("advance");
+  m->add_stat("resetB");
+  m->add_stat("retreat");
   return 0;
 }
 
@@ -265,7 +265,10 @@ namespace casadi {
         "Specifies, for each grid dimension, the lookup algorithm used to find the correct index. "
         "'linear' uses a for-loop + break; (default when #knots<=100), "
         "'exact' uses floored division (only for uniform grids), "
-        "'binary' uses a binary search. (default when #knots>100)."}},
+        "'binary' uses a binary search. (default when #knots>100). "
+        "'hunt' searches outward from the interval of the previous call, "
+        "which is cached per memory object; fast for slowly varying queries. "
+        "Plugins without such memory (bspline) treat 'hunt' as 'binary'."}},
       {"inline",
        {OT_BOOL,
         "Implement the lookup table in MX primitives. "
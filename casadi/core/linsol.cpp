@@ -98,6 +98,60 @@ namespace casadi {
     return x;
   }
 
+  std::vector<DM> Linsol::solve_batch(const std::vector<DM>& A, const std::vector<DM>& B,
+                                      bool tr) const {
+    casadi_assert(A.size()==B.size(),
+      "Linsol::solve_batch: Got " + str(A.size()) + " matrices and "
+      + str(B.size()) + " right-hand sides.");
+    casadi_int K = A.size();
+    if (K==0) return {};
+    casadi_int nrhs = B[0].size2();
+
+    // Nonzeros of all matrices and right-hand sides, back to back
+    std::vector<double> a, x;
+    a.reserve(K*sparsity().nnz());
+    x.reserve(K*sparsity().size1()*nrhs);
+    for (casadi_int k=0; k<K; ++k) {
+      casadi_assert(B[k].size1()==sparsity().size1() && B[k].size2()==nrhs,
+        "Linsol::solve_batch: Dimension mismatch. Expected right-hand sides of dimension "
+        + str(sparsity().size1()) + "-by-" + str(nrhs) + ", got " + B[k].dim() + ".");
+      const DM Ak = A[k].sparsity()==sparsity() ? A[k] : project(A[k], sparsity());
+      a.insert(a.end(), Ak->begin(), Ak->end());
+      const DM Bk = densify(B[k]);
+      x.insert(x.end(), Bk->begin(), Bk->end());
+    }
+
+    scoped_checkout<Linsol> mem(*this);
+    auto *m = static_cast<LinsolMemory*>((*this)->memory(mem));
+
+    // Reset statistics
+    for (auto&& s : m->fstats) s.second.reset();
+    if (m->t_total) m->t_total->tic();
+    // One symbolic factorization for all matrices
+    if (sfact(get_ptr(a), mem)) casadi_error("Linsol::solve_batch: 'sfact' failed");
+
+    // Numeric factorizations
+    if (nfact_batch(get_ptr(a), K, mem)) {
+      casadi_error("Linsol::solve_batch: 'nfact_batch' failed");
+    }
+
+    // Solve
+    if (solve_batch(get_ptr(a), get_ptr(x), K, nrhs, tr, mem)) {
+      casadi_error("Linsol::solve_batch: 'solve_batch' failed");
+    }
+    // Show statistics
+    if (m->t_total) m->t_total->toc();
+    (*this)->print_time(m->fstats);
+
+    // Split up solution
+    std::vector<DM> ret(K);
+    for (casadi_int k=0; k<K; ++k) {
+      ret[k] = DM::zeros(sparsity().size1(), nrhs);
+      std::copy_n(get_ptr(x) + k*ret[k].nnz(), ret[k].nnz(), ret[k].ptr());
+    }
+    return ret;
+  }
+
   MX Linsol::solve(const MX& A, const MX& B, bool tr) const {
     return A->get_solve(B, tr, *this);
   }
@@ -117,10 +171,10 @@ namespace casadi {
     // Factorization will be needed after this step
     m->is_sfact = m->is_nfact = false;
 
-    if (m->t_total) m->fstats.at("sfact").tic();
+    if (m->t_total || Profiler::is_active()) m->fstats.at("sfact").tic();
     // Perform pivoting
     if ((*this)->sfact(m, A)) return 1;
-    if (m->t_total) m->fstats.at("sfact").toc();
+    if (m->t_total || Profiler::is_active()) m->fstats.at("sfact").toc();
 
     // Mark as (successfully) pivoted
     m->is_sfact = true;
@@ -145,9 +199,9 @@ namespace casadi {
     }
 
     m->is_nfact = false;
-    if (m->t_total) m->fstats.at("nfact").tic();
+    if (m->t_total || Profiler::is_active()) m->fstats.at("nfact").tic();
     int flag = (*this)->nfact(m, A);
-    if (m->t_total) m->fstats.at("nfact").toc();
+    if (m->t_total || Profiler::is_active()) m->fstats.at("nfact").toc();
     if (flag && (*this)->regularity_check_) {
       // Collect nonzeros
       std::vector<std::string> nonzeros(sparsity().nnz());
@@ -165,9 +219,47 @@ namespace casadi {
         + "[" + (*this)->class_name() + "]. Linear system saved to '" + fname + "'");
     }
     m->is_nfact = true;
+    m->n_batch = 0;
     return flag;
   }
 
+  // Factorize the systems one at a time until nfact reports the failing one
+  static void locate_failure(const Linsol& s, const double* A, casadi_int K,
+                             casadi_int a_stride, int mem) {
+    for (casadi_int k=0; k<K; ++k) {
+      try {
+        if (s.nfact(A + k*a_stride, mem)) return;
+      } catch (std::exception& e) {
+        casadi_error("Linear system " + str(k) + " of " + str(K) + ": " + e.what());
+      }
+    }
+  }
+
+  int Linsol::nfact_batch(const double* A, casadi_int K, int mem, casadi_int a_stride) const {
+    if (A==nullptr) return 1;
+    auto *m = static_cast<LinsolMemory*>((*this)->memory(mem));
+    if (a_stride<0) a_stride = sparsity().nnz();
+
+    // Perform pivoting, if required: shared by all matrices
+    if (!m->is_sfact) {
+      if (sfact(A, mem)) return 1;
+    }
+
+    // The factorizations may overwrite the one from nfact
+    m->is_nfact = false;
+    m->n_batch = 0;
+    if (m->t_total || Profiler::is_active()) m->fstats.at("nfact").tic();
+    int flag = (*this)->nfact_batch(m, A, K, a_stride);
+    if (m->t_total || Profiler::is_active()) m->fstats.at("nfact").toc();
+    if (flag && (*this)->regularity_check_) {
+      locate_failure(*this, A, K, a_stride, mem);
+      m->is_nfact = false;
+    }
+    if (flag) return flag;
+    m->n_batch = K;
+    return 0;
+  }
+
   double Linsol::det(const double* A, int mem) const {
     auto m = static_cast<LinsolMemory*>((*this)->memory(mem));
     casadi_assert(m->is_nfact, "Linear system has not been factorized");
@@ -211,9 +303,34 @@ namespace casadi {
   int Linsol::solve(const double* A, double* x, casadi_int nrhs, bool tr, int mem) const {
     auto *m = static_cast<LinsolMemory*>((*this)->memory(mem));
     casadi_assert(m->is_nfact, "Linear system has not been factorized");
-    if (m->t_total) m->fstats.at("solve").tic();
+    if (m->t_total || Profiler::is_active()) m->fstats.at("solve").tic();
     int ret = (*this)->solve(m, A, x, nrhs, tr);
-    if (m->t_total) m->fstats.at("solve").toc();
+    if (m->t_total || Profiler::is_active()) m->fstats.at("solve").toc();
+    return ret;
+  }
+
+  int Linsol::solve_batch(const double* A, double* x, casadi_int K, casadi_int nrhs, bool tr,
+                          int mem, casadi_int a_stride, casadi_int x_stride) const {
+    auto *m = static_cast<LinsolMemory*>((*this)->memory(mem));
+    casadi_assert(m->n_batch==K, "Linear systems have not been factorized with 'nfact_batch'");
+    if (a_stride<0) a_stride = sparsity().nnz();
+    if (x_stride<0) x_stride = sparsity().size1()*nrhs;
+    if (m->t_total || Profiler::is_active()) m->fstats.at("solve").tic();
+    // Plugins without batched factorization factorize each system here
+    int ret;
+    try {
+      ret = (*this)->solve_batch(m, A, x, nrhs, tr, K, a_stride, x_stride);
+    } catch (std::exception&) {
+      if (!(*this)->regularity_check_) throw;
+      locate_failure(*this, A, K, a_stride, mem);
+      throw;
+    }
+    if (m->t_total || Profiler::is_active()) m->fstats.at("solve").toc();
+    if (ret && (*this)->regularity_check_) {
+      locate_failure(*this, A, K, a_stride, mem);
+      m->is_nfact = false;
+      m->n_batch = 0;
+    }
     return ret;
   }
 
@@ -111,6 +111,15 @@ namespace casadi {
     MX solve(const MX& A, const MX& B, bool tr=false) const;
     ///@}
 
+    /** \brief Solve K linear systems A[k]*X[k] = B[k]
+
+      * The matrices have the sparsity pattern of the solver and share
+      * one symbolic factorization
+
+        \identifier{2k0} */
+    std::vector<DM> solve_batch(const std::vector<DM>& A, const std::vector<DM>& B,
+                                bool tr=false) const;
+
     /** \brief Number of negative eigenvalues
 
       * Not available for all solvers
@@ -144,6 +153,9 @@ namespace casadi {
     int sfact(const double* A, int mem=0) const;
     int nfact(const double* A, int mem=0) const;
     int solve(const double* A, double* x, casadi_int nrhs=1, bool tr=false, int mem=0) const;
+    int nfact_batch(const double* A, casadi_int K, int mem=0, casadi_int a_stride=-1) const;
+    int solve_batch(const double* A, double* x, casadi_int K, casadi_int nrhs=1, bool tr=false,
+                    int mem=0, casadi_int a_stride=-1, casadi_int x_stride=-1) const;
     double det(const double* A, int mem = 0) const;
     casadi_int neig(const double* A, int mem=0) const;
     casadi_int rank(const double* A, int mem=0) const;
@@ -52,11 +52,9 @@ namespace casadi {
     if (!mem) return 1;
     if (ProtoFunction::init_mem(mem)) return 1;
     auto *m = static_cast<LinsolMemory*>(mem);
-    if (record_time_) {
-      m->add_stat("nfact");
-      m->add_stat("sfact");
-      m->add_stat("solve");
-    }
+    m->add_stat("nfact");
+    m->add_stat("sfact");
+    m->add_stat("solve");
     return 0;
   }
 
@@ -69,6 +67,22 @@ namespace casadi {
     casadi_error("'solve' not defined for " + class_name());
   }
 
+  int LinsolInternal::nfact_batch(void* mem, const double* A, casadi_int K,
+                                  casadi_int stride) const {
+    // Only one factorization fits in memory: factorize in solve_batch
+    return 0;
+  }
+
+  int LinsolInternal::solve_batch(void* mem, const double* A, double* x, casadi_int nrhs,
+                                  bool tr, casadi_int K, casadi_int a_stride,
+                                  casadi_int x_stride) const {
+    for (casadi_int k=0; k<K; ++k) {
+      if (nfact(mem, A + k*a_stride)) return 1;
+      if (solve(mem, A + k*a_stride, x + k*x_stride, nrhs, tr)) return 1;
+    }
+    return 0;
+  }
+
 #if 0
   casadi_int LinsolInternal::factorize(void* mem, const double* A) const {
     // Symbolic factorization, if needed
@@ -121,6 +135,16 @@ namespace casadi {
     g << "#error " <<  class_name() << " does not support determinant code generation\n";
   }
 
+  void LinsolInternal::generate_nfact(CodeGenerator& g, const std::string& A,
+                                      const std::string& w) const {
+    g << "#error " <<  class_name() << " does not support factorization code generation\n";
+  }
+
+  void LinsolInternal::generate_solve(CodeGenerator& g, const std::string& x,
+                                      casadi_int nrhs, bool tr, const std::string& w) const {
+    g << "#error " <<  class_name() << " does not support factorization code generation\n";
+  }
+
   std::map<std::string, LinsolInternal::Plugin> LinsolInternal::solvers_;
 
 #ifdef CASADI_WITH_THREADSAFE_SYMBOLICS
@@ -38,8 +38,11 @@ namespace casadi {
     // Current state of factorization
     bool is_sfact, is_nfact;
 
+    // Number of linear systems factorized by nfact_batch
+    casadi_int n_batch;
+
     // Constructor
-    LinsolMemory() : is_sfact(false), is_nfact(false) {}
+    LinsolMemory() : is_sfact(false), is_nfact(false), n_batch(0) {}
   };
 
   /** Internal class
@@ -107,6 +110,19 @@ namespace casadi {
     // Solve numerically
     virtual int solve(void* mem, const double* A, double* x, casadi_int nrhs, bool tr) const;
 
+    /// Can the solver keep several numeric factorizations (nfact_batch)?
+    virtual bool has_batch() const { return false;}
+
+    /// Numeric factorization of K linear systems with nonzeros at A + k*stride,
+    /// sharing one symbolic factorization.
+    /// The default implementation defers the factorizations to solve_batch.
+    virtual int nfact_batch(void* mem, const double* A, casadi_int K, casadi_int stride) const;
+
+    /// Solve the K linear systems factorized by nfact_batch, the right-hand sides
+    /// of system k starting at x + k*x_stride
+    virtual int solve_batch(void* mem, const double* A, double* x, casadi_int nrhs, bool tr,
+                            casadi_int K, casadi_int a_stride, casadi_int x_stride) const;
+
     /// Determinant
     virtual double det(void* mem, const double* A) const;
 
@@ -128,6 +144,18 @@ namespace casadi {
     /// (the QR factorization buffers; excludes any cache)
     virtual size_t sz_w_fact() const { return 0; }
 
+    /// Generate C code for a numeric factorization that keeps the factors in w,
+    /// for reuse by any number of subsequent generate_solve calls
+    virtual void generate_nfact(CodeGenerator& g, const std::string& A,
+                                const std::string& w) const;
+
+    /// Generate C code that solves with the factors stored in w by generate_nfact
+    virtual void generate_solve(CodeGenerator& g, const std::string& x,
+                                casadi_int nrhs, bool tr, const std::string& w) const;
+
+    /// Length of the w work vector that generate_nfact/generate_solve share
+    virtual size_t sz_w_nfact() const { return 0; }
+
     // Creator function for internal class
     typedef LinsolInternal* (*Creator)(const std::string& name, const Sparsity& sp);
 
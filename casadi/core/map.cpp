@@ -138,6 +138,14 @@ namespace casadi {
     alloc_iw(f_.sz_iw());
   }
 
+  casadi_int Map::n_batch() const {
+    if (parallelization()!="serial" || !f_->use_eval_batch()) return 0;
+    // Limit the work vector of a block to 64k entries
+    size_t sz_w1 = std::max(f_->sz_w_batch(1), static_cast<size_t>(1));
+    casadi_int nb = std::min(n_, static_cast<casadi_int>((1<<16)/sz_w1));
+    return nb>1 ? nb : 0;
+  }
+
   template<typename T>
   int Map::eval_gen(const T** arg, T** res, casadi_int* iw, T* w, int mem) const {
     const T** arg1 = arg+n_in_;
@@ -330,9 +338,34 @@ namespace casadi {
     // in Map::eval_gen
     setup(mem, arg, res, iw, w);
     scoped_checkout<Function> m(f_);
+    // Evaluate blocks of instances at once, if f_ supports it
+    casadi_int nb = n_batch();
+    if (nb>0) return eval_blocks(arg, res, iw, static_cast<MapMemory*>(mem), m, nb);
     return eval_gen(arg, res, iw, w, m);
   }
 
+  int Map::eval_blocks(const double** arg, double** res, casadi_int* iw, MapMemory* m, int mem,
+                       casadi_int nb) const {
+    // The work vectors of all instances in a block do not fit in w
+    m->w_batch.resize(f_->sz_w_batch(nb));
+    double* w = get_ptr(m->w_batch);
+    const double** arg1 = arg+n_in_;
+    std::copy_n(arg, n_in_, arg1);
+    double** res1 = res+n_out_;
+    std::copy_n(res, n_out_, res1);
+    for (casadi_int i=0; i<n_; i+=nb) {
+      casadi_int n1 = std::min(nb, n_-i);
+      if (f_->eval_batch(arg1, res1, iw, w, f_->memory(mem), n1)) return 1;
+      for (casadi_int j=0; j<n_in_; ++j) {
+        if (arg1[j]) arg1[j] += n1*f_.nnz_in(j);
+      }
+      for (casadi_int j=0; j<n_out_; ++j) {
+        if (res1[j]) res1[j] += n1*f_.nnz_out(j);
+      }
+    }
+    return 0;
+  }
+
   OmpMap::~OmpMap() {
     clear_mem();
   }
@@ -32,6 +32,11 @@
 
 namespace casadi {
 
+  struct CASADI_EXPORT MapMemory : public FunctionMemory {
+    // Work vector for evaluating several instances at once
+    std::vector<double> w_batch;
+  };
+
   /** Evaluate in parallel
       \author Joel Andersson
       \date 2015
@@ -112,6 +117,19 @@ namespace casadi {
     /// Evaluate the function numerically
     int eval(const double** arg, double** res, casadi_int* iw, double* w, void* mem) const override;
 
+    /** \brief Create memory block */
+    void* alloc_mem() const override { return new MapMemory();}
+
+    /** \brief Free memory block */
+    void free_mem(void *mem) const override { delete static_cast<MapMemory*>(mem);}
+
+    /// Number of instances per FunctionInternal::eval_batch call, zero if not batching
+    casadi_int n_batch() const;
+
+    /// Evaluate numerically in blocks of nb instances with FunctionInternal::eval_batch
+    int eval_blocks(const double** arg, double** res, casadi_int* iw, MapMemory* m, int mem,
+                    casadi_int nb) const;
+
     /// Type of parallellization
     virtual std::string parallelization() const { return "serial"; }
 
@@ -0,0 +1,424 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "mapaccum.hpp"
+#include "serializing_stream.hpp"
+
+namespace casadi {
+
+  Function MapAccum::create(const std::string& name, const Function& f, casadi_int n,
+                            casadi_int n_accum, bool reverse, const Dict& opts) {
+    casadi_assert(n>0, "mapaccum: n must be positive");
+    casadi_assert(is_chainable(f, n_accum),
+      "mapaccum: accumulated inputs and outputs of " + f.name() + " must have matching sparsity");
+    return Function::create(new MapAccum(name, f, n, n_accum, reverse), opts);
+  }
+
+  bool MapAccum::is_chainable(const Function& f, casadi_int n_accum) {
+    if (n_accum<0 || n_accum>f.n_in() || n_accum>f.n_out()) return false;
+    for (casadi_int i=0; i<n_accum; ++i) {
+      if (f.sparsity_in(i)!=f.sparsity_out(i)) return false;
+    }
+    return true;
+  }
+
+  MapAccum::MapAccum(const std::string& name, const Function& f, casadi_int n,
+                     casadi_int n_accum, bool reverse)
+    : FunctionInternal(name), f_(f), n_(n), n_accum_(n_accum), reverse_(reverse) {
+    // Two buffers per accumulator, for outputs that are not requested
+    w_acc_.resize(n_accum_+1, 0);
+    for (casadi_int i=0; i<n_accum_; ++i) w_acc_[i+1] = w_acc_[i] + 2*f_.nnz_out(i);
+  }
+
+  bool MapAccum::is_a(const std::string& type, bool recursive) const {
+    return type=="MapAccum"
+      || (recursive && FunctionInternal::is_a(type, recursive));
+  }
+
+  std::vector<std::string> MapAccum::get_function() const {
+    return {"f"};
+  }
+
+  const Function& MapAccum::get_function(const std::string &name) const {
+    casadi_assert(has_function(name),
+      "No function \"" + name + "\" in " + name_ + ". " +
+      "Available functions: " + join(get_function()) + ".");
+    return f_;
+  }
+
+  void MapAccum::find(std::map<FunctionInternal*, std::pair<Function, size_t>> & all_fun,
+      casadi_int max_depth) const {
+    // Call to base class
+    FunctionInternal::find(all_fun, max_depth);
+    add_embedded(all_fun, f_, max_depth);
+  }
+
+  bool MapAccum::has_function(const std::string& fname) const {
+    return fname=="f";
+  }
+
+  void MapAccum::serialize_body(SerializingStream &s) const {
+    FunctionInternal::serialize_body(s);
+    s.pack("MapAccum::f", f_);
+    s.pack("MapAccum::n", n_);
+    s.pack("MapAccum::n_accum", n_accum_);
+    s.pack("MapAccum::reverse", reverse_);
+  }
+
+  void MapAccum::serialize_type(SerializingStream &s) const {
+    FunctionInternal::serialize_type(s);
+    s.pack("MapAccum::class_name", class_name());
+  }
+
+  MapAccum::MapAccum(DeserializingStream& s) : FunctionInternal(s) {
+    s.unpack("MapAccum::f", f_);
+    s.unpack("MapAccum::n", n_);
+    s.unpack("MapAccum::n_accum", n_accum_);
+    s.unpack("MapAccum::reverse", reverse_);
+    w_acc_.resize(n_accum_+1, 0);
+    for (casadi_int i=0; i<n_accum_; ++i) w_acc_[i+1] = w_acc_[i] + 2*f_.nnz_out(i);
+  }
+
+  ProtoFunction* MapAccum::deserialize(DeserializingStream& s) {
+    std::string class_name;
+    s.unpack("MapAccum::class_name", class_name);
+    if (class_name=="MapAccum") {
+      return new MapAccum(s);
+    } else {
+      casadi_error("class name '" + class_name + "' unknown.");
+    }
+  }
+
+  MapAccum::~MapAccum() {
+    clear_mem();
+  }
+
+  void MapAccum::init(const Dict& opts) {
+    is_diff_in_ = f_.is_diff_in();
+    is_diff_out_ = f_.is_diff_out();
+    // Call the initialization method of the base class
+    FunctionInternal::init(opts);
+
+    // Allocate sufficient memory for serial evaluation, after the accumulator buffers
+    alloc_arg(f_.sz_arg());
+    alloc_res(f_.sz_res());
+    alloc_w(w_acc_.back() + f_.sz_w());
+    alloc_iw(f_.sz_iw());
+  }
+
+  template<typename T>
+  int MapAccum::eval_gen(const T** arg, T** res, casadi_int* iw, T* w, int mem) const {
+    const T** arg1 = arg+n_in_;
+    T** res1 = res+n_out_;
+    // Initial accumulators
+    std::copy_n(arg, n_accum_, arg1);
+    for (casadi_int k=0; k<n_; ++k) {
+      casadi_int c = col(k);
+      for (casadi_int j=n_accum_; j<n_in_; ++j) {
+        arg1[j] = arg[j] ? arg[j] + c*f_.nnz_in(j) : nullptr;
+      }
+      for (casadi_int j=0; j<n_out_; ++j) {
+        if (res[j]) {
+          res1[j] = res[j] + c*f_.nnz_out(j);
+        } else if (j<n_accum_) {
+          res1[j] = w + w_acc_[j] + (k%2)*f_.nnz_out(j);
+        } else {
+          res1[j] = nullptr;
+        }
+      }
+      if (f_(arg1, res1, iw, w + w_acc_.back(), mem)) return 1;
+      // Outputs of this step are the accumulators of the next
+      std::copy_n(res1, n_accum_, arg1);
+    }
+    return 0;
+  }
+
+  int MapAccum::eval(const double** arg, double** res, casadi_int* iw, double* w,
+      void* mem) const {
+    setup(mem, arg, res, iw, w);
+    scoped_checkout<Function> m(f_);
+    return eval_gen(arg, res, iw, w, m);
+  }
+
+  int MapAccum::eval_sx(const SXElem** arg, SXElem** res, casadi_int* iw, SXElem* w, void* mem,
+      bool always_inline, bool never_inline) const {
+    return eval_gen(arg, res, iw, w);
+  }
+
+  int MapAccum::sp_forward(const bvec_t** arg, bvec_t** res,
+      casadi_int* iw, bvec_t* w, void* mem) const {
+    return eval_gen(arg, res, iw, w);
+  }
+
+  int MapAccum::sp_reverse(bvec_t** arg, bvec_t** res, casadi_int* iw, bvec_t* w,
+      void* mem) const {
+    bvec_t** arg1 = arg+n_in_;
+    bvec_t** res1 = res+n_out_;
+    std::fill_n(w, w_acc_.back(), 0);
+    for (casadi_int k=n_-1; k>=0; --k) {
+      casadi_int c = col(k);
+      for (casadi_int j=n_accum_; j<n_in_; ++j) {
+        arg1[j] = arg[j] ? arg[j] + c*f_.nnz_in(j) : nullptr;
+      }
+      for (casadi_int j=0; j<n_out_; ++j) {
+        if (res[j]) {
+          res1[j] = res[j] + c*f_.nnz_out(j);
+        } else if (j<n_accum_) {
+          res1[j] = w + w_acc_[j] + (k%2)*f_.nnz_out(j);
+        } else {
+          res1[j] = nullptr;
+        }
+      }
+      // Seeds flow into the accumulators of the previous step
+      for (casadi_int j=0; j<n_accum_; ++j) {
+        if (k==0) {
+          arg1[j] = arg[j];
+        } else if (res[j]) {
+          arg1[j] = res[j] + col(k-1)*f_.nnz_out(j);
+        } else {
+          arg1[j] = w + w_acc_[j] + ((k-1)%2)*f_.nnz_out(j);
+        }
+      }
+      if (f_.rev(arg1, res1, iw, w + w_acc_.back())) return 1;
+    }
+    return 0;
+  }
+
+  void MapAccum::codegen_declarations(CodeGenerator& g) const {
+    g.add_dependency(f_);
+  }
+
+  void MapAccum::codegen_body(CodeGenerator& g) const {
+    g.local("i", "casadi_int");
+    g.local("arg1", "const casadi_real*", "*");
+    g.local("res1", "casadi_real*", "*");
+
+    // Column evaluated in iteration i
+    std::string c = reverse_ ? "(" + str(n_-1) + "-i)" : "i";
+
+    // Initial accumulators
+    g << "arg1 = arg+" << n_in_ << ";\n"
+      << "res1 = res+" << n_out_ << ";\n";
+    for (casadi_int j=0; j<n_accum_; ++j) g << "arg1[" << j << "]=arg[" << j << "];\n";
+    g << "for (i=0; i<" << n_ << "; ++i) {\n";
+    // Input and output buffers of this iteration
+    for (casadi_int j=n_accum_; j<n_in_; ++j) {
+      g << "arg1[" << j << "]=arg[" << j << "] ? arg[" << j << "]+"
+        << c << "*" << f_.nnz_in(j) << " : 0;\n";
+    }
+    for (casadi_int j=0; j<n_out_; ++j) {
+      g << "res1[" << j << "]=res[" << j << "] ? res[" << j << "]+"
+        << c << "*" << f_.nnz_out(j) << " : ";
+      if (j<n_accum_) {
+        g << "w+" << w_acc_[j] << "+(i%2)*" << f_.nnz_out(j) << ";\n";
+      } else {
+        g << "0;\n";
+      }
+    }
+    // Evaluate
+    std::string flag = g(f_, "arg1", "res1", "iw", "w+" + str(w_acc_.back()));
+    g << "if (" << flag << ") return 1;\n";
+    // Outputs of this iteration are the accumulators of the next
+    for (casadi_int j=0; j<n_accum_; ++j) g << "arg1[" << j << "]=res1[" << j << "];\n";
+    g << "}\n";
+  }
+
+  MX MapAccum::acc_in(casadi_int i, const MX& x0, const MX& x) const {
+    if (n_==1) return x0;
+    casadi_int sz = f_.size2_in(i);
+    if (reverse_) {
+      return horzcat(x(Slice(), range(sz, n_*sz)), x0); // NOLINT
+    } else {
+      return horzcat(x0, x(Slice(), range((n_-1)*sz))); // NOLINT
+    }
+  }
+
+  Function MapAccum
+  ::get_forward(casadi_int nfwd, const std::string& name,
+                const std::vector<std::string>& inames,
+                const std::vector<std::string>& onames,
+                const Dict& opts) const {
+    // Derivative of a single step, with the accumulated seeds moved first
+    Function df = f_.forward(nfwd);
+    std::vector<MX> df_arg = df.mx_in();
+    std::vector<MX> h_arg(df_arg.begin()+n_in_+n_out_, df_arg.begin()+n_in_+n_out_+n_accum_);
+    h_arg.insert(h_arg.end(), df_arg.begin(), df_arg.begin()+n_in_+n_out_);
+    h_arg.insert(h_arg.end(), df_arg.begin()+n_in_+n_out_+n_accum_, df_arg.end());
+    Function h(df.name() + "_acc", h_arg, df(df_arg));
+
+    // Chain the tangents of the accumulators, in the same direction
+    Function dm = MapAccum::create("mapaccum" + str(n_) + "_" + h.name(), h, n_, n_accum_,
+      reverse_);
+
+    // Input expressions
+    std::vector<MX> arg;
+    for (casadi_int i=0; i<n_in_; ++i) arg.push_back(MX::sym(inames.at(i), sparsity_in(i)));
+    for (casadi_int i=0; i<n_out_; ++i) {
+      arg.push_back(MX::sym(inames.at(n_in_+i), sparsity_out(i)));
+    }
+    for (casadi_int i=0; i<n_in_; ++i) {
+      arg.push_back(MX::sym(inames.at(n_in_+n_out_+i), repmat(sparsity_in(i), 1, nfwd)));
+    }
+
+    // Accumulated seeds, then the nominal inputs and outputs of every step
+    std::vector<MX> res(arg.begin()+n_in_+n_out_, arg.begin()+n_in_+n_out_+n_accum_);
+    for (casadi_int i=0; i<n_in_; ++i) {
+      res.push_back(i<n_accum_ ? acc_in(i, arg[i], arg[n_in_+i]) : arg[i]);
+    }
+    res.insert(res.end(), arg.begin()+n_in_, arg.begin()+n_in_+n_out_);
+
+    // Need to reorder the remaining sensitivity inputs, unless a single direction
+    std::vector<casadi_int> ind;
+    for (casadi_int i=n_accum_; i<n_in_; ++i) {
+      if (nfwd==1) {
+        res.push_back(arg[n_in_+n_out_+i]);
+        continue;
+      }
+      casadi_int sz = f_.size2_in(i);
+      ind.clear();
+      for (casadi_int k=0; k<n_; ++k) {
+        for (casadi_int d=0; d<nfwd; ++d) {
+          for (casadi_int j=0; j<sz; ++j) {
+            ind.push_back((d*n_ + k)*sz + j);
+          }
+        }
+      }
+      res.push_back(arg[n_in_+n_out_+i](Slice(), ind)); // NOLINT
+    }
+
+    // Get output expressions
+    res = dm(res);
+
+    // Reorder sensitivity outputs
+    for (casadi_int i=0; i<n_out_ && nfwd>1; ++i) {
+      casadi_int sz = f_.size2_out(i);
+      ind.clear();
+      for (casadi_int d=0; d<nfwd; ++d) {
+        for (casadi_int k=0; k<n_; ++k) {
+          for (casadi_int j=0; j<sz; ++j) {
+            ind.push_back((k*nfwd + d)*sz + j);
+          }
+        }
+      }
+      res[i] = res[i](Slice(), ind); // NOLINT
+    }
+
+    Dict options = opts;
+    options["allow_duplicate_io_names"] = true;
+
+    // Construct return function
+    return Function(name, arg, res, inames, onames, options);
+  }
+
+  Function MapAccum
+  ::get_reverse(casadi_int nadj, const std::string& name,
+                const std::vector<std::string>& inames,
+                const std::vector<std::string>& onames,
+                const Dict& opts) const {
+    // Derivative of a single step, with the adjoints of the accumulators added to the seeds
+    Function df = f_.reverse(nadj);
+    std::vector<MX> df_arg = df.mx_in();
+    std::vector<MX> h_arg, seed = df_arg;
+    for (casadi_int i=0; i<n_accum_; ++i) {
+      MX& s = seed[n_in_+n_out_+i];
+      h_arg.push_back(MX::sym("adj_" + f_.name_in(i), s.sparsity()));
+      s += h_arg.back();
+    }
+    h_arg.insert(h_arg.end(), df_arg.begin(), df_arg.end());
+    Function h(df.name() + "_acc", h_arg, df(seed));
+
+    // Chain the adjoints of the accumulators, in the opposite direction
+    Function dm = MapAccum::create("mapaccum" + str(n_) + "_" + h.name(), h, n_, n_accum_,
+      !reverse_);
+
+    // Input expressions
+    std::vector<MX> arg;
+    for (casadi_int i=0; i<n_in_; ++i) arg.push_back(MX::sym(inames.at(i), sparsity_in(i)));
+    for (casadi_int i=0; i<n_out_; ++i) {
+      arg.push_back(MX::sym(inames.at(n_in_+i), sparsity_out(i)));
+    }
+    for (casadi_int i=0; i<n_out_; ++i) {
+      arg.push_back(MX::sym(inames.at(n_in_+n_out_+i), repmat(sparsity_out(i), 1, nadj)));
+    }
+
+    // No adjoints beyond the last step, then the nominal inputs and outputs of every step
+    std::vector<MX> res;
+    for (casadi_int i=0; i<n_accum_; ++i) res.push_back(MX::zeros(dm.sparsity_in(i)));
+    for (casadi_int i=0; i<n_in_; ++i) {
+      res.push_back(i<n_accum_ ? acc_in(i, arg[i], arg[n_in_+i]) : arg[i]);
+    }
+    res.insert(res.end(), arg.begin()+n_in_, arg.begin()+n_in_+n_out_);
+
+    // Need to reorder sensitivity inputs, unless a single direction
+    std::vector<casadi_int> ind;
+    for (casadi_int i=0; i<n_out_; ++i) {
+      if (nadj==1) {
+        res.push_back(arg[n_in_+n_out_+i]);
+        continue;
+      }
+      casadi_int sz = f_.size2_out(i);
+      ind.clear();
+      for (casadi_int k=0; k<n_; ++k) {
+        for (casadi_int d=0; d<nadj; ++d) {
+          for (casadi_int j=0; j<sz; ++j) {
+            ind.push_back((d*n_ + k)*sz + j);
+          }
+        }
+      }
+      res.push_back(arg[n_in_+n_out_+i](Slice(), ind)); // NOLINT
+    }
+
+    // Get output expressions
+    res = dm(res);
+
+    // Adjoints of the initial accumulators are those after the last step
+    casadi_int c = col(0);
+    for (casadi_int i=0; i<n_accum_; ++i) {
+      casadi_int sz = f_.size2_in(i)*nadj;
+      res[i] = res[i](Slice(), range(c*sz, (c+1)*sz)); // NOLINT
+    }
+
+    // Reorder the remaining sensitivity outputs
+    for (casadi_int i=n_accum_; i<n_in_ && nadj>1; ++i) {
+      casadi_int sz = f_.size2_in(i);
+      ind.clear();
+      for (casadi_int d=0; d<nadj; ++d) {
+        for (casadi_int k=0; k<n_; ++k) {
+          for (casadi_int j=0; j<sz; ++j) {
+            ind.push_back((k*nadj + d)*sz + j);
+          }
+        }
+      }
+      res[i] = res[i](Slice(), ind); // NOLINT
+    }
+
+    Dict options = opts;
+    options["allow_duplicate_io_names"] = true;
+
+    // Construct return function
+    return Function(name, arg, res, inames, onames, options);
+  }
+
+} // namespace casadi
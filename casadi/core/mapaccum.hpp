@@ -0,0 +1,210 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#ifndef CASADI_MAPACCUM_HPP
+#define CASADI_MAPACCUM_HPP
+
+#include "function_internal.hpp"
+
+/// \cond INTERNAL
+
+namespace casadi {
+
+  /** Evaluate a function repeatedly, feeding the first outputs back as inputs
+
+      Signature and semantics are those of Function::mapaccum, but the body is
+      evaluated in a loop with the accumulators passed by pointer, instead of
+      being unrolled in an MX graph.
+  */
+  class CASADI_EXPORT MapAccum : public FunctionInternal {
+  public:
+    // Create function (use instead of constructor)
+    static Function create(const std::string& name, const Function& f, casadi_int n,
+                           casadi_int n_accum, bool reverse=false, const Dict& opts=Dict());
+
+    // Can f be chained by MapAccum (accumulated inputs and outputs with matching sparsity)
+    static bool is_chainable(const Function& f, casadi_int n_accum);
+
+    /** \brief Destructor */
+    ~MapAccum() override;
+
+    /** \brief Get type name */
+    std::string class_name() const override {return "MapAccum";}
+
+    /** \brief Check if the function is of a particular type */
+    bool is_a(const std::string& type, bool recursive) const override;
+
+    /// @{
+    /** \brief Sparsities of function inputs and outputs */
+    Sparsity get_sparsity_in(casadi_int i) override {
+      return repmat(f_.sparsity_in(i), 1, i<n_accum_ ? 1 : n_);
+    }
+    Sparsity get_sparsity_out(casadi_int i) override {
+      return repmat(f_.sparsity_out(i), 1, n_);
+    }
+    /// @}
+
+    /** \brief Get default input value */
+    double get_default_in(casadi_int ind) const override { return f_.default_in(ind);}
+
+    ///@{
+    /** \brief Number of function inputs and outputs */
+    size_t get_n_in() override { return f_.n_in();}
+    size_t get_n_out() override { return f_.n_out();}
+    ///@}
+
+    ///@{
+    /** \brief Names of function input and outputs */
+    std::string get_name_in(casadi_int i) override { return f_.name_in(i);}
+    std::string get_name_out(casadi_int i) override { return f_.name_out(i);}
+    /// @}
+
+    /** \brief  Evaluate or propagate sparsities */
+    template<typename T>
+    int eval_gen(const T** arg, T** res, casadi_int* iw, T* w, int mem=0) const;
+
+    /// Evaluate the function numerically
+    int eval(const double** arg, double** res, casadi_int* iw, double* w, void* mem) const override;
+
+    /** \brief  evaluate symbolically while also propagating directional derivatives */
+    int eval_sx(const SXElem** arg, SXElem** res,
+                casadi_int* iw, SXElem* w, void* mem,
+                bool always_inline, bool never_inline) const override;
+
+    /** \brief  Propagate sparsity forward */
+    int sp_forward(const bvec_t** arg, bvec_t** res,
+                    casadi_int* iw, bvec_t* w, void* mem) const override;
+
+    /** \brief  Propagate sparsity backwards */
+    int sp_reverse(bvec_t** arg, bvec_t** res, casadi_int* iw, bvec_t* w, void* mem) const override;
+
+    ///@{
+    /// Is the class able to propagate seeds through the algorithm?
+    bool has_spfwd() const override { return true;}
+    bool has_sprev() const override { return true;}
+    ///@}
+
+    /** \brief Is codegen supported? */
+    bool has_codegen() const override { return true;}
+
+    /** \brief Generate code for the declarations of the C function */
+    void codegen_declarations(CodeGenerator& g) const override;
+
+    /** \brief Generate code for the body of the C function */
+    void codegen_body(CodeGenerator& g) const override;
+
+    /** \brief  Initialize */
+    void init(const Dict& opts) override;
+
+    // Get list of dependency functions
+    std::vector<std::string> get_function() const override;
+
+    // Get a dependency function
+    const Function& get_function(const std::string &name) const override;
+
+    // Get all embedded functions, recursively
+    void find(std::map<FunctionInternal*, std::pair<Function, size_t> >& all_fun,
+        casadi_int max_depth) const override;
+
+    // Check if a particular dependency exists
+    bool has_function(const std::string& fname) const override;
+
+    ///@{
+    /** \brief Generate a function that calculates \a nfwd forward derivatives
+
+        The tangents of the accumulators are chained by a MapAccum running
+        in the same direction, evaluated around the nominal states.
+    */
+    bool has_forward(casadi_int nfwd) const override { return true;}
+    Function get_forward(casadi_int nfwd, const std::string& name,
+                         const std::vector<std::string>& inames,
+                         const std::vector<std::string>& onames,
+                         const Dict& opts) const override;
+    ///@}
+
+    ///@{
+    /** \brief Generate a function that calculates \a nadj adjoint derivatives
+
+        The adjoints of the accumulators are chained by a MapAccum running
+        in the opposite direction, evaluated around the nominal states.
+    */
+    bool has_reverse(casadi_int nadj) const override { return true;}
+    Function get_reverse(casadi_int nadj, const std::string& name,
+                         const std::vector<std::string>& inames,
+                         const std::vector<std::string>& onames,
+                         const Dict& opts) const override;
+    ///@}
+
+    /** Obtain information about node */
+    Dict info() const override {
+      return {{"f", f_}, {"n", n_}, {"n_accum", n_accum_}, {"reverse", reverse_}};
+    }
+
+    /** \brief Serialize an object without type information */
+    void serialize_body(SerializingStream &s) const override;
+
+    /** \brief Serialize type information */
+    void serialize_type(SerializingStream &s) const override;
+
+    /** \brief String used to identify the immediate FunctionInternal subclass */
+    std::string serialize_base_function() const override { return "MapAccum"; }
+
+    /** \brief Deserialize with type disambiguation */
+    static ProtoFunction* deserialize(DeserializingStream& s);
+
+  protected:
+    /** \brief Deserializing constructor */
+    explicit MapAccum(DeserializingStream& s);
+
+    // Constructor (protected, use create function)
+    MapAccum(const std::string& name, const Function& f, casadi_int n,
+             casadi_int n_accum, bool reverse);
+
+    // Column evaluated in step k
+    casadi_int col(casadi_int k) const { return reverse_ ? n_-1-k : k;}
+
+    // Nominal accumulator inputs of every step, as horzcat over the columns
+    MX acc_in(casadi_int i, const MX& x0, const MX& x) const;
+
+    // The function which is to be evaluated repeatedly
+    Function f_;
+
+    // Number of times to evaluate this function
+    casadi_int n_;
+
+    // Number of accumulated inputs and outputs
+    casadi_int n_accum_;
+
+    // Iterate from the last column to the first
+    bool reverse_;
+
+    // Offsets of the double buffers of the accumulators in the work vector
+    std::vector<casadi_int> w_acc_;
+  };
+
+} // namespace casadi
+/// \endcond
+
+#endif // CASADI_MAPACCUM_HPP
@@ -38,12 +38,17 @@ namespace casadi {
     casadi_assert(reduce_in.size()==f.n_in(), "Dimension mismatch");
     casadi_assert(reduce_out.size()==f.n_out(), "Dimension mismatch");
 
-    if (parallelization == "serial") {
+    if (parallelization == "serial" || parallelization == "openmp") {
       std::string suffix = str(reduce_in)+str(reduce_out);
+      if (parallelization != "serial") suffix += parallelization;
       Function ret;
       if (!f->incache(name, ret, suffix)) {
-        // Create new serial map
-        ret = Function::create(new MapSum(name, f, n, reduce_in, reduce_out), opts);
+        // Create new map
+        if (parallelization == "serial") {
+          ret = Function::create(new MapSum(name, f, n, reduce_in, reduce_out), opts);
+        } else {
+          ret = Function::create(new OmpMapSum(name, f, n, reduce_in, reduce_out), opts);
+        }
         casadi_assert_dev(ret.name()==name);
         // Save in cache
         f->tocache_if_missing(ret, suffix);
@@ -87,6 +92,8 @@ namespace casadi {
     s.unpack("MapSum::class_name", class_name);
     if (class_name=="MapSum") {
       return new MapSum(s);
+    } else if (class_name=="OmpMapSum") {
+      return new OmpMapSum(s);
     } else {
       casadi_error("class name '" + class_name + "' unknown.");
     }
@@ -152,7 +159,8 @@ namespace casadi {
   }
 
   template<typename T>
-  int MapSum::eval_gen(const T** arg, T** res, casadi_int* iw, T* w, int mem) const {
+  int MapSum::eval_block(const T** arg, T** res, casadi_int* iw, T* w, int mem,
+      casadi_int n) const {
     const T** arg1 = arg+n_in_;
     std::copy_n(arg, n_in_, arg1);
     T** res1 = res+n_out_;
@@ -167,7 +175,7 @@ namespace casadi {
         res1[j] = res[j];
       }
     }
-    for (casadi_int i=0; i<n_; ++i) {
+    for (casadi_int i=0; i<n; ++i) {
       if (f_(arg1, res1, iw, w, mem)) return 1;
       for (casadi_int j=0; j<n_in_; ++j) {
         if (arg1[j] && !reduce_in_[j]) arg1[j] += f_.nnz_in(j);
@@ -423,4 +431,227 @@ namespace casadi {
     return eval_gen(arg, res, iw, w, m);
   }
 
+  const casadi_int OmpMapSum::max_n_block;
+
+  OmpMapSum::~OmpMapSum() {
+    clear_mem();
+  }
+
+  void OmpMapSum::init(const Dict& opts) {
+#ifndef WITH_OPENMP
+    casadi_warning("CasADi was not compiled with WITH_OPENMP=ON. "
+                   "Falling back to serial evaluation.");
+#endif // WITH_OPENMP
+    // Call the initialization method of the base class
+    MapSum::init(opts);
+
+    // Block partitioning
+    init_blocks();
+
+    // Allocate memory for holding memory object references
+    alloc_iw(n_block_, true);
+
+    // Allocate sufficient memory for parallel evaluation
+    alloc_arg(sz_arg_block_ * n_block_);
+    alloc_res(sz_res_block_ * n_block_);
+    alloc_iw(sz_iw_block_ * n_block_);
+    alloc_w((sz_w_block_ + nnz_reduced_) * n_block_);
+  }
+
+  OmpMapSum::OmpMapSum(DeserializingStream& s) : MapSum(s) {
+    init_blocks();
+  }
+
+  void OmpMapSum::init_blocks() {
+    // Nonzeros of the reduced outputs
+    nnz_reduced_ = 0;
+    for (casadi_int j=0; j<n_out_; ++j) {
+      if (reduce_out_[j]) nnz_reduced_ += f_.nnz_out(j);
+    }
+
+    // Work vectors for each block, as in serial evaluation
+    sz_arg_block_ = n_in_ + f_.sz_arg();
+    sz_res_block_ = n_out_ + f_.sz_res();
+    sz_iw_block_ = f_.sz_iw();
+    sz_w_block_ = f_.sz_w() + nnz_reduced_;
+
+    // The number of blocks only depends on n_ and f_, never on the number of threads
+    n_block_ = std::min(n_, max_n_block);
+    // Limit the memory used for partial sums to about 32 MB
+    casadi_int max_sz = 1 << 22;
+    n_block_ = std::max(casadi_int(1),
+      std::min(n_block_, max_sz / (sz_w_block_ + nnz_reduced_ + 1)));
+  }
+
+  int OmpMapSum::eval(const double** arg, double** res, casadi_int* iw, double* w,
+      void* mem) const {
+#ifndef WITH_OPENMP
+    return MapSum::eval(arg, res, iw, w, mem);
+#else // WITH_OPENMP
+    setup(mem, arg, res, iw, w);
+
+    // Error flag
+    casadi_int flag = 0;
+
+    // Checkout memory objects
+    std::vector< scoped_checkout<Function> > ind; ind.reserve(n_block_);
+    for (casadi_int b=0; b<n_block_; ++b) ind.emplace_back(f_);
+
+    // Partial sums, one per block
+    double* acc = w + n_block_ * sz_w_block_;
+
+    // Evaluate blocks in parallel
+#pragma omp parallel for reduction(||:flag)
+    for (casadi_int b=0; b<n_block_; ++b) {
+      // Range of calls
+      casadi_int i0 = (b * n_) / n_block_, i1 = ((b + 1) * n_) / n_block_;
+
+      // Input buffers
+      const double** arg1 = arg + n_in_ + b * sz_arg_block_;
+      for (casadi_int j=0; j<n_in_; ++j) {
+        arg1[j] = arg[j] && !reduce_in_[j] ? arg[j] + i0*f_.nnz_in(j) : arg[j];
+      }
+
+      // Output buffers, reduced outputs go to the partial sums
+      double** res1 = res + n_out_ + b * sz_res_block_;
+      double* acc1 = acc + b * nnz_reduced_;
+      casadi_clear(acc1, nnz_reduced_);
+      for (casadi_int j=0; j<n_out_; ++j) {
+        if (reduce_out_[j]) {
+          res1[j] = res[j] ? acc1 : nullptr;
+          acc1 += f_.nnz_out(j);
+        } else {
+          res1[j] = res[j] ? res[j] + i0*f_.nnz_out(j) : nullptr;
+        }
+      }
+
+      // Evaluation
+      try {
+        flag = eval_block(arg1, res1, iw + b * sz_iw_block_, w + b * sz_w_block_,
+          ind[b], i1 - i0) || flag;
+      } catch (std::exception& e) {
+        flag = 1;
+        casadi_warning("Exception raised: " + std::string(e.what()));
+      } catch (...) {
+        flag = 1;
+        casadi_warning("Uncaught exception.");
+      }
+    }
+    if (flag) return 1;
+
+    // Pairwise reduction of the partial sums in a fixed order
+    for (casadi_int s=1; s<n_block_; s*=2) {
+      for (casadi_int b=0; b+s<n_block_; b+=2*s) {
+        casadi_add(nnz_reduced_, acc + (b + s) * nnz_reduced_, acc + b * nnz_reduced_);
+      }
+    }
+
+    // Copy to the reduced outputs
+    for (casadi_int j=0; j<n_out_; ++j) {
+      if (reduce_out_[j]) {
+        casadi_copy(acc, f_.nnz_out(j), res[j]);
+        acc += f_.nnz_out(j);
+      }
+    }
+    return 0;
+#endif  // WITH_OPENMP
+  }
+
+  void OmpMapSum::codegen_body(CodeGenerator& g) const {
+    std::string priv_vars = "";
+    if (f_->codegen_needs_mem()) {
+      g.local("flag", "int");
+      g.local("mid", "int");
+      priv_vars = ",mid,flag";
+    }
+
+    g.local("b", "casadi_int");
+    g.local("i", "casadi_int");
+    g.local("i1", "casadi_int");
+    g.local("arg1", "const casadi_real*", "*");
+    g.local("res1", "casadi_real*", "*");
+    g.local("w1", "casadi_real", "*");
+    g.local("acc1", "casadi_real", "*");
+    g.local("cflag", "casadi_int");
+    g.init_local("cflag", "0");
+
+    // Partial sums, one per block
+    std::string acc = "w+" + str(n_block_ * sz_w_block_);
+
+    // Offsets of the reduced outputs in the partial sums
+    std::vector<casadi_int> offset(n_out_, 0);
+    for (casadi_int j=0, k=0; j<n_out_; ++j) {
+      offset[j] = k;
+      if (reduce_out_[j]) k += f_.nnz_out(j);
+    }
+
+    // Evaluate blocks in parallel
+    g << "#pragma omp parallel for private(b,i,i1,arg1,res1,w1,acc1" << priv_vars
+      << ") reduction(||:cflag)\n"
+      << "for (b=0; b<" << n_block_ << "; ++b) {\n"
+      << "i = (b*" << n_ << ")/" << n_block_ << ";\n"
+      << "i1 = ((b+1)*" << n_ << ")/" << n_block_ << ";\n"
+      << "w1 = w+b*" << sz_w_block_ << ";\n"
+      << "acc1 = " << acc << "+b*" << nnz_reduced_ << ";\n";
+    if (nnz_reduced_ > 0) g << g.clear("acc1", nnz_reduced_) << "\n";
+    // Input buffers
+    g << "arg1 = arg+" << n_in_ << "+b*" << sz_arg_block_ << ";\n";
+    for (casadi_int j=0; j<n_in_; ++j) {
+      g << "arg1[" << j << "] = " << g.arg(j);
+      if (!reduce_in_[j]) g << " ? " << g.arg(j) << "+i*" << f_.nnz_in(j) << " : 0";
+      g << ";\n";
+    }
+    // Output buffers, reduced outputs are written to scratch space
+    g << "res1 = res+" << n_out_ << "+b*" << sz_res_block_ << ";\n";
+    for (casadi_int j=0; j<n_out_; ++j) {
+      if (reduce_out_[j]) {
+        g << "res1[" << j << "] = " << g.res(j) << " ? w1+" << f_.sz_w() + offset[j]
+          << " : 0;\n";
+      } else {
+        g << "res1[" << j << "] = " << g.res(j) << " ? "
+          << g.res(j) << "+i*" << f_.nnz_out(j) << " : 0;\n";
+      }
+    }
+    g << "for (; i<i1; ++i) {\n";
+    // Evaluate
+    std::string flag = g(f_, "arg1", "res1", "iw+b*" + str(sz_iw_block_), "w1", "");
+    g << "if (" << flag << ") cflag = 1;\n";
+    // Update input buffers
+    for (casadi_int j=0; j<n_in_; ++j) {
+      if (!reduce_in_[j] && f_.nnz_in(j)) {
+        g << "if (arg1[" << j << "]) arg1[" << j << "]+=" << f_.nnz_in(j) << ";\n";
+      }
+    }
+    // Update output buffers
+    for (casadi_int j=0; j<n_out_; ++j) {
+      if (reduce_out_[j]) {
+        g << "if (res1[" << j << "]) "
+          << g.axpy(f_.nnz_out(j), "1.0", "res1[" + str(j) + "]",
+                    "acc1+" + str(offset[j])) << "\n";
+      } else if (f_.nnz_out(j)) {
+        g << "if (res1[" << j << "]) res1[" << j << "]+=" << f_.nnz_out(j) << ";\n";
+      }
+    }
+    g << "}\n";
+    g << "}\n";
+    g << "if (cflag) return 1;\n";
+
+    // Pairwise reduction of the partial sums in a fixed order
+    if (n_block_ > 1 && nnz_reduced_ > 0) {
+      g << "for (i=1; i<" << n_block_ << "; i*=2) {\n"
+        << "for (b=0; b+i<" << n_block_ << "; b+=2*i) {\n"
+        << g.axpy(nnz_reduced_, "1.0", acc + "+(b+i)*" + str(nnz_reduced_),
+                  acc + "+b*" + str(nnz_reduced_)) << "\n"
+        << "}\n"
+        << "}\n";
+    }
+
+    // Copy to the reduced outputs
+    for (casadi_int j=0; j<n_out_; ++j) {
+      if (reduce_out_[j]) {
+        g << g.copy(acc + "+" + str(offset[j]), f_.nnz_out(j), g.res(j)) << "\n";
+      }
+    }
+  }
+
 } // namespace casadi
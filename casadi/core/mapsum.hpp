@@ -102,7 +102,13 @@ namespace casadi {
 
         \identifier{4x} */
     template<typename T>
-    int eval_gen(const T** arg, T** res, casadi_int* iw, T* w, int mem=0) const;
+    int eval_gen(const T** arg, T** res, casadi_int* iw, T* w, int mem=0) const {
+      return eval_block(arg, res, iw, w, mem, n_);
+    }
+
+    /// Evaluate the first n calls, accumulating reduced outputs in res
+    template<typename T>
+    int eval_block(const T** arg, T** res, casadi_int* iw, T* w, int mem, casadi_int n) const;
 
     /// Evaluate the function numerically
     int eval(const double** arg, double** res, casadi_int* iw, double* w, void* mem) const override;
@@ -234,6 +240,60 @@ namespace casadi {
     std::vector<bool> reduce_out_;
   };
 
+  /** MapSum evaluated in parallel using OpenMP
+
+      The calls are split into a fixed number of contiguous blocks, each with
+      its own work vectors and partial sums for the reduced outputs. The partial
+      sums are combined with a pairwise tree in a fixed order, so the result is
+      bitwise identical regardless of the number of threads.
+  */
+  class CASADI_EXPORT OmpMapSum : public MapSum {
+    friend class MapSum;
+  public:
+    /** \brief  Destructor */
+    ~OmpMapSum() override;
+
+    /** \brief Get type name */
+    std::string class_name() const override {return "OmpMapSum";}
+
+    /// Evaluate the function numerically
+    int eval(const double** arg, double** res, casadi_int* iw, double* w, void* mem) const override;
+
+    /** \brief  Initialize */
+    void init(const Dict& opts) override;
+
+    /// Type of parallellization
+    std::string parallelization() const override { return "openmp"; }
+
+    /** \brief Generate code for the body of the C function */
+    void codegen_body(CodeGenerator& g) const override;
+
+    /// Upper bound on the number of blocks
+    static const casadi_int max_n_block = 64;
+
+  protected:
+    // Constructor (protected, use create function in MapSum)
+    OmpMapSum(const std::string& name, const Function& f, casadi_int n,
+              const std::vector<bool>& reduce_in,
+              const std::vector<bool>& reduce_out)
+      : MapSum(name, f, n, reduce_in, reduce_out) {}
+
+    /** \brief Deserializing constructor */
+    explicit OmpMapSum(DeserializingStream& s);
+
+    // Set up the block partitioning, also after deserialization
+    void init_blocks();
+
+    // Number of blocks
+    casadi_int n_block_;
+
+    // Total number of nonzeros in the reduced outputs
+    casadi_int nnz_reduced_;
+
+    // Length of arg, res, iw and w for each block
+    casadi_int sz_arg_block_, sz_res_block_, sz_iw_block_, sz_w_block_;
+  };
+
 
 } // namespace casadi
 /// \endcond
@@ -55,6 +55,41 @@ namespace casadi {
       \identifier{18c} */
   struct CASADI_EXPORT MatrixCommon {};
 
+#ifndef SWIG
+  /** \brief Non-owning view of a range of nonzeros of a Matrix
+
+      Gives access to e.g. the nonzeros of a column without copying.
+      The view is invalidated by any assignment to the matrix, including an
+      in-place operator (+=, ...) that falls back to the out-of-place operation,
+      even if the sparsity pattern stays the same. */
+  template<typename T>
+  class NonzeroView {
+  public:
+    /// Constructor
+    NonzeroView(T* data, const casadi_int* row, casadi_int n) : data_(data), row_(row), n_(n) {}
+
+    /// Number of nonzeros
+    casadi_int size() const { return n_;}
+
+    /// Access nonzero k
+    T& operator[](casadi_int k) const { return data_[k];}
+
+    /// Row of nonzero k
+    casadi_int row(casadi_int k) const { return row_[k];}
+
+    ///@{
+    /// Iterate over the nonzeros
+    T* begin() const { return data_;}
+    T* end() const { return data_ + n_;}
+    ///@}
+
+  private:
+    T* data_;
+    const casadi_int* row_;
+    casadi_int n_;
+  };
+#endif // SWIG
+
 /// \cond CLUTTER
   ///@{
   /** \brief Get typename
@@ -537,6 +572,11 @@ namespace casadi {
                                    std::vector< Matrix<Scalar> >& res,
                                    const Dict& opts = Dict());
 
+    // Simplification by algebraic identities
+    static bool simplify_algebraic(std::vector< Matrix<Scalar> >& arg,
+                                   std::vector< Matrix<Scalar> >& res,
+                                   const Dict& opts = Dict());
+
     /// \endcond
 #endif // SWIG
 
@@ -1035,6 +1075,31 @@ namespace casadi {
     /// Const access the sparsity - reference to data member
     const Sparsity& sparsity() const;
 
+    ///@{
+    /// Non-owning view of the nonzeros of a column
+    NonzeroView<Scalar> col_view(casadi_int j);
+    NonzeroView<const Scalar> col_view(casadi_int j) const;
+    ///@}
+
+    ///@{
+    /// Non-owning view of the nonzeros with indices k_begin, ..., k_end-1
+    NonzeroView<Scalar> nz_view(casadi_int k_begin, casadi_int k_end);
+    NonzeroView<const Scalar> nz_view(casadi_int k_begin, casadi_int k_end) const;
+    ///@}
+
+    ///@{
+    /** \brief In-place elementwise operations
+
+        The nonzeros are updated in place when the sparsity pattern of the result
+        equals that of the matrix. Otherwise, the result is assigned as for x = x + y,
+        which invalidates any NonzeroView of the matrix. */
+    Matrix<Scalar>& operator+=(const Matrix<Scalar>& y) { return binary_inplace(OP_ADD, y);}
+    Matrix<Scalar>& operator-=(const Matrix<Scalar>& y) { return binary_inplace(OP_SUB, y);}
+    Matrix<Scalar>& operator*=(const Matrix<Scalar>& y) { return binary_inplace(OP_MUL, y);}
+    Matrix<Scalar>& operator/=(const Matrix<Scalar>& y) { return binary_inplace(OP_DIV, y);}
+    Matrix<Scalar>& binary_inplace(casadi_int op, const Matrix<Scalar>& y);
+    ///@}
+
 #endif // SWIG
 
     /** \brief Get an owning reference to the sparsity pattern
@@ -1152,6 +1152,65 @@ namespace casadi {
     return nonzeros_.empty() ? nullptr : &nonzeros_.front();
   }
 
+  template<typename Scalar>
+  NonzeroView<Scalar> Matrix<Scalar>::col_view(casadi_int j) {
+    casadi_assert_dev(j>=0 && j<size2());
+    const casadi_int* colind = sparsity().colind();
+    return NonzeroView<Scalar>(ptr() + colind[j], sparsity().row() + colind[j],
+                               colind[j+1] - colind[j]);
+  }
+
+  template<typename Scalar>
+  NonzeroView<const Scalar> Matrix<Scalar>::col_view(casadi_int j) const {
+    casadi_assert_dev(j>=0 && j<size2());
+    const casadi_int* colind = sparsity().colind();
+    return NonzeroView<const Scalar>(ptr() + colind[j], sparsity().row() + colind[j],
+                                     colind[j+1] - colind[j]);
+  }
+
+  template<typename Scalar>
+  NonzeroView<Scalar> Matrix<Scalar>::nz_view(casadi_int k_begin, casadi_int k_end) {
+    casadi_assert_dev(k_begin>=0 && k_begin<=k_end && k_end<=nnz());
+    return NonzeroView<Scalar>(ptr() + k_begin, sparsity().row() + k_begin, k_end - k_begin);
+  }
+
+  template<typename Scalar>
+  NonzeroView<const Scalar> Matrix<Scalar>::nz_view(casadi_int k_begin, casadi_int k_end) const {
+    casadi_assert_dev(k_begin>=0 && k_begin<=k_end && k_end<=nnz());
+    return NonzeroView<const Scalar>(ptr() + k_begin, sparsity().row() + k_begin,
+                                     k_end - k_begin);
+  }
+
+  template<typename Scalar>
+  Matrix<Scalar>& Matrix<Scalar>::binary_inplace(casadi_int op, const Matrix<Scalar>& y) {
+    // Same cases as binary(op, *this, y); a scalar left-hand side always falls back
+    if (!is_scalar() && y.is_scalar()) {
+      // Matrix-scalar: in place unless structural zeros change
+      if (!(operation_checker<FX0Checker>(op) && y.nnz()==0)
+          && (is_dense() || operation_checker<F0XChecker>(op))) {
+        Scalar y_val = y.nnz()==0 ? casadi_limits<Scalar>::zero : y->front();
+        for (Scalar& e : nonzeros_) casadi_math<Scalar>::fun(op, e, y_val, e);
+        return *this;
+      }
+    } else if (!is_scalar() && size()==y.size()) {
+      // Matrix-matrix: in place if the result has the sparsity pattern of this
+      bool f00 = is_dense() || operation_checker<F00Checker>(op);
+      if (sparsity()==y.sparsity() && f00) {
+        casadi_math<Scalar>::fun(op, ptr(), y.ptr(), ptr(), nnz());
+        return *this;
+      }
+      Sparsity r_sp = sparsity().combine(y.sparsity(), operation_checker<F0XChecker>(op),
+                                         operation_checker<FX0Checker>(op));
+      if (r_sp==sparsity() && f00) {
+        Matrix<Scalar> y_mod = y(r_sp);
+        casadi_math<Scalar>::fun(op, ptr(), y_mod.ptr(), ptr(), nnz());
+        return *this;
+      }
+    }
+    // Fall back to the out-of-place operation
+    return *this = binary(op, *this, y);
+  }
+
   template<typename Scalar>
   Sparsity Matrix<Scalar>::get_sparsity() const {
     return sparsity();
@@ -2585,6 +2644,13 @@ namespace casadi {
     casadi_error("'simplify_combine_terms' not defined for " + type_name());
   }
 
+  template<typename Scalar>
+  bool Matrix<Scalar>::simplify_algebraic(std::vector< Matrix<Scalar> >& arg,
+                                   std::vector< Matrix<Scalar> >& res,
+                                   const Dict& opts) {
+    casadi_error("'simplify_algebraic' not defined for " + type_name());
+  }
+
   template<typename Scalar>
   Matrix<Scalar> Matrix<Scalar>::unite(const Matrix<Scalar>& A, const Matrix<Scalar>& B) {
     // Join the sparsity patterns
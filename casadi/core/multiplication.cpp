@@ -41,7 +41,144 @@ namespace casadi {
     if (auto* n = DenseMultiplication::try_create(z, x, y, blas))       return MX::create(n);
     if (auto* n = PseudoDenseMultiplication::try_create(z, x, y, blas)) return MX::create(n);
     if (auto* n = DenseSparseMultiplication::try_create(z, x, y, blas)) return MX::create(n);
-    return MX::create(new Multiplication(z, x, y, blas));
+    if (auto* n = BlockMultiplication::try_create(z, x, y, blas))       return MX::create(n);
+    Multiplication* n = new Multiplication(z, x, y, blas);
+    n->init_plan();
+    return MX::create(n);
+  }
+
+  void Multiplication::init_plan() {
+    const Sparsity& sp_x = dep(1).sparsity();
+    const Sparsity& sp_y = dep(2).sparsity();
+    const Sparsity& sp_z = sparsity();
+    const casadi_int *colind_x = sp_x.colind(), *row_x = sp_x.row();
+    const casadi_int *colind_y = sp_y.colind(), *row_y = sp_y.row();
+    const casadi_int *colind_z = sp_z.colind(), *row_z = sp_z.row();
+
+    // Same row pattern in two columns of a sparsity
+    auto same_col = [](const casadi_int* colind, const casadi_int* row,
+        casadi_int c1, casadi_int c2) {
+      return colind[c1+1]-colind[c1]==colind[c2+1]-colind[c2]
+        && std::equal(row+colind[c1], row+colind[c1+1], row+colind[c2]);
+    };
+
+    plan_ptr_.push_back(0);
+    plan_sz_w_ = 0;
+    // Nonzero index of z in the current column(s), or -1
+    std::vector<casadi_int> pos(sp_z.size1(), -1);
+    // Terms of each nonzero of z in the current column
+    std::vector<casadi_int> count(sp_z.size1());
+    for (casadi_int cc=0; cc<sp_z.size2(); ) {
+      // Run of columns with identical patterns in both y and z
+      casadi_int cc1 = cc+1;
+      while (cc1<sp_z.size2() && same_col(colind_z, row_z, cc, cc1)
+          && same_col(colind_y, row_y, cc, cc1)) cc1++;
+      for (casadi_int kk=colind_z[cc]; kk<colind_z[cc+1]; ++kk) {
+        pos[row_z[kk]] = kk-colind_z[cc];
+      }
+
+      // Try a dense sub-block, all products must be structurally nonzero: padding
+      // with zeros would turn an Inf or NaN in y into NaN where casadi_mtimes skips it
+      casadi_int m = colind_z[cc+1]-colind_z[cc], k = colind_y[cc+1]-colind_y[cc];
+      if (cc1-cc>1 && m>0 && k>0) {
+        std::vector<casadi_int> gather(m*k, -1);
+        casadi_int nz = 0;
+        for (casadi_int j=0; j<k; ++j) {
+          casadi_int rr = row_y[colind_y[cc]+j];
+          for (casadi_int kk1=colind_x[rr]; kk1<colind_x[rr+1]; ++kk1) {
+            casadi_int i = pos[row_x[kk1]];
+            if (i>=0) {
+              gather[i+j*m] = kk1;
+              nz++;
+            }
+          }
+        }
+        if (nz==m*k) {
+          plan_block_.insert(plan_block_.end(),
+            {colind_z[cc], colind_y[cc], m, k, cc1-cc,
+             static_cast<casadi_int>(plan_gather_.size())});
+          plan_gather_.insert(plan_gather_.end(), gather.begin(), gather.end());
+          plan_sz_w_ = std::max(plan_sz_w_, m*k);
+          for (casadi_int kk=colind_z[cc]; kk<colind_z[cc+1]; ++kk) pos[row_z[kk]] = -1;
+          cc = cc1;
+          continue;
+        }
+      }
+
+      // Individual products, column by column
+      for (; cc<cc1; ++cc) {
+        casadi_int z0 = colind_z[cc];
+        std::fill(count.begin(), count.begin()+m, 0);
+        for (casadi_int kk=colind_y[cc]; kk<colind_y[cc+1]; ++kk) {
+          casadi_int rr = row_y[kk];
+          for (casadi_int kk1=colind_x[rr]; kk1<colind_x[rr+1]; ++kk1) {
+            casadi_int i = pos[row_x[kk1]];
+            if (i>=0) count[i]++;
+          }
+        }
+        // Offsets, skipping nonzeros of z without terms
+        casadi_int offset = plan_x_.size();
+        for (casadi_int i=0; i<m; ++i) {
+          if (count[i]==0) continue;
+          plan_z_.push_back(z0+i);
+          plan_ptr_.push_back(plan_ptr_.back()+count[i]);
+          casadi_int n = count[i];
+          count[i] = offset;
+          offset += n;
+        }
+        // Terms, ordered by nonzero of z and within each by column of x
+        plan_x_.resize(offset);
+        plan_y_.resize(offset);
+        for (casadi_int kk=colind_y[cc]; kk<colind_y[cc+1]; ++kk) {
+          casadi_int rr = row_y[kk];
+          for (casadi_int kk1=colind_x[rr]; kk1<colind_x[rr+1]; ++kk1) {
+            casadi_int i = pos[row_x[kk1]];
+            if (i>=0) {
+              plan_x_[count[i]] = kk1;
+              plan_y_[count[i]] = kk;
+              count[i]++;
+            }
+          }
+        }
+      }
+      for (casadi_int kk=colind_z[cc1-1]; kk<colind_z[cc1]; ++kk) pos[row_z[kk]] = -1;
+    }
+
+    // Bound the memory spent on the plan
+    if (plan_x_.size() + plan_gather_.size()
+        > 8*(sp_x.nnz()+sp_y.nnz()+sp_z.nnz()) + 4096) {
+      plan_z_.clear();
+      plan_ptr_.clear();
+      plan_x_.clear();
+      plan_y_.clear();
+      plan_block_.clear();
+      plan_gather_.clear();
+    }
+  }
+
+  // Dense kernel of the product plan
+  static void plan_mtimes(casadi_int blas, const double* x, casadi_int m, casadi_int k,
+      const double* y, casadi_int n, double* z) {
+    Blas::mtimes(blas, x, m, k, y, n, z);
+  }
+
+  static void plan_mtimes(casadi_int blas, const SXElem* x, casadi_int m, casadi_int k,
+      const SXElem* y, casadi_int n, SXElem* z) {
+    casadi_mtimes_dense(x, m, k, y, n, z, false);
+  }
+
+  template<typename T>
+  void Multiplication::eval_plan(const T* x, const T* y, T* z, T* w) const {
+    // Dense sub-blocks
+    for (casadi_int b=0; b<plan_block_.size(); b+=6) {
+      const casadi_int* blk = get_ptr(plan_block_) + b;
+      const casadi_int* g = get_ptr(plan_gather_) + blk[5];
+      for (casadi_int i=0; i<blk[2]*blk[3]; ++i) w[i] = x[g[i]];
+      plan_mtimes(blas_shorthand_, w, blk[2], blk[3], y+blk[1], blk[4], z+blk[0]);
+    }
+    // Individual products
+    casadi_mtimes_plan(x, y, z, plan_z_.size(), get_ptr(plan_z_), get_ptr(plan_ptr_),
+      get_ptr(plan_x_), get_ptr(plan_y_));
   }
 
   Multiplication::Multiplication(const MX& z, const MX& x, const MX& y,
@@ -62,11 +199,13 @@ namespace casadi {
   }
 
   void Multiplication::eval_kernel(const double** arg, double** res, double* w) const {
+    if (!plan_ptr_.empty()) return eval_plan(arg[1], arg[2], res[0], w);
     casadi_mtimes(arg[1], dep(1).sparsity(), arg[2], dep(2).sparsity(),
                   res[0], sparsity(), w, false);
   }
 
   void Multiplication::eval_kernel(const SXElem** arg, SXElem** res, SXElem* w) const {
+    if (!plan_ptr_.empty()) return eval_plan(arg[1], arg[2], res[0], w);
     casadi_mtimes(arg[1], dep(1).sparsity(), arg[2], dep(2).sparsity(),
                   res[0], sparsity(), w, false);
   }
@@ -156,6 +295,28 @@ namespace casadi {
                                 const std::vector<bool>& arg_is_ref,
                                 std::vector<bool>& res_is_ref) const {
     codegen_copy_z(g, nnz(), arg, res, arg_is_ref);
+    if (!plan_ptr_.empty()) {
+      std::string x = g.work(arg[1], dep(1).nnz(), arg_is_ref[1]);
+      std::string y = g.work(arg[2], dep(2).nnz(), arg_is_ref[2]);
+      std::string z = g.work(res[0], nnz(), false);
+      // Dense sub-blocks
+      if (!plan_block_.empty()) {
+        std::string ind = g.constant(plan_gather_);
+        g.local("i", "casadi_int");
+        for (casadi_int b=0; b<plan_block_.size(); b+=6) {
+          const casadi_int* blk = get_ptr(plan_block_) + b;
+          g << "for (i=0; i<" << blk[2]*blk[3] << "; ++i) w[i] = "
+            << x << "[" << ind << "[" << blk[5] << "+i]];\n";
+          Blas::codegen_mtimes(g, blas_shorthand_, "w", blk[2], blk[3],
+            y + "+" + str(blk[1]), blk[4], z + "+" + str(blk[0]));
+        }
+      }
+      // Individual products
+      if (!plan_z_.empty()) {
+        g << g.mtimes_plan(x, y, z, plan_z_, plan_ptr_, plan_x_, plan_y_) << '\n';
+      }
+      return;
+    }
     g << g.mtimes(g.work(arg[1], dep(1).nnz(), arg_is_ref[1]), dep(1).sparsity(),
                   g.work(arg[2], dep(2).nnz(), arg_is_ref[2]), dep(2).sparsity(),
                   g.work(res[0], nnz(), false), sparsity(), "w", false) << '\n';
@@ -267,6 +428,88 @@ namespace casadi {
         g.work(res[0], nnz(), false));
   }
 
+  // ---------------- BlockMultiplication ----------------
+
+  MXNode* BlockMultiplication::try_create(const MX& z, const MX& x, const MX& y,
+                                          const std::string& blas) {
+    if (z.nnz() == 0) return nullptr;
+    // Common block size; x, y and z are block-sparse for every divisor of their own
+    casadi_int bs = z.sparsity().block_size();
+    if (bs < min_block_size) return nullptr;
+    for (const MX* e : {&x, &y}) {
+      casadi_int bs_e = e->sparsity().block_size();
+      while (bs_e) {
+        casadi_int t = bs % bs_e;
+        bs = bs_e;
+        bs_e = t;
+      }
+    }
+    if (bs < min_block_size) return nullptr;
+    return new BlockMultiplication(z, x, y, bs, blas);
+  }
+
+  BlockMultiplication::BlockMultiplication(const MX& z, const MX& x, const MX& y,
+      casadi_int bs, const std::string& blas)
+    : Multiplication(z, x, y, blas), bs_(bs) {
+    init_blocks();
+  }
+
+  void BlockMultiplication::init_blocks() {
+    const Sparsity& sp_x = dep(1).sparsity();
+    const Sparsity& sp_y = dep(2).sparsity();
+    const Sparsity& sp_z = sparsity();
+    const casadi_int *colind_x = sp_x.colind(), *row_x = sp_x.row();
+    const casadi_int *colind_y = sp_y.colind(), *row_y = sp_y.row();
+    const casadi_int *colind_z = sp_z.colind(), *row_z = sp_z.row();
+    // Offset of block row I in the current block column of z, or -1
+    std::vector<casadi_int> pos(sp_z.size1()/bs_, -1);
+    blocks_.clear();
+    for (casadi_int c=0; c<sp_z.size2(); c+=bs_) {
+      casadi_int ld_z = colind_z[c+1]-colind_z[c];
+      for (casadi_int kk=colind_z[c]; kk<colind_z[c+1]; kk+=bs_) pos[row_z[kk]/bs_] = kk;
+      // Blocks (K, J) of y
+      casadi_int ld_y = colind_y[c+1]-colind_y[c];
+      for (casadi_int kk=colind_y[c]; kk<colind_y[c+1]; kk+=bs_) {
+        casadi_int k = row_y[kk];
+        // Blocks (I, K) of x
+        casadi_int ld_x = colind_x[k+1]-colind_x[k];
+        for (casadi_int kk1=colind_x[k]; kk1<colind_x[k+1]; kk1+=bs_) {
+          casadi_int z_off = pos[row_x[kk1]/bs_];
+          if (z_off<0) continue;
+          blocks_.insert(blocks_.end(), {kk1, ld_x, kk, ld_y, z_off, ld_z});
+        }
+      }
+      for (casadi_int kk=colind_z[c]; kk<colind_z[c+1]; kk+=bs_) pos[row_z[kk]/bs_] = -1;
+    }
+  }
+
+  void BlockMultiplication::eval_kernel(const double** arg, double** res, double* w) const {
+    if (blas_shorthand_==0) {
+      casadi_mtimes_block(arg[1], arg[2], res[0], bs_, blocks_.size()/6, get_ptr(blocks_));
+      return;
+    }
+    for (casadi_int b=0; b<blocks_.size(); b+=6) {
+      const casadi_int* blk = get_ptr(blocks_) + b;
+      Blas::dgemm(blas_shorthand_, CASADI_BLAS_NO_TRANS, CASADI_BLAS_NO_TRANS,
+        bs_, bs_, bs_, 1., arg[1]+blk[0], blk[1], arg[2]+blk[2], blk[3],
+        1., res[0]+blk[4], blk[5]);
+    }
+  }
+
+  void BlockMultiplication::eval_kernel(const SXElem** arg, SXElem** res, SXElem* w) const {
+    casadi_mtimes_block(arg[1], arg[2], res[0], bs_, blocks_.size()/6, get_ptr(blocks_));
+  }
+
+  void BlockMultiplication::generate(CodeGenerator& g,
+           const std::vector<casadi_int>& arg, const std::vector<casadi_int>& res,
+           const std::vector<bool>& arg_is_ref, std::vector<bool>& res_is_ref) const {
+    codegen_copy_z(g, nnz(), arg, res, arg_is_ref);
+    if (blocks_.empty()) return;
+    g << g.mtimes_block(g.work(arg[1], dep(1).nnz(), arg_is_ref[1]),
+                        g.work(arg[2], dep(2).nnz(), arg_is_ref[2]),
+                        g.work(res[0], nnz(), false), bs_, blocks_) << '\n';
+  }
+
   void Multiplication::serialize_type(SerializingStream& s) const {
     MXNode::serialize_type(s);
     s.pack("Multiplication::kind", std::string("base"));
@@ -317,19 +560,36 @@ namespace casadi {
     s.unpack("PseudoDenseMultiplication::c", c_);
   }
 
+  void BlockMultiplication::serialize_type(SerializingStream& s) const {
+    MXNode::serialize_type(s);
+    s.pack("Multiplication::kind", std::string("block"));
+  }
+
+  void BlockMultiplication::serialize_body(SerializingStream& s) const {
+    Multiplication::serialize_body(s);
+    s.pack("BlockMultiplication::bs", bs_);
+  }
+
+  BlockMultiplication::BlockMultiplication(DeserializingStream& s)
+    : Multiplication(s) {
+    s.unpack("BlockMultiplication::bs", bs_);
+    init_blocks();
+  }
+
   MXNode* Multiplication::deserialize(DeserializingStream& s) {
     // Wire-format detection.
     //   pre 3.8: serialize_type packed a *bool* ("Multiplication::dense").
     //     Body did NOT include a blas field. Two variants only --
     //     DenseMultiplication and the generic Multiplication.
     //   3.8+:    serialize_type packs a *string* ("Multiplication::kind"),
-    //     four variants, body always includes "Multiplication::blas".
+    //     five variants, body always includes "Multiplication::blas".
     //
     // In debug mode the descriptor is on the wire and IS the discriminator;
     // in non-debug mode we discriminate on the first wire byte: bool encodes
     // as 2 hex chars whose first is 'a' or 'b'; string-length first byte is
     // 'a'+(length%16), which for our kind names {"base","dense",
-    // "dense_sparse","pseudo_dense"} (lengths 4,5,12,12) is 'e','f','m','m'.
+    // "dense_sparse","pseudo_dense","block"} (lengths 4,5,12,12,5) is
+    // 'e','f','m','m','f'.
     bool legacy_bool;
     std::string kind;
     if (s.debug()) {
@@ -354,13 +614,18 @@ namespace casadi {
       if (s.debug()) s.unpack(dense);
       else           s.unpack("Multiplication::dense", dense);
       if (dense) return new DenseMultiplication(s, /*legacy=*/true);
-      return new Multiplication(s, /*legacy=*/true);
+      Multiplication* n = new Multiplication(s, /*legacy=*/true);
+      n->init_plan();
+      return n;
     }
 
     if (kind == "dense")        return new DenseMultiplication(s);
     if (kind == "dense_sparse") return new DenseSparseMultiplication(s);
     if (kind == "pseudo_dense") return new PseudoDenseMultiplication(s);
-    return new Multiplication(s);
+    if (kind == "block")        return new BlockMultiplication(s);
+    Multiplication* n = new Multiplication(s);
+    n->init_plan();
+    return n;
   }
 
 } // namespace casadi
@@ -37,7 +37,10 @@ namespace casadi {
       \author Joel Andersson
       \date 2010
 
-      The base implementation handles arbitrary sparsity via casadi_mtimes.
+      The base implementation handles arbitrary sparsity. Since all sparsity
+      patterns are fixed, it precomputes a flat plan of the products that
+      contribute to each nonzero of z; casadi_mtimes is the fallback when the
+      plan would be too large.
       Subclasses specialize the kernel for structured operands (all-dense,
       dense * sparse, compactible / pseudo-dense). Each subclass overrides
       eval_kernel + generate + serialize_type; everything else is shared.
@@ -171,7 +174,7 @@ namespace casadi {
     /** \brief Get required length of w field
 
         \identifier{11t} */
-    size_t sz_w() const override { return sparsity().size1();}
+    size_t sz_w() const override { return plan_ptr_.empty() ? sparsity().size1() : plan_sz_w_;}
 
     /** \brief Serialize specific part of node
 
@@ -201,6 +204,35 @@ namespace casadi {
         \identifier{11w} */
     explicit Multiplication(DeserializingStream& s, bool legacy = false);
 
+    /** \brief Precompute the product plan of a general sparse product
+
+        Runs of columns of z and y with identical patterns are dense sub-blocks if
+        x has all the products as structural nonzeros: they are gathered into a
+        dense matrix and multiplied with a dense kernel, which may sum in a
+        different order. For all other columns, each nonzero of z (listed in
+        plan_z_) accumulates the products of the nonzeros of x and y in
+        plan_ptr_[i] ... plan_ptr_[i+1], in the same order as casadi_mtimes.
+        The plan is derived from the sparsity patterns and never serialized. It is
+        left empty if it would be much larger than the operands.
+    */
+    void init_plan();
+
+    /// Run the product plan: z += x*y
+    template<typename T>
+    void eval_plan(const T* x, const T* y, T* z, T* w) const;
+
+    /// Product plan, plan_ptr_ is empty if not used
+    std::vector<casadi_int> plan_z_, plan_ptr_, plan_x_, plan_y_;
+
+    /// Dense sub-blocks: offset in z, offset in y, m, k, n, offset in plan_gather_
+    std::vector<casadi_int> plan_block_;
+
+    /// Nonzeros of x gathered into the dense sub-blocks
+    std::vector<casadi_int> plan_gather_;
+
+    /// Largest dense sub-block of x
+    casadi_int plan_sz_w_;
+
     /// Cached BLAS plugin shorthand. 0 == "reference". Derived state, never
     /// serialized directly; the underlying name string is what crosses
     /// serialization boundaries.
@@ -310,6 +342,57 @@ namespace casadi {
   };
 
 
+  /** \brief Block-sparse * Block-sparse -> Block-sparse product
+
+      When x, y and z all consist of dense, aligned bs-by-bs blocks
+      (Sparsity::is_block), every block is a column-major dense matrix inside
+      the CCS nonzero buffer, with the nonzero count of its columns as leading
+      dimension. The product is a list of dense bs-by-bs block products, which
+      need neither gather/scatter nor work memory.
+
+      Only the block size is serialized; the list of block products is
+      derived from the sparsity patterns.
+  */
+  class CASADI_EXPORT BlockMultiplication : public Multiplication {
+  public:
+    /// Returns a fresh node iff x, y, z share a block size of at least min_block_size
+    static MXNode* try_create(const MX& z, const MX& x, const MX& y,
+                              const std::string& blas = "reference");
+
+    BlockMultiplication(const MX& z, const MX& x, const MX& y, casadi_int bs,
+                        const std::string& blas = "reference");
+    ~BlockMultiplication() override {}
+
+    void eval_kernel(const double** arg, double** res, double* w) const override;
+    void eval_kernel(const SXElem** arg, SXElem** res, SXElem* w) const override;
+
+    void generate(CodeGenerator& g,
+                  const std::vector<casadi_int>& arg,
+                  const std::vector<casadi_int>& res,
+                  const std::vector<bool>& arg_is_ref,
+                  std::vector<bool>& res_is_ref) const override;
+
+    size_t sz_w() const override { return 0;}
+
+    void serialize_type(SerializingStream& s) const override;
+    void serialize_body(SerializingStream& s) const override;
+    explicit BlockMultiplication(DeserializingStream& s);
+
+    /// Smallest block size for which block kernels pay off
+    static const casadi_int min_block_size = 3;
+
+  private:
+    /// Collect the block products
+    void init_blocks();
+
+    // Block size
+    casadi_int bs_;
+
+    // Block products: offset and leading dimension in x, y and z
+    std::vector<casadi_int> blocks_;
+  };
+
+
 } // namespace casadi
 /// \endcond
 
@@ -1936,6 +1936,7 @@ namespace casadi {
 
   MX MX::hessian(const MX& f, const MX& x, MX &g, const Dict& opts) {
     try {
+      casadi_assert(!opts.count("edge_pushing"), "Option 'edge_pushing' is only available for SX");
       Dict all_opts = opts;
       g = gradient(f, x, opts);
       if (!opts.count("symmetric")) all_opts["symmetric"] = true;
@@ -2606,6 +2607,169 @@ namespace casadi {
     return true;
   }
 
+  // Constant that may be folded numerically (i.e. not pooled or read from file)
+  bool is_plain_const(const MX& x) {
+    return x.is_constant() && dynamic_cast<const ConstantPool*>(x.get())==nullptr
+      && dynamic_cast<const ConstantFile*>(x.get())==nullptr;
+  }
+
+  // Drop the explicit zeros of a constant factor if at least half of its nonzeros are zero
+  bool drop_const_zeros(MX& x) {
+    if (dynamic_cast<const ConstantDM*>(x.get())==nullptr) return false;
+    DM v = sparsify(static_cast<DM>(x));
+    if (2*v.nnz() > x.nnz()) return false;
+    x = v;
+    return true;
+  }
+
+  // Argument of a matrix inverse, i.e. inv_node(A) or A\I (untransposed), if x is one
+  bool inverse_arg(casadi_int op, const MXNode* node, const std::vector<MX>& arg, MX& A) {
+    if (op==OP_INVERSE) {
+      A = arg.at(0);
+      return true;
+    } else if (op==OP_SOLVE && !node->info().at("tr").to_bool() && is_plain_const(arg.at(0))
+        && sparsify(static_cast<DM>(arg.at(0))).is_eye()) {
+      A = arg.at(1);
+      return true;
+    }
+    return false;
+  }
+
+  bool MX::simplify_algebraic(std::vector<MX>& arg,
+                              std::vector<MX>& res,
+                              const Dict& opts) {
+    Dict temp_opts = {{"live_variables", false},
+                      {"max_io", 0},
+                      {"cse", false},
+                      {"allow_free", true}};
+    Function f("temp", arg, res, temp_opts);
+    MXFunction *ff = f.get<MXFunction>();
+    const std::vector<casadi_int>& workloc_ = ff->workloc_;
+    const auto& algorithm_ = ff->algorithm_;
+
+    // Number of uses of each work vector entry
+    std::vector<casadi_int> rwork(workloc_.size()-1);
+    for (auto it=algorithm_.begin(); it!=algorithm_.end(); ++it) {
+      if (it->op==OP_INPUT || it->op==OP_PARAMETER) continue;
+      for (casadi_int el : it->arg) if (el>=0) rwork[el]++;
+    }
+
+    // Symbolic work, non-differentiated
+    std::vector<MX> swork(workloc_.size()-1);
+
+    // Split up inputs analogous to symbolic primitives
+    std::vector<std::vector<MX> > arg_split(arg.size());
+    for (casadi_int i=0; i<arg.size(); ++i) arg_split[i] = arg[i].split_primitives(arg[i]);
+
+    // Allocate storage for split outputs
+    std::vector<std::vector<MX> > res_split(res.size());
+    for (casadi_int i=0; i<res.size(); ++i) res_split[i].resize(res[i].n_primitives());
+
+    std::vector<MX> arg1, res1;
+
+    bool performed_rewrite = false;
+
+    // Loop over computational nodes in forward order
+    for (auto it=algorithm_.begin(); it!=algorithm_.end(); ++it) {
+      if (it->op == OP_INPUT) {
+        swork[it->res.front()] = project(arg_split.at(it->data->ind()).at(it->data->segment()),
+                                          it->data.sparsity(), true);
+      } else if (it->op==OP_OUTPUT) {
+        // Collect the results
+        res_split.at(it->data->ind()).at(it->data->segment()) = swork[it->arg.front()];
+      } else if (it->op==OP_PARAMETER) {
+        // Fetch parameter
+        swork[it->res.front()] = it->data;
+      } else {
+        // Arguments of the operation
+        arg1.resize(it->arg.size());
+        std::vector<bool> unique(it->arg.size(), false);
+        for (casadi_int i=0; i<arg1.size(); ++i) {
+          casadi_int el = it->arg[i];
+          if (el<0) {
+            arg1[i] = MX(it->data->dep(i).size());
+          } else {
+            arg1[i] = swork[el];
+            unique[i] = rwork[el]==1;
+          }
+        }
+
+        // Try the rewrite rules, falling back to rebuilding the node as is
+        res1.resize(it->res.size());
+        MX r;
+        bool rewrite = false;
+        MX A, B;
+        if (inverse_arg(it->op, it->data.get(), arg1, A)) {
+          // inv(inv(B)) = B
+          if (inverse_arg(A.op(), A.get(), A->dep_, B)) {
+            r = B;
+            rewrite = true;
+          }
+        } else if (it->op==OP_MTIMES) {
+          MX z = arg1[0], x = arg1[1], y = arg1[2];
+          if (is_plain_const(x) && unique[2] && y.is_op(OP_MTIMES) && y.dep(0).is_zero()
+              && is_plain_const(y.dep(1))) {
+            // A*(B*y) = (A*B)*y, unless A*B has more nonzeros than A and B together
+            DM AB = DM::mtimes(static_cast<DM>(x), static_cast<DM>(y.dep(1)));
+            if (AB.nnz() <= x.nnz() + y.dep(1).nnz()) {
+              x = AB;
+              y = y.dep(2);
+              rewrite = true;
+            }
+          } else if (is_plain_const(y) && unique[1] && x.is_op(OP_MTIMES) && x.dep(0).is_zero()
+              && is_plain_const(x.dep(2))) {
+            // (x*A)*B = x*(A*B), unless A*B has more nonzeros than A and B together
+            DM AB = DM::mtimes(static_cast<DM>(x.dep(2)), static_cast<DM>(y));
+            if (AB.nnz() <= y.nnz() + x.dep(2).nnz()) {
+              y = AB;
+              x = x.dep(1);
+              rewrite = true;
+            }
+          }
+          // Known zeros in constant factors need not be multiplied
+          if (drop_const_zeros(x)) rewrite = true;
+          if (drop_const_zeros(y)) rewrite = true;
+          if (rewrite) r = mac(x, y, z);
+        } else if (it->op==OP_ADD || it->op==OP_MUL) {
+          // c1 + (c2 + y) = (c1 + c2) + y, c1 * (c2 * y) = (c1 * c2) * y
+          for (casadi_int k=0; k<2 && !rewrite; ++k) {
+            const MX& c1 = arg1[k];
+            const MX& e = arg1[1-k];
+            if (!is_plain_const(c1) || !unique[1-k] || !e.is_op(it->op)) continue;
+            for (casadi_int j=0; j<2; ++j) {
+              const MX& c2 = e.dep(j);
+              if (!is_plain_const(c2) || e.dep(1-j).is_constant()) continue;
+              DM c12 = it->op==OP_ADD ? static_cast<DM>(c1) + static_cast<DM>(c2)
+                                      : static_cast<DM>(c1) * static_cast<DM>(c2);
+              r = binary(it->op, MX(c12), e.dep(1-j));
+              rewrite = true;
+              break;
+            }
+          }
+        }
+
+        // Rewrites must preserve the sparsity pattern of the node
+        if (rewrite && r.sparsity()==it->data.sparsity()) {
+          res1[0] = r;
+          performed_rewrite = true;
+        } else {
+          it->data->eval_mx(arg1, res1);
+        }
+
+        // Get the result
+        for (casadi_int i=0; i<res1.size(); ++i) {
+          casadi_int el = it->res[i]; // index of the output
+          if (el>=0) swork[el] = res1[i];
+        }
+      }
+    }
+
+    // Join split outputs
+    for (casadi_int i=0; i<res.size(); ++i) res[i] = res[i].join_primitives(res_split[i]);
+
+    return performed_rewrite;
+  }
+
   class IncrementalSerializerMX {
     public:
 
@@ -66,6 +66,10 @@ namespace casadi {
       {"cse",
        {OT_BOOL,
         "Perform common subexpression elimination (complexity is N*log(N) in graph size)"}},
+      {"simplify",
+       {OT_BOOL,
+        "Fold constant subexpressions and apply algebraic identities to the graph "
+        "(e.g. inv(inv(A)), products and sums of constants, known zeros in constant factors)"}},
       {"allow_free",
        {OT_BOOL,
         "Allow construction with free variables (Default: false)"}},
@@ -75,6 +79,9 @@ namespace casadi {
      }
   };
 
+  const std::vector<std::pair<std::string, casadi_int> > MXFunction::simplify_tasks_
+  = {{"const_folding", 1}, {"algebraic", 0}};
+
   Dict MXFunction::generate_options(const std::string& target) const {
     Dict opts = FunctionInternal::generate_options(target);
     if (target=="clone") opts["default_in"] = default_in_;
@@ -116,6 +123,7 @@ namespace casadi {
     live_variables_ = true;
     print_instructions_ = false;
     bool cse_opt = false;
+    bool simplify_opt = false;
     bool allow_free = false;
 
     // Read options
@@ -128,6 +136,8 @@ namespace casadi {
         print_instructions_ = op.second;
       } else if (op.first=="cse") {
         cse_opt = op.second;
+      } else if (op.first=="simplify") {
+        simplify_opt = op.second;
       } else if (op.first=="allow_free") {
         allow_free = op.second;
       }
@@ -148,6 +158,13 @@ namespace casadi {
         "You must use get_output() to make a concrete instance.");
     }
 
+    if (simplify_opt) {
+      casadi_int n_before = verbose_ ? MX::n_nodes(veccat(out_)) : 0;
+      apply_simplify_passes(simplify_tasks_, in_, out_);
+      if (verbose_) casadi_message(name_ + "::init: simplify reduced the graph from "
+        + str(n_before) + " to " + str(MX::n_nodes(veccat(out_))) + " nodes");
+    }
+
     if (cse_opt) out_ = cse(out_);
 
     // Stack used to sort the computational graph
@@ -451,6 +468,9 @@ namespace casadi {
     // Operation number (for printing)
     casadi_int k = 0;
 
+    // Record a span for each operation?
+    bool profile = Profiler::is_active();
+
     // Evaluate all of the nodes of the algorithm:
     // should only evaluate nodes that have not yet been calculated!
     for (auto&& e : algorithm_) {
@@ -482,7 +502,9 @@ namespace casadi {
 
         // Evaluate
         if (print_instructions_) print_arg(uout(), k, e, arg1);
+        int64_t t_start = profile ? Profiler::now() : 0;
         if (e.data->eval(arg1, res1, iw, w)) return 1;
+        if (profile) Profiler::record(Profiler::op_name(e.op), k, t_start, Profiler::now());
         if (print_instructions_) print_res(uout(), k, e, res1);
       }
       // Increase counter
@@ -491,6 +513,88 @@ namespace casadi {
     return 0;
   }
 
+  bool MXFunction::has_eval_batch() const {
+    if (!free_vars_.empty() || print_instructions_) return false;
+    // Only worth it if some operation evaluates all instances at once
+    for (auto&& e : algorithm_) {
+      if (e.op!=OP_INPUT && e.op!=OP_OUTPUT && e.data->has_eval_batch()) return true;
+    }
+    return false;
+  }
+
+  size_t MXFunction::sz_w_batch(casadi_int n) const {
+    // Each instance gets its own copy of the work vector
+    return std::max(sz_w(), static_cast<size_t>(n*workloc_.back()));
+  }
+
+  int MXFunction::eval_batch(const double** arg, double** res,
+      casadi_int* iw, double* w, void* mem, casadi_int n) const {
+    if (verbose_) casadi_message(name_ + "::eval_batch (" + str(n) + " instances)");
+    setup(mem, arg, res, iw, w);
+    // Work vector and temporaries to hold pointers to operation input and outputs
+    const double** arg1 = arg+n_in_;
+    double** res1 = res+n_out_;
+
+    // Offset between the work vectors of two instances,
+    // the operations share the scratch space of the first one
+    casadi_int stride = workloc_.back();
+
+    // Operation number (for profiling)
+    casadi_int op_ind = -1;
+
+    // Record a span for each operation, covering all instances?
+    bool profile = Profiler::is_active();
+
+    for (auto&& e : algorithm_) {
+      op_ind++;
+      if (e.op==OP_INPUT) {
+        // Pass an input
+        casadi_int nnz=e.data.nnz();
+        casadi_int i=e.data->ind();
+        casadi_int nz_offset=e.data->offset();
+        for (casadi_int k=0; k<n; ++k) {
+          double *w1 = w+k*stride+workloc_[e.res.front()];
+          if (arg[i]==nullptr) {
+            std::fill(w1, w1+nnz, 0);
+          } else {
+            std::copy_n(arg[i]+k*nnz_in(i)+nz_offset, nnz, w1);
+          }
+        }
+      } else if (e.op==OP_OUTPUT) {
+        // Get an output
+        casadi_int nnz=e.data->dep().nnz();
+        casadi_int i=e.data->ind();
+        casadi_int nz_offset=e.data->offset();
+        if (res[i]) {
+          for (casadi_int k=0; k<n; ++k) {
+            std::copy_n(w+k*stride+workloc_[e.arg.front()], nnz, res[i]+k*nnz_out(i)+nz_offset);
+          }
+        }
+      } else if (e.data->has_eval_batch()) {
+        // All instances at once
+        for (casadi_int i=0; i<e.arg.size(); ++i)
+          arg1[i] = e.arg[i]>=0 ? w+workloc_[e.arg[i]] : nullptr;
+        for (casadi_int i=0; i<e.res.size(); ++i)
+          res1[i] = e.res[i]>=0 ? w+workloc_[e.res[i]] : nullptr;
+        int64_t t_start = profile ? Profiler::now() : 0;
+        if (e.data->eval_batch(arg1, res1, iw, w, n, stride)) return 1;
+        if (profile) Profiler::record(Profiler::op_name(e.op), op_ind, t_start, Profiler::now());
+      } else {
+        // One instance at a time
+        int64_t t_start = profile ? Profiler::now() : 0;
+        for (casadi_int k=0; k<n; ++k) {
+          for (casadi_int i=0; i<e.arg.size(); ++i)
+            arg1[i] = e.arg[i]>=0 ? w+k*stride+workloc_[e.arg[i]] : nullptr;
+          for (casadi_int i=0; i<e.res.size(); ++i)
+            res1[i] = e.res[i]>=0 ? w+k*stride+workloc_[e.res[i]] : nullptr;
+          if (e.data->eval(arg1, res1, iw, w)) return 1;
+        }
+        if (profile) Profiler::record(Profiler::op_name(e.op), op_ind, t_start, Profiler::now());
+      }
+    }
+    return 0;
+  }
+
   std::string MXFunction::print(const AlgEl& el) const {
     std::stringstream s;
     if (el.op==OP_OUTPUT) {
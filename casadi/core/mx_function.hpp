@@ -114,6 +114,16 @@ namespace casadi {
         \identifier{24} */
     int eval(const double** arg, double** res, casadi_int* iw, double* w, void* mem) const override;
 
+    ///@{
+    /** \brief  Evaluate several instances node by node, passing them to nodes that batch
+
+        \identifier{2k7} */
+    bool has_eval_batch() const override;
+    size_t sz_w_batch(casadi_int n) const override;
+    int eval_batch(const double** arg, double** res, casadi_int* iw, double* w,
+      void* mem, casadi_int n) const override;
+    ///@}
+
     /** \brief  Print description
 
         \identifier{25} */
@@ -137,6 +147,9 @@ namespace casadi {
     const Options& get_options() const override { return options_;}
     ///@}
 
+    /// Graph simplification passes applied with the 'simplify' option
+    static const std::vector<std::pair<std::string, casadi_int> > simplify_tasks_;
+
     /// Get all statistics
     Dict get_stats(void* mem) const override;
 
@@ -342,6 +342,12 @@ namespace casadi {
     return 1;
   }
 
+  int MXNode::eval_batch(const double** arg, double** res, casadi_int* iw, double* w,
+                         casadi_int n, casadi_int stride) const {
+    casadi_error("'eval_batch' not defined for class " + class_name());
+    return 1;
+  }
+
   int MXNode::eval_sx(const SXElem** arg, SXElem** res, casadi_int* iw, SXElem* w) const {
     casadi_error("'eval_sx' not defined for class " + class_name());
     return 1;
@@ -602,6 +608,12 @@ namespace casadi {
         dim_a, dim_b, dim_c, a, b, c);
     }
 
+    // Chained contractions
+    MX ret;
+    if (Einstein::reassociate(C, densify(A), densify(B), dim_c, dim_a, dim_b, c, a, b, ret)) {
+      return ret;
+    }
+
     return MX::create(new Einstein(C, densify(A), densify(B), dim_c, dim_a, dim_b, c, a, b));
   }
 
@@ -182,6 +182,20 @@ namespace casadi {
         \identifier{1qt} */
     virtual int eval(const double** arg, double** res, casadi_int* iw, double* w) const;
 
+    /** \brief  Can the node evaluate several instances at once (eval_batch)?
+
+        \identifier{2k1} */
+    virtual bool has_eval_batch() const { return false;}
+
+    /** \brief  Evaluate n instances numerically
+
+        The data of instance k is found at offset k*stride from the pointers in arg and res,
+        iw and w are shared.
+
+        \identifier{2k2} */
+    virtual int eval_batch(const double** arg, double** res, casadi_int* iw, double* w,
+                           casadi_int n, casadi_int stride) const;
+
     /** \brief  Evaluate symbolically (SX)
 
         \identifier{1qu} */
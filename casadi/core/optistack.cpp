@@ -186,6 +186,14 @@ void Opti::set_value(const MX& x, const DM& v) {
   }
 }
 
+void Opti::set_active(const MX& g, bool flag) {
+  try {
+    (*this)->set_active(g, flag);
+  } catch(std::exception& e) {
+    THROW_ERROR("set_active", e.what());
+  }
+}
+
 void Opti::set_domain(const MX& x, const std::string& domain) {
   try {
     (*this)->set_domain(x, domain);
@@ -206,6 +206,20 @@ public:
   void set_value(const std::vector<MX>& assignments);
   /// @}
 
+  /** \brief Activate or deactivate a constraint slot
+  *
+  * Constraints added with the 'slot' option can be switched on and off
+  * in between solves. A deactivated constraint has infinite bounds.
+  * Since the problem structure is unaffected, the solver is not rebuilt.
+  *
+  * \verbatim
+  * c = x<=1
+  * opti.subject_to(c, {"slot": true})
+  * opti.set_active(c, false)
+  * \endverbatim
+  */
+  void set_active(const MX& g, bool flag=true);
+
   /// @{
   /** \brief Set domain of a decision variable
   *
@@ -521,6 +535,7 @@ public:
     MX dual;
     Dict extra;
     DM linear_scale;
+    MX activation; // Activation parameter (constraint slots only)
   };
   struct MetaVar : IndexAbstraction {
     std::string attribute;
@@ -742,6 +742,12 @@ void OptiNode::bake() {
   for (const auto& d : symvar(total_expr))
     symbol_active_[meta(d).count] = true;
 
+  // Activation parameters of constraint slots only appear in the bounds
+  for (const auto& g : g_) {
+    const MX& a = meta_con(g).activation;
+    if (!a.is_empty()) symbol_active_[meta(a).count] = true;
+  }
+
   std::vector<MX> x = active_symvar(OPTI_VAR);
   for (casadi_int i=0;i<x.size();++i) meta(x[i]).active_i = i;
 
@@ -842,9 +848,11 @@ void OptiNode::bake() {
       ubg_all.push_back(meta_con(g).ub/meta_con(g).linear_scale);
       ubg_unscaled_all.push_back(meta_con(g).ub);
 
+      // A deactivated slot is unbounded, hence never flagged as equality
       equality_.insert(equality_.end(),
         meta_con(g).canon.numel(),
-        meta_con(g).type==OPTI_EQUALITY || meta_con(g).type==OPTI_GENERIC_EQUALITY);
+        meta_con(g).activation.is_empty() &&
+        (meta_con(g).type==OPTI_EQUALITY || meta_con(g).type==OPTI_GENERIC_EQUALITY));
     }
   }
 
@@ -962,6 +970,7 @@ void OptiNode::solver(const std::string& solver_name, const Dict& plugin_options
   solver_options_ = plugin_options;
   if (!solver_options.empty())
     solver_options_[solver_name] = solver_options;
+  solver_fingerprint_.clear();
   mark_solver_dirty();
 }
 
@@ -1207,20 +1216,49 @@ void OptiNode::subject_to(const MX& g, const DM& linear_scale, const Dict& optio
   casadi_assert(!g.is_constant(), "You passed a constant to `subject_to`. "
                                   "You need a symbol to form a constraint.");
 
+  // Activation parameter of a previous incarnation of this constraint slot
+  MX activation;
+  if (has_con(g)) activation = meta_con(g).activation;
+
   // Store the meta-data
   set_meta_con(g, canon_expr(g, linear_scale));
   register_dual(meta_con(g));
 
+  bool slot = false;
   for (auto && it : options) {
     if (it.first=="stacktrace") {
       meta_con(g).extra["stacktrace"] = it.second.to_dict_vector();
       meta(meta_con(g).dual_canon).extra["stacktrace"] = it.second.to_dict_vector();
     } else if (it.first=="meta") {
       update_user_dict(g, it.second.to_dict());
+    } else if (it.first=="slot") {
+      slot = it.second;
     } else {
       casadi_error("Unknown option: " + it.first);
     }
   }
+
+  if (slot) {
+    // Constraint slot: bounds are relaxed to infinity when deactivated
+    MetaCon& c = meta_con(g);
+    casadi_assert(c.type!=OPTI_PSD && c.type!=OPTI_UNKNOWN,
+      "Constraint slots are only supported for (in)equality constraints.");
+    if (activation.is_empty()) {
+      activation = parameter(MX::sym(name_prefix() + "active_" + str(count_dual_)));
+    }
+    c.activation = activation;
+    set_value_internal(activation, 1, store_initial_);
+    c.lb = if_else(c.activation, c.lb, -inf*DM::ones(c.lb.sparsity()));
+    c.ub = if_else(c.activation, c.ub, inf*DM::ones(c.ub.sparsity()));
+  }
+}
+
+void OptiNode::set_active(const MX& g, bool flag) {
+  assert_has_con(g);
+  const MetaCon& c = meta_con(g);
+  casadi_assert(!c.activation.is_empty(),
+    "Constraint was not declared as a slot. Use subject_to(g, {'slot': true}).");
+  set_value_internal(c.activation, flag, store_initial_);
 }
 
 void OptiNode::subject_to() {
@@ -1267,6 +1305,21 @@ void OptiNode::res(const DMDict& res) {
   mark_solved();
 }
 
+std::string OptiNode::fingerprint() const {
+  std::vector<MX> out = {nlp_.at("f"), nlp_.at("g")};
+  if (problem_type_=="conic") out.push_back(nlp_.at("h"));
+  Function nlp("nlp", {nlp_.at("x"), nlp_.at("p")}, out, Dict{{"allow_free", true}});
+  // Leave error reporting to the solver constructor
+  if (nlp.has_free()) return "";
+  std::stringstream ss;
+  ss << problem_type_ << ";" << solver_name_ << ";" << (user_callback_ ? 1 : 0) << ";";
+  for (bool e : equality_) ss << e;
+  ss << ";";
+  for (bool e : discrete_) ss << e;
+  ss << ";" << nlp.serialize();
+  return ss.str();
+}
+
 bool OptiNode::old_callback() const {
   if (callback_.is_null()) return false;
   InternalOptiCallback* cb = static_cast<InternalOptiCallback*>(callback_.get());
@@ -1328,7 +1381,13 @@ OptiSol OptiNode::solve(bool accept_limit) {
   bool solver_update =  solver_dirty() || old_callback() || (user_callback_ && callback_.is_null());
 
   if (solver_update) {
-    solver_ = solver_construct(true);
+    // Reuse the solver if the rebuilt problem is structurally identical
+    std::string fp = fingerprint();
+    if (solver_.is_null() || fp.empty() || fp!=solver_fingerprint_ || old_callback() ||
+        (user_callback_ && callback_.is_null())) {
+      solver_ = solver_construct(true);
+      solver_fingerprint_ = fp;
+    }
     mark_solver_dirty(false);
   }
 
@@ -105,6 +105,9 @@ public:
   void set_value(const std::vector<MX>& assignments);
   /// @}
 
+  /// Activate or deactivate a constraint created with the 'slot' option
+  void set_active(const MX& g, bool flag);
+
   /// Set domain of variable
   void set_domain(const MX& x, const std::string& domain);
 
@@ -414,6 +417,12 @@ private:
   /// Solver
   Function solver_;
 
+  /// Structural fingerprint of the problem solver_ was constructed for
+  std::string solver_fingerprint_;
+
+  /// Compute structural fingerprint of the baked problem
+  std::string fingerprint() const;
+
   mutable Dict stats_;
   mutable std::vector<casadi_int> g_index_reduce_g_;
   mutable std::vector<casadi_int> g_index_reduce_x_;
@@ -139,7 +139,7 @@ void OracleFunction::finalize() {
     stride_iw_ = std::max(stride_iw_, sz_iw);
     stride_w_ = std::max(stride_w_, sz_w);
     bool persistent = false;
-    alloc(fcn, persistent, max_num_threads_);
+    alloc(fcn, persistent, n_thread_local());
   }
 
   // Set corresponding monitors
@@ -168,8 +168,7 @@ void OracleFunction::finalize() {
 void OracleFunction::join_results(OracleMemory* m) const {
   // Combine runtime statistics
   // Note: probably not correct to simply add wall times
-  for (int i = 0; i < max_num_threads_; ++i) {
-    auto* ml = m->thread_local_mem[i];
+  for (auto* ml : m->thread_local_mem) {
     for (auto&& s : ml->fstats) {
       m->fstats.at(s.first).join(s.second);
     }
@@ -313,7 +312,7 @@ calc_function(OracleMemory* m, const std::string& fcn,
   // Python interrupt checker needs the GIL.
   // We may not have access to it in a multi-threaded context
   // See issue #2955
-  if (max_num_threads_==1) InterruptHandler::check();
+  if (max_num_threads_==1 && !m->concurrent) InterruptHandler::check();
 
   // Get function
   const Function& f = get_function(fcn);
@@ -488,7 +487,7 @@ int OracleFunction::init_mem(void* mem) const {
   casadi_assert_dev(m->thread_local_mem.empty());
 
   // Allocate and initialize local memory for threads
-  for (int i = 0; i < max_num_threads_; ++i) {
+  for (int i = 0; i < n_thread_local(); ++i) {
     m->thread_local_mem.push_back(new LocalOracleMemory());
     if (OracleFunction::local_init_mem(m->thread_local_mem[i])) return 1;
   }
@@ -514,8 +513,7 @@ void OracleFunction::set_temp(void* mem, const double** arg, double** res,
   m->d_oracle.res = res;
   m->d_oracle.iw = iw;
   m->d_oracle.w = w;
-  for (int i = 0; i < max_num_threads_; ++i) {
-    auto* ml = m->thread_local_mem[i];
+  for (auto* ml : m->thread_local_mem) {
     for (auto&& s : ml->fstats) s.second.reset();
     ml->arg = arg;
     ml->res = res;
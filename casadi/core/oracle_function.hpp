@@ -68,6 +68,9 @@ namespace casadi {
     casadi_oracle_data<double> d_oracle;
 
     std::vector<LocalOracleMemory*> thread_local_mem;
+
+    // Oracle calls are currently made from worker threads
+    bool concurrent = false;
     ~OracleMemory();
   };
 
@@ -182,6 +185,9 @@ namespace casadi {
     /** Register the function for evaluation and statistics gathering */
     void set_function(const Function& fcn) { set_function(fcn, fcn.name()); }
 
+    /// Number of thread-local memory blocks, at least max_num_threads_
+    virtual int n_thread_local() const { return max_num_threads_;}
+
     // Calculate an oracle function
     int calc_function(OracleMemory* m, const std::string& fcn,
       const double* const* arg=nullptr, int thread_id=0) const;
@@ -0,0 +1,276 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "profiler.hpp"
+#include "casadi_misc.hpp"
+#include "calculus.hpp"
+#include "filesystem_impl.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+#ifdef CASADI_WITH_THREAD
+#ifdef CASADI_WITH_THREAD_MINGW
+#include <mingw.mutex.h>
+#else // CASADI_WITH_THREAD_MINGW
+#include <mutex>
+#endif // CASADI_WITH_THREAD_MINGW
+#endif //CASADI_WITH_THREAD
+
+namespace casadi {
+
+  std::atomic<bool> Profiler::active_(false);
+
+  namespace {
+    // A recorded span
+    struct ProfilerEvent {
+      const char* name;
+      casadi_int index;
+      int64_t start, stop;
+    };
+
+    // Ring buffer owned by a single recording thread
+    struct ProfilerBuffer {
+      casadi_int tid;
+      casadi_int generation;
+      // Number of spans recorded, the slot of the next span is n % events.size()
+      casadi_int n;
+      // Slot of the next span
+      size_t next;
+      std::vector<ProfilerEvent> events;
+      // Spans currently kept, oldest first
+      std::vector<ProfilerEvent> kept() const {
+        casadi_int cap = events.size();
+        if (n <= cap) return std::vector<ProfilerEvent>(events.begin(), events.begin() + n);
+        std::vector<ProfilerEvent> ret(events.begin() + n % cap, events.end());
+        ret.insert(ret.end(), events.begin(), events.begin() + n % cap);
+        return ret;
+      }
+    };
+
+    // Buffers and interned names, outlive the threads that recorded them
+    struct ProfilerState {
+#ifdef CASADI_WITH_THREAD
+      std::mutex mtx;
+#endif // CASADI_WITH_THREAD
+      std::vector<std::unique_ptr<ProfilerBuffer>> buffers;
+      std::unordered_set<std::string> names;
+      casadi_int capacity = 100000;
+      // Incremented on start and clear, stale buffers are reset on their next use
+      std::atomic<casadi_int> generation{0};
+    };
+
+    ProfilerState& profiler_state() {
+      static ProfilerState s;
+      return s;
+    }
+
+    thread_local ProfilerBuffer* profiler_buffer = nullptr;
+
+    // Buffers of the current recording
+    std::vector<const ProfilerBuffer*> current_buffers(ProfilerState& s) {
+      std::vector<const ProfilerBuffer*> ret;
+      for (auto&& b : s.buffers) {
+        if (b->generation==s.generation && b->n>0) ret.push_back(b.get());
+      }
+      return ret;
+    }
+
+    std::string json_escape(const char* s) {
+      std::string ret;
+      for (; *s; ++s) {
+        if (*s=='"' || *s=='\\') {
+          ret += '\\';
+          ret += *s;
+        } else if (static_cast<unsigned char>(*s) < 0x20) {
+          ret += ' ';
+        } else {
+          ret += *s;
+        }
+      }
+      return ret;
+    }
+
+    std::string frame(const ProfilerEvent& e) {
+      if (e.index<0) return e.name;
+      return std::string(e.name) + "[" + std::to_string(e.index) + "]";
+    }
+  } // namespace
+
+  void Profiler::start(casadi_int capacity) {
+    casadi_assert(capacity>0, "Profiler capacity must be positive");
+    ProfilerState& s = profiler_state();
+    {
+#ifdef CASADI_WITH_THREAD
+      std::lock_guard<std::mutex> lock(s.mtx);
+#endif // CASADI_WITH_THREAD
+      s.capacity = capacity;
+      s.generation++;
+    }
+    active_ = true;
+  }
+
+  void Profiler::stop() {
+    active_ = false;
+  }
+
+  void Profiler::clear() {
+    ProfilerState& s = profiler_state();
+#ifdef CASADI_WITH_THREAD
+    std::lock_guard<std::mutex> lock(s.mtx);
+#endif // CASADI_WITH_THREAD
+    s.generation++;
+  }
+
+  void Profiler::record(const char* name, casadi_int index, int64_t start, int64_t stop) {
+    ProfilerState& s = profiler_state();
+    ProfilerBuffer* b = profiler_buffer;
+    casadi_int generation = s.generation.load(std::memory_order_relaxed);
+    if (b==nullptr || b->generation!=generation) {
+#ifdef CASADI_WITH_THREAD
+      std::lock_guard<std::mutex> lock(s.mtx);
+#endif // CASADI_WITH_THREAD
+      if (b==nullptr) {
+        s.buffers.emplace_back(new ProfilerBuffer());
+        b = profiler_buffer = s.buffers.back().get();
+        b->tid = s.buffers.size() - 1;
+      }
+      b->generation = s.generation;
+      b->n = 0;
+      b->next = 0;
+      b->events.resize(s.capacity);
+    }
+    if (b->next==b->events.size()) b->next = 0;
+    b->events[b->next++] = {name, index, start, stop};
+    b->n++;
+  }
+
+  const char* Profiler::intern(const std::string& name) {
+    ProfilerState& s = profiler_state();
+#ifdef CASADI_WITH_THREAD
+    std::lock_guard<std::mutex> lock(s.mtx);
+#endif // CASADI_WITH_THREAD
+    return s.names.insert(name).first->c_str();
+  }
+
+  const char* Profiler::op_name(casadi_int op) {
+    static const std::vector<const char*> names = [] {
+      std::vector<const char*> ret(NUM_BUILT_IN_OPS);
+      for (casadi_int k=0; k<NUM_BUILT_IN_OPS; ++k) {
+        ret[k] = intern(casadi_math<double>::name(k));
+      }
+      return ret;
+    }();
+    return names.at(op);
+  }
+
+  casadi_int Profiler::n_spans() {
+    ProfilerState& s = profiler_state();
+#ifdef CASADI_WITH_THREAD
+    std::lock_guard<std::mutex> lock(s.mtx);
+#endif // CASADI_WITH_THREAD
+    casadi_int ret = 0;
+    for (const ProfilerBuffer* b : current_buffers(s)) {
+      ret += std::min(b->n, static_cast<casadi_int>(b->events.size()));
+    }
+    return ret;
+  }
+
+  void Profiler::to_chrome_trace(const std::string& filename) {
+    ProfilerState& s = profiler_state();
+#ifdef CASADI_WITH_THREAD
+    std::lock_guard<std::mutex> lock(s.mtx);
+#endif // CASADI_WITH_THREAD
+    std::vector<const ProfilerBuffer*> buffers = current_buffers(s);
+
+    // Time stamps relative to the first span
+    int64_t t0 = std::numeric_limits<int64_t>::max();
+    for (const ProfilerBuffer* b : buffers) {
+      for (const ProfilerEvent& e : b->kept()) t0 = std::min(t0, e.start);
+    }
+
+    auto f_ptr = Filesystem::ofstream_ptr(filename);
+    std::ostream& f = *f_ptr;
+    f.precision(3);
+    f << std::fixed << "{\"traceEvents\":[";
+    bool first = true;
+    for (const ProfilerBuffer* b : buffers) {
+      for (const ProfilerEvent& e : b->kept()) {
+        f << (first ? "\n" : ",\n");
+        first = false;
+        f << "{\"name\":\"" << json_escape(e.name) << "\",\"ph\":\"X\""
+          << ",\"ts\":" << 1e-3*static_cast<double>(e.start - t0)
+          << ",\"dur\":" << 1e-3*static_cast<double>(e.stop - e.start)
+          << ",\"pid\":0,\"tid\":" << b->tid;
+        if (e.index>=0) f << ",\"args\":{\"index\":" << e.index << "}";
+        f << "}";
+      }
+    }
+    f << "\n],\"displayTimeUnit\":\"ns\"}\n";
+  }
+
+  void Profiler::to_folded(const std::string& filename) {
+    ProfilerState& s = profiler_state();
+#ifdef CASADI_WITH_THREAD
+    std::lock_guard<std::mutex> lock(s.mtx);
+#endif // CASADI_WITH_THREAD
+
+    // Self time per call stack
+    std::map<std::string, int64_t> stacks;
+    for (const ProfilerBuffer* b : current_buffers(s)) {
+      std::vector<ProfilerEvent> ev = b->kept();
+      // Parents before children
+      std::sort(ev.begin(), ev.end(), [](const ProfilerEvent& a, const ProfilerEvent& b) {
+        return a.start < b.start || (a.start == b.start && a.stop > b.stop);
+      });
+      // Rebuild the nesting from the intervals
+      std::vector<std::string> path(ev.size());
+      std::vector<int64_t> self(ev.size());
+      std::vector<size_t> stack;
+      std::string root = "thread " + std::to_string(b->tid);
+      for (size_t k=0; k<ev.size(); ++k) {
+        const ProfilerEvent& e = ev[k];
+        while (!stack.empty() && ev[stack.back()].stop < e.stop) stack.pop_back();
+        self[k] = e.stop - e.start;
+        if (stack.empty()) {
+          path[k] = root + ";" + frame(e);
+        } else {
+          self[stack.back()] -= self[k];
+          path[k] = path[stack.back()] + ";" + frame(e);
+        }
+        stack.push_back(k);
+      }
+      for (size_t k=0; k<ev.size(); ++k) stacks[path[k]] += std::max(self[k], int64_t(0));
+    }
+
+    auto f_ptr = Filesystem::ofstream_ptr(filename);
+    std::ostream& f = *f_ptr;
+    for (auto&& e : stacks) f << e.first << " " << e.second << "\n";
+  }
+
+} // namespace casadi
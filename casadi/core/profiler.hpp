@@ -0,0 +1,130 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#ifndef CASADI_PROFILER_HPP
+#define CASADI_PROFILER_HPP
+
+#include "casadi/core/casadi_common.hpp"
+#include <casadi/core/casadi_export.h>
+
+#ifndef SWIG
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#endif // SWIG
+
+namespace casadi {
+
+  /** \brief Hierarchical profiler for numerical evaluation
+
+      When started, nested spans are recorded for every Function evaluation,
+      every instruction of an MXFunction algorithm and every timed phase of
+      the solvers (e.g. QP, linesearch, sfact, advance). Each thread records
+      into its own ring buffer; when a buffer is full, the oldest spans are
+      overwritten.
+
+      The recording is exported as Chrome trace JSON (chrome://tracing, Perfetto)
+      or as folded stacks (flamegraph.pl, speedscope) after stopping.
+      When not started, the cost is a single flag check per span.
+  */
+  class CASADI_EXPORT Profiler {
+    private:
+      /// No instances are allowed
+      Profiler();
+    public:
+      /** \brief Start recording, discarding any previous recording
+
+          \param capacity Maximum number of spans kept per thread
+      */
+      static void start(casadi_int capacity=100000);
+
+      /** \brief Stop recording, keeping the recorded spans */
+      static void stop();
+
+      /** \brief Discard the recorded spans */
+      static void clear();
+
+      /** \brief Number of spans currently kept */
+      static casadi_int n_spans();
+
+      /** \brief Write the recorded spans as Chrome trace event JSON */
+      static void to_chrome_trace(const std::string& filename);
+
+      /** \brief Write the recorded spans as folded stacks
+
+          One line per call stack, frames separated by ';', weighted by
+          the self time in nanoseconds.
+      */
+      static void to_folded(const std::string& filename);
+
+#ifndef SWIG
+      /// \cond INTERNAL
+      /// Is the profiler recording?
+      static bool is_active() { return active_.load(std::memory_order_relaxed);}
+
+      /// Time stamp in nanoseconds
+      static int64_t now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::high_resolution_clock::now().time_since_epoch()).count();
+      }
+
+      /// Record a span, name must remain valid (literal or interned)
+      static void record(const char* name, casadi_int index, int64_t start, int64_t stop);
+
+      /// Get a pointer to a copy of a string that remains valid for the process lifetime
+      static const char* intern(const std::string& name);
+
+      /// Interned name of an operation
+      static const char* op_name(casadi_int op);
+
+    private:
+      static std::atomic<bool> active_;
+      /// \endcond
+#endif // SWIG
+  };
+
+#ifndef SWIG
+  /// \cond INTERNAL
+  /** \brief Records a span for the lifetime of the object, if profiling */
+  class CASADI_EXPORT ProfilerScope {
+    public:
+      explicit ProfilerScope(const char* name, casadi_int index=-1)
+        : name_(Profiler::is_active() ? name : nullptr), index_(index), start_(0) {
+        if (name_) start_ = Profiler::now();
+      }
+      ~ProfilerScope() {
+        if (name_) Profiler::record(name_, index_, start_, Profiler::now());
+      }
+    private:
+      const char* name_;
+      casadi_int index_;
+      int64_t start_;
+  };
+  /// \endcond
+#endif // SWIG
+
+} // namespace casadi
+
+#endif // CASADI_PROFILER_HPP
@@ -32,7 +32,8 @@ void casadi_blazing_1d_boor_eval(T1* f, T1* J, T1* H, const T1* all_knots, const
   const T1* inv2_0 = 0; const T1* inv3_0 = 0;
   // For 1D the cache slice is just the global cache.
   starts[0] = casadi_blazing_boor_init<T1>(all_x[0], all_knots, all_knots_cache,
-      offset[0], offset[1], lookup_mode[0], &boor0_d0, &boor0_d1, &boor0_d2, &inv2_0, &inv3_0);
+      offset[0], offset[1], lookup_mode[0], starts[0],
+      &boor0_d0, &boor0_d1, &boor0_d2, &inv2_0, &inv3_0);
 
   const T1* C = c+starts[0];
   if (f) {
@@ -43,9 +43,9 @@ void casadi_blazing_2d_boor_eval(T1* f, T1* J, T1* H, const T1* all_knots, const
   const T1* dim_cache1 = all_knots_cache
       ? all_knots_cache + 2 + 3*(offset[1] - offset[0]) : 0;
   starts[0] = casadi_blazing_boor_init<T1>(all_x[0], all_knots, dim_cache0,
-      offset[0], offset[1], lookup_mode[0], &d0[0], &d1[0], &d2[0], &inv2[0], &inv3[0]);
+      offset[0], offset[1], lookup_mode[0], starts[0], &d0[0], &d1[0], &d2[0], &inv2[0], &inv3[0]);
   starts[1] = casadi_blazing_boor_init<T1>(all_x[1], all_knots, dim_cache1,
-      offset[1], offset[2], lookup_mode[1], &d0[1], &d1[1], &d2[1], &inv2[1], &inv3[1]);
+      offset[1], offset[2], lookup_mode[1], starts[1], &d0[1], &d1[1], &d2[1], &inv2[1], &inv3[1]);
 
   // Load coefficient sub-tensor (same C used for value and all NPC derivatives)
   simde__m256d C[4];
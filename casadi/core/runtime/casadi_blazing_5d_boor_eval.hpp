@@ -39,7 +39,8 @@ void casadi_blazing_5d_boor_eval(T1* f, T1* J, T1* H, const T1* all_knots, const
   const T1* dim_cache = all_knots_cache;
   for (int i = 0; i < 5; ++i) {
     starts[i] = casadi_blazing_boor_init<T1>(all_x[i], all_knots, dim_cache,
-        offset[i], offset[i+1], lookup_mode[i], &d0[i], &d1[i], &d2[i], &inv2[i], &inv3[i]);
+        offset[i], offset[i+1], lookup_mode[i], starts[i],
+        &d0[i], &d1[i], &d2[i], &inv2[i], &inv3[i]);
     n_b[i] = offset[i+1] - offset[i] - 3 - 1;
     if (dim_cache) dim_cache += 2 + 3 * (offset[i+1] - offset[i]);
   }
@@ -47,10 +47,14 @@
 //   lookup_mode = 2 (binary): branchless bisection via cmov (data-dependent
 //                             updates only, no mispredictable branches inside
 //                             the loop).
+//   lookup_mode = 3 (hunt):   casadi_low_hunt starting from the interval
+//                             `hint` found by the previous call.
 template<typename T1>
 casadi_int casadi_blazing_low(T1 x, const T1* grid, casadi_int ng,
-                              casadi_int lookup_mode, const T1* grid_inv) {
+                              casadi_int lookup_mode, const T1* grid_inv, casadi_int hint) {
   switch (lookup_mode) {
+    case 3:
+      return casadi_low_hunt(x, grid, ng, hint);
     case 1:
       {
         // 'exact' --- uniform-grid direct lookup
@@ -294,11 +298,12 @@ simde__m256d casadi_blazing_knot_scale(simde__m256d degree, simde__m256d t_hi, s
 //
 // If inv2_out/inv3_out are non-NULL, they receive pre-positioned derivative
 // base pointers that can be passed directly to dbasis/d2basis.
+// `hint` is the start index of the previous call, used by 'hunt' lookup.
 template<typename T1>
 casadi_int casadi_blazing_boor_init(
     T1 x, const T1* all_knots, const T1* dim_cache,
     casadi_int knot_offset, casadi_int knot_offset_next,
-    casadi_int lookup_mode,
+    casadi_int lookup_mode, casadi_int hint,
     simde__m256d* d0, simde__m256d* d1, simde__m256d* d2,
     const T1** inv2_out, const T1** inv3_out) {
     casadi_int degree = 3;
@@ -309,7 +314,7 @@ casadi_int casadi_blazing_boor_init(
     const T1* grid_inv = dim_cache;
     casadi_int L = casadi_blazing_low<T1>(x, knots + degree,
                                           n_knots - 2*degree,
-                                          lookup_mode, grid_inv);
+                                          lookup_mode, grid_inv, hint);
     casadi_int start = L;
     if (start > n_b - degree - 1) start = n_b - degree - 1;
 
@@ -31,8 +31,12 @@ void casadi_interpn_weights(casadi_int ndim, const T1* grid, const casadi_int* o
     // Grid
     g = grid + offset[i];
     ng = offset[i+1]-offset[i];
-    // Find left index
-    j = index[i] = casadi_low(xi, g, ng, lookup_mode[i]);
+    // Find left index, hunting from the previous one if requested
+    if (lookup_mode[i]==3) {
+      j = index[i] = casadi_low_hunt(xi, g, ng, index[i]);
+    } else {
+      j = index[i] = casadi_low(xi, g, ng, lookup_mode[i]);
+    }
     // Get interpolation/extrapolation alpha
     alpha[i] = (xi-g[j])/(g[j+1]-g[j]);
   }
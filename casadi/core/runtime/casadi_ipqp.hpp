@@ -25,6 +25,7 @@
 // C-REPLACE "std::numeric_limits<T1>::infinity()" "casadi_inf"
 // C-REPLACE "static_cast<int>" "(int) "
 // C-REPLACE "nullptr" "0"
+// C-REPLACE "std::sqrt" "sqrt"
 
 // SYMBOL "ipqp_prob"
 template<typename T1>
@@ -75,7 +76,7 @@ typedef enum {
   IPQP_FACTOR,
   IPQP_SOLVE} casadi_ipqp_task_t;
 
-// SYMBOL "ipqp_task_t"
+// SYMBOL "ipqp_next_t"
 typedef enum {
   IPQP_RESET,
   IPQP_RESIDUAL,
@@ -535,47 +536,6 @@ int casadi_ipqp_maxstep(casadi_ipqp_data<T1>* d, T1* alpha, casadi_int* ind) {
   return flag;
 }
 
-// SYMBOL "ipqp_predictor"
-template<typename T1>
-void casadi_ipqp_predictor(casadi_ipqp_data<T1>* d) {
-  // Local variables
-  casadi_int k;
-  T1 t, alpha, sigma;
-  const casadi_ipqp_prob<T1>* p = d->prob;
-  // Scale results
-  for (k=0; k<p->nz; ++k) d->dz[k] *= d->S[k];
-  // Calculate step in z(g), lam(g)
-  for (k=p->nx; k<p->nz; ++k) {
-    if (d->S[k] == 0.) {
-      // Eliminate
-      d->dlam[k] = d->dz[k] = 0;
-    } else {
-      t = d->D[k] / (d->S[k] * d->S[k]) * (d->dz[k] - d->dlam[k]);
-      d->dlam[k] = d->dz[k];
-      d->dz[k] = t;
-    }
-  }
-  // Finish calculation in dlam_lbz, dlam_ubz
-  for (k=0; k<p->nz; ++k) {
-    d->dlam_lbz[k] -= d->lam_lbz[k] * d->dz[k];
-    d->dlam_lbz[k] *= d->dinv_lbz[k];
-  }
-  for (k=0; k<p->nz; ++k) {
-    d->dlam_ubz[k] += d->lam_ubz[k] * d->dz[k];
-    d->dlam_ubz[k] *= d->dinv_ubz[k];
-  }
-  // Finish calculation of dlam(x)
-  for (k=0; k<p->nx; ++k) d->dlam[k] += d->dlam_ubz[k] - d->dlam_lbz[k];
-  // Maximum primal and dual step
-  (void)casadi_ipqp_maxstep(d, &alpha, 0);
-  // Calculate sigma
-  sigma = casadi_ipqp_sigma(d, alpha);
-  // Prepare corrector step
-  casadi_ipqp_corrector_prepare(d, -sigma * d->mu);
-  // Solve to get step
-  d->linsys = d->rz;
-}
-
 // SYMBOL "ipqp_step"
 template<typename T1>
 void casadi_ipqp_step(casadi_ipqp_data<T1>* d, T1 alpha_pr, T1 alpha_du) {
@@ -660,6 +620,47 @@ void casadi_ipqp_corrector_prepare(casadi_ipqp_data<T1>* d, T1 shift) {
   for (k=0; k<p->nz; ++k) d->rz[k] *= -d->S[k];
 }
 
+// SYMBOL "ipqp_predictor"
+template<typename T1>
+void casadi_ipqp_predictor(casadi_ipqp_data<T1>* d) {
+  // Local variables
+  casadi_int k;
+  T1 t, alpha, sigma;
+  const casadi_ipqp_prob<T1>* p = d->prob;
+  // Scale results
+  for (k=0; k<p->nz; ++k) d->dz[k] *= d->S[k];
+  // Calculate step in z(g), lam(g)
+  for (k=p->nx; k<p->nz; ++k) {
+    if (d->S[k] == 0.) {
+      // Eliminate
+      d->dlam[k] = d->dz[k] = 0;
+    } else {
+      t = d->D[k] / (d->S[k] * d->S[k]) * (d->dz[k] - d->dlam[k]);
+      d->dlam[k] = d->dz[k];
+      d->dz[k] = t;
+    }
+  }
+  // Finish calculation in dlam_lbz, dlam_ubz
+  for (k=0; k<p->nz; ++k) {
+    d->dlam_lbz[k] -= d->lam_lbz[k] * d->dz[k];
+    d->dlam_lbz[k] *= d->dinv_lbz[k];
+  }
+  for (k=0; k<p->nz; ++k) {
+    d->dlam_ubz[k] += d->lam_ubz[k] * d->dz[k];
+    d->dlam_ubz[k] *= d->dinv_ubz[k];
+  }
+  // Finish calculation of dlam(x)
+  for (k=0; k<p->nx; ++k) d->dlam[k] += d->dlam_ubz[k] - d->dlam_lbz[k];
+  // Maximum primal and dual step
+  (void)casadi_ipqp_maxstep(d, &alpha, 0);
+  // Calculate sigma
+  sigma = casadi_ipqp_sigma(d, alpha);
+  // Prepare corrector step
+  casadi_ipqp_corrector_prepare(d, -sigma * d->mu);
+  // Solve to get step
+  d->linsys = d->rz;
+}
+
 // SYMBOL "ipqp_corrector"
 template<typename T1>
 void casadi_ipqp_corrector(casadi_ipqp_data<T1>* d) {
@@ -107,3 +107,107 @@ void casadi_ldl_solve(T1* x, casadi_int nrhs, const casadi_int* sp_lt, const T1*
     x += n;
   }
 }
+
+// SYMBOL "ldl_batch"
+// LDL^T factorization of nb matrices with the sparsity pattern sp_a, sharing
+// the symbolic factorization sp_lt, p. All nonzeros are interleaved: nonzero k
+// of matrix l is a[k*nb+l], and likewise for lt and d.
+// len[w] >= n*nb
+template<typename T1>
+void casadi_ldl_batch(const casadi_int* sp_a, const T1* a, const casadi_int* sp_lt, T1* lt,
+                      T1* d, const casadi_int* p, T1* w, casadi_int nb) {
+  const casadi_int *lt_colind, *lt_row, *a_colind, *a_row;
+  casadi_int n, r, c, c1, k, k2, l;
+  T1 *lt_k, *w_r, *d_c;
+  const T1 *lt_k2, *w_k2, *d_r;
+  // Extract sparsities
+  n=sp_lt[1];
+  lt_colind=sp_lt+2; lt_row=sp_lt+2+n+1;
+  a_colind=sp_a+2; a_row=sp_a+2+n+1;
+  // Clear w
+  for (r=0; r<n*nb; ++r) w[r] = 0;
+  // Sparse copy of A to L and D
+  for (c=0; c<n; ++c) {
+    c1 = p[c];
+    for (k=a_colind[c1]; k<a_colind[c1+1]; ++k) {
+      for (l=0; l<nb; ++l) w[a_row[k]*nb+l] = a[k*nb+l];
+    }
+    for (k=lt_colind[c]; k<lt_colind[c+1]; ++k) {
+      for (l=0; l<nb; ++l) lt[k*nb+l] = w[p[lt_row[k]]*nb+l];
+    }
+    for (l=0; l<nb; ++l) d[c*nb+l] = w[p[c]*nb+l];
+    for (k=a_colind[c1]; k<a_colind[c1+1]; ++k) {
+      for (l=0; l<nb; ++l) w[a_row[k]*nb+l] = 0;
+    }
+  }
+  // Loop over columns of L
+  for (c=0; c<n; ++c) {
+    d_c = d + c*nb;
+    for (k=lt_colind[c]; k<lt_colind[c+1]; ++k) {
+      r = lt_row[k];
+      lt_k = lt + k*nb;
+      w_r = w + r*nb;
+      d_r = d + r*nb;
+      // Calculate l(r,c) with r<c
+      for (k2=lt_colind[r]; k2<lt_colind[r+1]; ++k2) {
+        lt_k2 = lt + k2*nb;
+        w_k2 = w + lt_row[k2]*nb;
+        for (l=0; l<nb; ++l) lt_k[l] -= lt_k2[l] * w_k2[l];
+      }
+      for (l=0; l<nb; ++l) {
+        w_r[l] = lt_k[l];
+        lt_k[l] /= d_r[l];
+        // Update d(c)
+        d_c[l] -= w_r[l]*lt_k[l];
+      }
+    }
+    // Clear w
+    for (k=lt_colind[c]; k<lt_colind[c+1]; ++k) {
+      for (l=0; l<nb; ++l) w[lt_row[k]*nb+l] = 0;
+    }
+  }
+}
+
+// SYMBOL "ldl_solve_batch"
+// Solve nb LDL^T factorized systems, interleaved as in casadi_ldl_batch,
+// for one right-hand side each, x[i*nb+l] being entry i of system l
+// len[w] >= n*nb
+template<typename T1>
+void casadi_ldl_solve_batch(T1* x, const casadi_int* sp_lt, const T1* lt, const T1* d,
+                            const casadi_int* p, T1* w, casadi_int nb) {
+  const casadi_int *colind, *row;
+  casadi_int n, i, c, k, l;
+  T1 *w_c, *w_r;
+  const T1 *lt_k;
+  // Extract sparsity
+  n=sp_lt[1];
+  colind=sp_lt+2; row=sp_lt+2+n+1;
+  // Multiply by P
+  for (i=0; i<n; ++i) {
+    for (l=0; l<nb; ++l) w[i*nb+l] = x[p[i]*nb+l];
+  }
+  // Solve for L (forward substitution)
+  for (c=0; c<n; ++c) {
+    w_c = w + c*nb;
+    for (k=colind[c]; k<colind[c+1]; ++k) {
+      lt_k = lt + k*nb;
+      w_r = w + row[k]*nb;
+      for (l=0; l<nb; ++l) w_c[l] -= lt_k[l]*w_r[l];
+    }
+  }
+  // Divide by D
+  for (i=0; i<n*nb; ++i) w[i] /= d[i];
+  // Solve for L' (backward substitution)
+  for (c=n-1; c>=0; --c) {
+    w_c = w + c*nb;
+    for (k=colind[c+1]-1; k>=colind[c]; --k) {
+      lt_k = lt + k*nb;
+      w_r = w + row[k]*nb;
+      for (l=0; l<nb; ++l) w_r[l] -= lt_k[l]*w_c[l];
+    }
+  }
+  // Multiply by P'
+  for (i=0; i<n; ++i) {
+    for (l=0; l<nb; ++l) x[p[i]*nb+l] = w[i*nb+l];
+  }
+}
@@ -34,6 +34,7 @@ casadi_int casadi_low(T1 x, const T1* grid, casadi_int ng, casadi_int lookup_mod
         return ret;
       }
     case 2:
+    case 3: // hunt, without a previous interval to start from
       {
         casadi_int start, stop, pivot;
         // Quick return
@@ -63,3 +64,52 @@ casadi_int casadi_low(T1 x, const T1* grid, casadi_int ng, casadi_int lookup_mod
       }
   }
 }
+
+// SYMBOL "low_hunt"
+template<typename T1>
+casadi_int casadi_low_hunt(T1 x, const T1* grid, casadi_int ng, casadi_int i) {
+  casadi_int lo, hi, mid, step;
+  // Quick return
+  if (ng<2 || x<grid[1]) return 0;
+  if (x>=grid[ng-2]) return ng-2;
+  // Start from the previous interval
+  if (i<1) i = 1;
+  if (i>ng-3) i = ng-3;
+  // Expand a bracket grid[lo] <= x < grid[hi] in steps 1, 2, 4, ...
+  step = 1;
+  if (x>=grid[i]) {
+    lo = i;
+    hi = i+1;
+    while (x>=grid[hi]) {
+      lo = hi;
+      hi = lo + step;
+      step *= 2;
+      if (hi>=ng-2) {
+        hi = ng-2;
+        break;
+      }
+    }
+  } else {
+    hi = i;
+    lo = i-1;
+    while (x<grid[lo]) {
+      hi = lo;
+      lo = hi - step;
+      step *= 2;
+      if (lo<=1) {
+        lo = 1;
+        break;
+      }
+    }
+  }
+  // Bisection within the bracket
+  while (hi-lo>1) {
+    mid = (lo+hi)/2;
+    if (x<grid[mid]) {
+      hi = mid;
+    } else {
+      lo = mid;
+    }
+  }
+  return lo;
+}
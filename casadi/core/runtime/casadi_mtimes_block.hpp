@@ -0,0 +1,41 @@
+//
+//    MIT No Attribution
+//
+//    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl, KU Leuven.
+//
+//    Permission is hereby granted, free of charge, to any person obtaining a copy of this
+//    software and associated documentation files (the "Software"), to deal in the Software
+//    without restriction, including without limitation the rights to use, copy, modify,
+//    merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+//    permit persons to whom the Software is furnished to do so.
+//
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+//    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+//    PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//    OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+// SYMBOL "mtimes_block"
+// z += x*y as a list of n dense bs-by-bs block products; each entry of blocks
+// holds offset and leading dimension of the block in x, y and z
+template<typename T1>
+void casadi_mtimes_block(const T1* x, const T1* y, T1* z, casadi_int bs, casadi_int n,
+    const casadi_int* blocks) {
+  casadi_int l, i, j, k, ldx, ldy, ldz;
+  const T1 *xb, *yb;
+  T1 *zb, yk;
+  for (l = 0; l < n; ++l) {
+    xb = x + blocks[0]; ldx = blocks[1];
+    yb = y + blocks[2]; ldy = blocks[3];
+    zb = z + blocks[4]; ldz = blocks[5];
+    for (j = 0; j < bs; ++j) {
+      for (k = 0; k < bs; ++k) {
+        yk = yb[k + j * ldy];
+        for (i = 0; i < bs; ++i) zb[i + j * ldz] += xb[i + k * ldx] * yk;
+      }
+    }
+    blocks += 6;
+  }
+}
@@ -0,0 +1,32 @@
+//
+//    MIT No Attribution
+//
+//    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl, KU Leuven.
+//
+//    Permission is hereby granted, free of charge, to any person obtaining a copy of this
+//    software and associated documentation files (the "Software"), to deal in the Software
+//    without restriction, including without limitation the rights to use, copy, modify,
+//    merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+//    permit persons to whom the Software is furnished to do so.
+//
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+//    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+//    PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//    OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+// SYMBOL "mtimes_plan"
+// z += x*y with a precomputed product plan: nonzero iz[i] of z accumulates
+// x[ix[k]]*y[iy[k]] for k in ptr[i] ... ptr[i+1]
+template<typename T1>
+void casadi_mtimes_plan(const T1* x, const T1* y, T1* z, casadi_int n,
+    const casadi_int* iz, const casadi_int* ptr, const casadi_int* ix, const casadi_int* iy) {
+  casadi_int i, k;
+  for (i = 0; i < n; ++i) {
+    T1 s = z[iz[i]];
+    for (k = ptr[i]; k < ptr[i + 1]; ++k) s += x[ix[k]] * y[iy[k]];
+    z[iz[i]] = s;
+  }
+}
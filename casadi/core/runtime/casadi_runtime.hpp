@@ -103,6 +103,17 @@ namespace casadi {
   void casadi_mtimes_dense_sparse(const T1* x, casadi_int nrow_x,
                                   const T1* y, const casadi_int* sp_y, T1* z);
 
+  /// Sparse matrix-matrix multiplication with a precomputed product plan: z <- z + x*y
+  template<typename T1>
+  void casadi_mtimes_plan(const T1* x, const T1* y, T1* z, casadi_int n,
+                          const casadi_int* iz, const casadi_int* ptr,
+                          const casadi_int* ix, const casadi_int* iy);
+
+  /// Block-sparse matrix-matrix multiplication: z <- z + x*y, as a list of dense block products
+  template<typename T1>
+  void casadi_mtimes_block(const T1* x, const T1* y, T1* z, casadi_int bs, casadi_int n,
+                           const casadi_int* blocks);
+
   /// Sparse matrix-vector multiplication: z <- z + x*y
   template<typename T1>
   void casadi_mv(const T1* x, const casadi_int* sp_x, const T1* y, T1* z, casadi_int tr);
@@ -275,6 +286,10 @@ namespace casadi {
   template<typename T1>
   casadi_int casadi_low(T1 x, const T1* grid, casadi_int ng, casadi_int lookup_mode);
 
+  // Find the interval to which a value belongs, starting from interval i
+  template<typename T1>
+  casadi_int casadi_low_hunt(T1 x, const T1* grid, casadi_int ng, casadi_int i);
+
   // Get weights for the multilinear interpolant
   template<typename T1>
   void casadi_interpn_weights(casadi_int ndim, const T1* grid, const casadi_int* offset,
@@ -398,6 +413,8 @@ namespace casadi {
   #include "casadi_mtimes.hpp"
   #include "casadi_mtimes_dense.hpp"
   #include "casadi_mtimes_dense_sparse.hpp"
+  #include "casadi_mtimes_plan.hpp"
+  #include "casadi_mtimes_block.hpp"
   #include "casadi_mv.hpp"
   #include "casadi_trilsolve.hpp"
   #include "casadi_triusolve.hpp"
@@ -167,6 +167,13 @@ namespace casadi {
     /// Evaluate the function numerically
     int eval(const double** arg, double** res, casadi_int* iw, double* w) const override;
 
+    /// Solve all instances at once if the linear solver keeps several factorizations
+    bool has_eval_batch() const override;
+
+    /// Evaluate n instances with nfact_batch and solve_batch
+    int eval_batch(const double** arg, double** res, casadi_int* iw, double* w,
+                   casadi_int n, casadi_int stride) const override;
+
     /// Evaluate the function symbolically (SX)
     int eval_sx(const SXElem** arg, SXElem** res, casadi_int* iw, SXElem* w) const override;
 
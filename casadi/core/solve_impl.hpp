@@ -72,6 +72,37 @@ namespace casadi {
     return 0;
   }
 
+  template<bool Tr>
+  bool LinsolCall<Tr>::has_eval_batch() const {
+    return linsol_->has_batch();
+  }
+
+  template<bool Tr>
+  int LinsolCall<Tr>::eval_batch(const double** arg, double** res, casadi_int* iw, double* w,
+      casadi_int n, casadi_int stride) const {
+    if (arg[0] != res[0]) {
+      for (casadi_int k=0; k<n; ++k) {
+        std::copy_n(arg[0] + k*stride, this->dep(0).nnz(), res[0] + k*stride);
+      }
+    }
+    scoped_checkout<Linsol> mem(linsol_);
+
+    auto m = static_cast<LinsolMemory*>(linsol_->memory(mem));
+    // Reset statistics
+    for (auto&& s : m->fstats) s.second.reset();
+    if (m->t_total) m->t_total->tic();
+
+    // One symbolic factorization, n numeric factorizations
+    if (linsol_.sfact(arg[1], mem)) return 1;
+    if (linsol_.nfact_batch(arg[1], n, mem, stride)) return 1;
+    if (linsol_.solve_batch(arg[1], res[0], n, this->dep(0).size2(), Tr, mem,
+                            stride, stride)) return 1;
+
+    linsol_->print_time(m->fstats);
+
+    return 0;
+  }
+
   template<bool Tr>
   int LinsolCall<Tr>::eval_sx(const SXElem** arg, SXElem** res, casadi_int* iw, SXElem* w) const {
     linsol_->linsol_eval_sx(arg, res, iw, w, linsol_->memory(0), Tr, this->dep(0).size2());
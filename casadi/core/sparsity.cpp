@@ -30,6 +30,7 @@
 #include "serializing_stream.hpp"
 #include "filesystem_impl.hpp"
 #include <climits>
+#include <cstdint>
 
 #define CASADI_THROW_ERROR(FNAME, WHAT) \
 throw CasadiException("Error in Sparsity::" FNAME " at " + CASADI_WHERE + ":\n"\
@@ -522,9 +523,9 @@ namespace casadi {
     }
   }
 
-  Sparsity::CachingMap& Sparsity::getCache() {
-    static CachingMap ret;
-    return ret;
+  Sparsity::CacheShard& Sparsity::getCache(std::size_t h) {
+    static CacheShard ret[n_cache_shards];
+    return ret[h % n_cache_shards];
   }
 
   const Sparsity& Sparsity::getScalar() {
@@ -808,6 +809,14 @@ namespace casadi {
     return (*this)->is_compactible(row, col);
   }
 
+  bool Sparsity::is_block(casadi_int bs) const {
+    return (*this)->is_block(bs);
+  }
+
+  casadi_int Sparsity::block_size() const {
+    return (*this)->block_size();
+  }
+
   std::size_t Sparsity::hash() const {
     return (*this)->hash();
   }
@@ -889,14 +898,15 @@ namespace casadi {
     // Hash the pattern
     std::size_t h = hash_sparsity(nrow, ncol, colind, row);
 
+    // Get the part of the cache holding this hash value
+    CacheShard& shard = getCache(h);
+    CachingMap& cache = shard.map;
+
 #ifdef CASADI_WITH_THREADSAFE_SYMBOLICS
-    // Safe access to CachingMap
-    std::lock_guard<std::mutex> lock(cachingmap_mtx);
+    // Safe access to the shard, other shards remain available to other threads
+    std::lock_guard<std::mutex> lock(shard.mtx);
 #endif // CASADI_WITH_THREADSAFE_SYMBOLICS
 
-    // Get a reference to the cache
-    CachingMap& cache = getCache();
-
     // Record the current number of buckets (for garbage collection below)
     casadi_int bucket_count_before = cache.bucket_count();
 
@@ -971,12 +981,14 @@ namespace casadi {
 
     // Cache this pattern
     cache.insert(std::pair<std::size_t, WeakRef>(h, *this));
+    shard.n_insert++;
 
     // Garbage collection (currently only supported for unordered_multimap)
     casadi_int bucket_count_after = cache.bucket_count();
 
-    // We we increased the number of buckets, take time to garbage-collect deleted references
-    if (bucket_count_before!=bucket_count_after) {
+    // Take time to garbage-collect deleted references if we increased the number of buckets,
+    // or, amortized over the insertions, once the shard has been refilled
+    if (bucket_count_before!=bucket_count_after || 2*shard.n_insert>cache.size()) {
       CachingMap::const_iterator i=cache.begin();
       while (i!=cache.end()) {
         if (!i->second.alive()) {
@@ -985,13 +997,10 @@ namespace casadi {
           i++;
         }
       }
+      shard.n_insert = 0;
     }
   }
 
-#ifdef CASADI_WITH_THREADSAFE_SYMBOLICS
-  std::mutex Sparsity::cachingmap_mtx;
-#endif //CASADI_WITH_THREADSAFE_SYMBOLICS
-
   Sparsity Sparsity::tril(const Sparsity& x, bool includeDiagonal) {
     return x->_tril(includeDiagonal);
   }
@@ -1009,6 +1018,26 @@ namespace casadi {
   }
 
 
+  /* Hash an integer array in four independent lanes, avoiding the serial dependency
+   * of hash_combine on every element
+   */
+  static std::size_t hash_lanes(const casadi_int* v, casadi_int n) {
+    const std::uint64_t m = 0x9e3779b97f4a7c15ULL;
+    std::uint64_t h0 = 1, h1 = 2, h2 = 3, h3 = 4;
+    casadi_int i = 0;
+    for (; i+4<=n; i+=4) {
+      h0 = (h0 ^ static_cast<std::uint64_t>(v[i])) * m;
+      h1 = (h1 ^ static_cast<std::uint64_t>(v[i+1])) * m;
+      h2 = (h2 ^ static_cast<std::uint64_t>(v[i+2])) * m;
+      h3 = (h3 ^ static_cast<std::uint64_t>(v[i+3])) * m;
+    }
+    for (; i<n; ++i) h0 = (h0 ^ static_cast<std::uint64_t>(v[i])) * m;
+    // Combine the lanes and let the high bits affect the low bits
+    std::uint64_t h = h0 ^ (h1 << 16 | h1 >> 48) ^ (h2 << 32 | h2 >> 32) ^ (h3 << 48 | h3 >> 16);
+    h = (h ^ h >> 32) * m;
+    return static_cast<std::size_t>(h ^ h >> 29);
+  }
+
   std::size_t hash_sparsity(casadi_int nrow, casadi_int ncol, const std::vector<casadi_int>& colind,
                             const std::vector<casadi_int>& row) {
     return hash_sparsity(nrow, ncol, get_ptr(colind), get_ptr(row));
@@ -1020,8 +1049,8 @@ namespace casadi {
     std::size_t ret=0;
     hash_combine(ret, nrow);
     hash_combine(ret, ncol);
-    hash_combine(ret, colind, ncol+1);
-    hash_combine(ret, row, colind[ncol]);
+    hash_combine(ret, hash_lanes(colind, ncol+1));
+    hash_combine(ret, hash_lanes(row, colind[ncol]));
     return ret;
   }
 
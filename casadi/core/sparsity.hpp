@@ -606,6 +606,18 @@ namespace casadi {
     bool is_compactible(std::vector<casadi_int>& SWIG_OUTPUT(row),
                         std::vector<casadi_int>& SWIG_OUTPUT(col)) const;
 
+    /** \brief Check if the pattern consists of dense, aligned bs-by-bs blocks
+
+        Block (I, J) covers rows I*bs ... I*bs+bs-1 and columns J*bs ... J*bs+bs-1.
+        In CCS, each column of such a block is a contiguous run of bs nonzeros and
+        all columns of a block column share the same leading dimension.
+    */
+    bool is_block(casadi_int bs) const;
+
+    /** \brief Largest block size bs for which is_block(bs) holds, 1 if none
+    */
+    casadi_int block_size() const;
+
     /// @{
     /** \brief Combine two sparsity patterns
 
@@ -923,13 +935,23 @@ namespace casadi {
 #ifndef SWIG
     typedef std::unordered_multimap<std::size_t, WeakRef> CachingMap;
 
-    /// Cached sparsity patterns
-    static CachingMap& getCache();
-
+    /// Part of the sparsity pattern cache, selected by hash value
+    struct alignas(64) CacheShard {
+      // Cached sparsity patterns
+      CachingMap map;
+      // Insertions since expired entries were last removed
+      casadi_int n_insert = 0;
 #ifdef CASADI_WITH_THREADSAFE_SYMBOLICS
-    // Safe access to CachingMap
-    static std::mutex cachingmap_mtx;
+      // Safe access to map
+      std::mutex mtx;
 #endif //CASADI_WITH_THREADSAFE_SYMBOLICS
+    };
+
+    /// Number of cache shards
+    static const casadi_int n_cache_shards = 64;
+
+    /// Cache shard holding the sparsity patterns with a given hash value
+    static CacheShard& getCache(std::size_t h);
 
     /// (Dense) scalar
     static const Sparsity& getScalar();
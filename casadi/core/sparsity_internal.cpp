@@ -2327,8 +2327,30 @@ namespace casadi {
 
   Sparsity SparsityInternal::combine(const Sparsity& y, bool f0x_is_zero,
                                             bool function0_is_zero) const {
-    static std::vector<unsigned char> mapping;
-    return combineGen1<false>(y, f0x_is_zero, function0_is_zero, mapping);
+    // Quick return if identical
+    if (is_equal(y)) return y;
+
+    // Reuse the last result, if the argument is the same
+    CombineCache& c = combine_cache_[2*f0x_is_zero + function0_is_zero];
+    {
+#ifdef CASADI_WITH_THREADSAFE_SYMBOLICS
+      std::lock_guard<std::mutex> lock(combine_mtx_);
+#endif // CASADI_WITH_THREADSAFE_SYMBOLICS
+      SharedObject c_y, c_ret;
+      if (c.y.shared_if_alive(c_y) && c_y.get()==y.get() && c.ret.shared_if_alive(c_ret)) {
+        return shared_cast<Sparsity>(c_ret);
+      }
+    }
+
+    // Calculate and cache the result
+    std::vector<unsigned char> mapping;
+    Sparsity ret = combineGen1<false>(y, f0x_is_zero, function0_is_zero, mapping);
+#ifdef CASADI_WITH_THREADSAFE_SYMBOLICS
+    std::lock_guard<std::mutex> lock(combine_mtx_);
+#endif // CASADI_WITH_THREADSAFE_SYMBOLICS
+    c.y = y;
+    c.ret = ret;
+    return ret;
   }
 
   Sparsity SparsityInternal::combine(const Sparsity& y, bool f0x_is_zero,
@@ -3694,6 +3716,40 @@ namespace casadi {
     return nnz() == static_cast<casadi_int>(row.size() * col.size());
   }
 
+  bool SparsityInternal::is_block(casadi_int bs) const {
+    if (bs<1 || size1() % bs || size2() % bs) return false;
+    const casadi_int* colind = this->colind();
+    const casadi_int* row = this->row();
+    for (casadi_int c=0; c<size2(); ++c) {
+      if (c % bs) {
+        // Same pattern as the first column of the block column
+        casadi_int c0 = c - c % bs;
+        if (colind[c+1]-colind[c] != colind[c0+1]-colind[c0]) return false;
+        if (!std::equal(row+colind[c], row+colind[c+1], row+colind[c0])) return false;
+      } else {
+        // Runs of bs consecutive rows, starting at a multiple of bs
+        for (casadi_int k=colind[c]; k<colind[c+1]; k+=bs) {
+          if (row[k] % bs || k+bs>colind[c+1] || row[k+bs-1]-row[k]!=bs-1) return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  casadi_int SparsityInternal::block_size() const {
+    // Candidates: divisors of both dimensions, largest first
+    casadi_int g = size1(), r = size2();
+    while (r) {
+      casadi_int t = g % r;
+      g = r;
+      r = t;
+    }
+    for (casadi_int bs=g; bs>1; --bs) {
+      if (g % bs==0 && is_block(bs)) return bs;
+    }
+    return 1;
+  }
+
   void SparsityInternal::spy(std::ostream &stream) const {
 
     // Index counter for each column
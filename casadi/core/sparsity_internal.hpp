@@ -78,6 +78,21 @@ namespace casadi {
     mutable std::mutex btf_mtx_;
 #endif // CASADI_WITH_THREADSAFE_SYMBOLICS
 
+    /// Argument and result of the last combine call (weak, to avoid reference cycles)
+    struct CombineCache {
+      WeakRef y, ret;
+    };
+
+    /** \brief Last combine result for each combination of flags
+
+      Repeated elementwise operations on the same pair of patterns reuse it */
+    mutable CombineCache combine_cache_[4];
+
+#ifdef CASADI_WITH_THREADSAFE_SYMBOLICS
+    /// Mutex for thread safety
+    mutable std::mutex combine_mtx_;
+#endif // CASADI_WITH_THREADSAFE_SYMBOLICS
+
   public:
     /// Construct a sparsity pattern from arrays
     SparsityInternal(casadi_int nrow, casadi_int ncol,
@@ -310,6 +325,12 @@ namespace casadi {
     /// Check if the nonzero pattern is a Cartesian product (row x col)
     bool is_compactible(std::vector<casadi_int>& row, std::vector<casadi_int>& col) const;
 
+    /// Check if the pattern consists of dense, aligned bs-by-bs blocks
+    bool is_block(casadi_int bs) const;
+
+    /// Largest block size, 1 if none
+    casadi_int block_size() const;
+
     /** \brief Breadth-first search for coarse decomposition
 
       * The implementation is a modified version of cs_bfs in CSparse
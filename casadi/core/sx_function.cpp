@@ -30,6 +30,8 @@
 #include <sstream>
 #include <iomanip>
 #include <bitset>
+#include <array>
+#include <unordered_map>
 #include "sx_node.hpp"
 #include "output_sx.hpp"
 #include "call_sx.hpp"
@@ -69,11 +71,8 @@ namespace casadi {
     clear_mem();
   }
 
-  int SXFunction::eval(const double** arg, double** res,
-      casadi_int* iw, double* w, void* mem) const {
-    if (verbose_) casadi_message(name_ + "::eval");
-    setup(mem, arg, res, iw, w);
-
+  template<typename T>
+  int SXFunction::eval_gen(const T** arg, T** res, casadi_int* iw, T* w) const {
     // Make sure no free parameters
     if (!free_vars_.empty()) {
       std::stringstream ss;
@@ -94,7 +93,7 @@ namespace casadi {
         switch (e.op) {
           CASADI_MATH_FUN_BUILTIN(w[e.i1], w[e.i2], w[e.i0])
 
-        case OP_CONST: w[e.i0] = e.d; break;
+        case OP_CONST: w[e.i0] = static_cast<T>(e.d); break;
         case OP_INPUT: w[e.i0] = arg[e.i1]==nullptr ? 0 : arg[e.i1][e.i2]; break;
         case OP_OUTPUT: if (res[e.i0]!=nullptr) res[e.i0][e.i2] = w[e.i1]; break;
         case OP_CALL:
@@ -112,7 +111,7 @@ namespace casadi {
         switch (e.op) {
           CASADI_MATH_FUN_BUILTIN(w[e.i1], w[e.i2], w[e.i0])
 
-        case OP_CONST: w[e.i0] = e.d; break;
+        case OP_CONST: w[e.i0] = static_cast<T>(e.d); break;
         case OP_INPUT: w[e.i0] = arg[e.i1]==nullptr ? 0 : arg[e.i1][e.i2]; break;
         case OP_OUTPUT: if (res[e.i0]!=nullptr) res[e.i0][e.i2] = w[e.i1]; break;
         case OP_CALL:
@@ -126,6 +125,19 @@ namespace casadi {
     return 0;
   }
 
+  int SXFunction::eval(const double** arg, double** res,
+      casadi_int* iw, double* w, void* mem) const {
+    if (verbose_) casadi_message(name_ + "::eval");
+    setup(mem, arg, res, iw, w);
+    return eval_gen(arg, res, iw, w);
+  }
+
+  int SXFunction::eval_single(const float** arg, float** res,
+      casadi_int* iw, float* w, void* mem) const {
+    if (verbose_) casadi_message(name_ + "::eval_single");
+    return eval_gen(arg, res, iw, w);
+  }
+
   bool SXFunction::is_smooth() const {
     // Go through all nodes and check if any node is non-smooth
     for (auto&& a : algorithm_) {
@@ -231,8 +243,9 @@ namespace casadi {
   }
 
 
+  template<typename T>
   void SXFunction::print_arg(std::ostream &stream, casadi_int k, const ScalarAtomic& el,
-      const double* w) const {
+      const T* w) const {
     if (el.op==OP_INPUT || el.op==OP_OUTPUT || el.op==OP_CONST) return;
     stream << name_ << ":" << k << ": " << print(el) << " inputs:" << std::endl;
 
@@ -301,8 +314,9 @@ namespace casadi {
     g << "\n";
   }
 
+  template<typename T>
   void SXFunction::print_res(std::ostream &stream, casadi_int k, const ScalarAtomic& el,
-      const double* w) const {
+      const T* w) const {
     if (el.op==OP_INPUT || el.op==OP_OUTPUT) return;
     stream << name_ << ":" << k << ": " << print(el) << " outputs:" << std::endl;
 
@@ -1568,6 +1582,232 @@ namespace casadi {
     }
   }
 
+  void SXFunction::second_der(casadi_int op, const SXElem& x, const SXElem& y,
+      const SXElem& f, SXElem* dd, std::map<casadi_int, Function>& cache) {
+    // Second order partials of the most common operations in closed form
+    switch (op) {
+      case OP_ASSIGN:
+      case OP_ADD:
+      case OP_SUB:
+      case OP_NEG:
+      case OP_TWICE:
+        dd[0] = dd[1] = dd[2] = 0;
+        return;
+      case OP_MUL:
+        dd[0] = dd[2] = 0;
+        dd[1] = 1;
+        return;
+      case OP_DIV:
+        dd[0] = 0;
+        dd[1] = -1/(y*y);
+        dd[2] = 2*f/(y*y);
+        return;
+      case OP_SQ:
+        dd[0] = 2;
+        dd[1] = dd[2] = 0;
+        return;
+      case OP_SQRT:
+        dd[0] = -1/(4*f*x);
+        dd[1] = dd[2] = 0;
+        return;
+      case OP_EXP:
+        dd[0] = f;
+        dd[1] = dd[2] = 0;
+        return;
+      case OP_LOG:
+        dd[0] = -1/(x*x);
+        dd[1] = dd[2] = 0;
+        return;
+      case OP_SIN:
+      case OP_COS:
+        dd[0] = -f;
+        dd[1] = dd[2] = 0;
+        return;
+      case OP_INV:
+        dd[0] = 2*f*f*f;
+        dd[1] = dd[2] = 0;
+        return;
+      case OP_TANH:
+        dd[0] = -2*f*(1-f*f);
+        dd[1] = dd[2] = 0;
+        return;
+      default:
+        break;
+    }
+    // Otherwise differentiate the first order partials of the operation symbolically
+    auto it = cache.find(op);
+    if (it==cache.end()) {
+      SX sx = SX::sym("x"), sy = SX::sym("y");
+      bool binary = casadi_math<double>::ndeps(op)==2;
+      SXElem sf = binary ? SXElem::binary(op, sx.scalar(), sy.scalar())
+                         : SXElem::unary(op, sx.scalar());
+      SXElem sd[2];
+      casadi_math<SXElem>::der(op, sx.scalar(), sy.scalar(), sf, sd);
+      SX xy = vertcat(sx, sy);
+      std::vector<SXElem> g0 = SX::gradient(SX(sd[0]), xy).nonzeros();
+      std::vector<SXElem> g1 = SX::gradient(SX(sd[1]), xy).nonzeros();
+      Function F("second_der", {sx, sy}, {SX(g0.at(0)), SX(g0.at(1)), SX(g1.at(1))});
+      it = cache.insert(std::make_pair(op, F)).first;
+    }
+    std::vector<SX> ret = it->second(std::vector<SX>{SX(x), SX(y)});
+    for (casadi_int k=0; k<3; ++k) dd[k] = ret[k].scalar();
+  }
+
+  SX SXFunction::hess_edge_pushing(SX& g) const {
+    if (verbose_) casadi_message(name_ + "::hess_edge_pushing");
+    casadi_assert(n_in_==1 && n_out_==1 && nnz_out(0)<=1,
+      "Edge pushing requires one input and a scalar output");
+    casadi_assert(call_.el.empty(), "Edge pushing not supported for call nodes");
+    const Sparsity& sp_x = sparsity_in_.at(0);
+    casadi_int n = sp_x.numel();
+
+    // Node (instruction index) most recently written to each work vector element
+    std::vector<casadi_int> writer(worksize_, -1);
+    // Dependencies, partials and second order partials of each node
+    std::vector<casadi_int> dep0(algorithm_.size(), -1), dep1(algorithm_.size(), -1);
+    std::vector<TapeEl<SXElem> > d(algorithm_.size());
+    std::vector<std::array<SXElem, 3> > dd(algorithm_.size());
+    // Nodes that are independent variables or constants
+    std::vector<bool> is_input(algorithm_.size(), false), is_const(algorithm_.size(), false);
+    // Cached symbolic second order partials
+    std::map<casadi_int, Function> cache;
+
+    // Forward sweep: record the graph and its local partials
+    casadi_int out_node = -1;
+    auto b_it = operations_.begin();
+    for (casadi_int k=0; k<algorithm_.size(); ++k) {
+      const AlgEl& e = algorithm_[k];
+      switch (e.op) {
+      case OP_INPUT:
+        is_input[k] = true;
+        writer[e.i0] = k;
+        break;
+      case OP_OUTPUT:
+        out_node = writer[e.i1];
+        break;
+      case OP_CONST:
+      case OP_PARAMETER:
+        is_const[k] = true;
+        writer[e.i0] = k;
+        break;
+      default:
+        {
+          const SXElem& f = *b_it++;
+          SXElem x = f->dep(0), y = f->dep(1);
+          casadi_math<SXElem>::der(e.op, x, y, f, d[k].d);
+          second_der(e.op, x, y, f, dd[k].data(), cache);
+          dep0[k] = writer[e.i1];
+          if (casadi_math<double>::ndeps(e.op)==2) dep1[k] = writer[e.i2];
+          writer[e.i0] = k;
+        }
+      }
+    }
+
+    // Adjoints and the symmetric matrix of second order adjoints, stored as rows
+    std::vector<SXElem> a(algorithm_.size(), 0);
+    std::vector<std::unordered_map<casadi_int, SXElem> > W(algorithm_.size());
+    auto add = [&](casadi_int p, casadi_int q, const SXElem& v) {
+      if (v.is_zero()) return;
+      auto ins = W[p].insert(std::make_pair(q, v));
+      if (!ins.second) ins.first->second += v;
+      if (p!=q) {
+        ins = W[q].insert(std::make_pair(p, v));
+        if (!ins.second) ins.first->second += v;
+      }
+    };
+    if (out_node>=0) a[out_node] = 1;
+
+    // Reverse sweep: push, create and propagate the adjoints
+    for (casadi_int i=algorithm_.size()-1; out_node>=0 && i>=0; --i) {
+      if (dep0[i]<0) continue;
+      // Distinct non-constant predecessors with their first and second order partials
+      casadi_int nj = 0, j[2];
+      SXElem dj[2], ddj[3];
+      if (dep1[i]==dep0[i]) {
+        j[nj] = dep0[i];
+        dj[nj++] = d[i].d[0] + d[i].d[1];
+        ddj[0] = dd[i][0] + 2*dd[i][1] + dd[i][2];
+      } else {
+        for (casadi_int c=0; c<2; ++c) {
+          casadi_int p = c==0 ? dep0[i] : dep1[i];
+          if (p<0 || is_const[p]) continue;
+          ddj[nj==0 ? 0 : 2] = dd[i][c==0 ? 0 : 2];
+          j[nj] = p;
+          dj[nj++] = d[i].d[c];
+        }
+        ddj[1] = dd[i][1];
+      }
+      if (nj==1 && is_const[j[0]]) nj = 0;
+      // Pushing
+      auto w_ii = W[i].find(i);
+      for (auto&& pw : W[i]) {
+        casadi_int p = pw.first;
+        if (p==i) continue;
+        for (casadi_int c=0; c<nj; ++c) {
+          add(j[c], p, j[c]==p ? 2*dj[c]*pw.second : dj[c]*pw.second);
+        }
+      }
+      if (w_ii!=W[i].end()) {
+        const SXElem& w = w_ii->second;
+        for (casadi_int c=0; c<nj; ++c) add(j[c], j[c], dj[c]*dj[c]*w);
+        if (nj==2) add(j[0], j[1], dj[0]*dj[1]*w);
+      }
+      // Creating
+      if (!a[i].is_zero()) {
+        if (nj>=1) add(j[0], j[0], a[i]*ddj[0]);
+        if (nj==2) {
+          add(j[0], j[1], a[i]*ddj[1]);
+          add(j[1], j[1], a[i]*ddj[2]);
+        }
+        // Adjoint
+        for (casadi_int c=0; c<nj; ++c) a[j[c]] += a[i]*dj[c];
+      }
+      // Node i has been eliminated
+      for (auto&& pw : W[i]) if (pw.first!=i) W[pw.first].erase(i);
+      W[i].clear();
+    }
+
+    // Collect the gradient and the Hessian in terms of the input nonzeros
+    std::vector<casadi_int> ind = sp_x.find();
+    std::vector<SXElem> g_nz(sp_x.nnz(), 0);
+    std::map<std::pair<casadi_int, casadi_int>, SXElem> H;
+    auto add_h = [&](casadi_int r, casadi_int c, const SXElem& v) {
+      auto ins = H.insert(std::make_pair(std::make_pair(c, r), v));
+      if (!ins.second) ins.first->second += v;
+    };
+    for (casadi_int p=0; p<algorithm_.size(); ++p) {
+      if (!is_input[p]) continue;
+      casadi_int r = algorithm_[p].i2;
+      g_nz[r] += a[p];
+      for (auto&& qw : W[p]) {
+        casadi_int q = qw.first;
+        if (q<p || !is_input[q]) continue;
+        casadi_int c = algorithm_[q].i2;
+        if (p!=q && r==c) {
+          add_h(ind[r], ind[r], 2*qw.second);
+        } else {
+          add_h(ind[r], ind[c], qw.second);
+          if (r!=c) add_h(ind[c], ind[r], qw.second);
+        }
+      }
+    }
+    g = SX(sp_x, g_nz);
+
+    // Assemble in compressed column format, (column, row) keys are already sorted
+    std::vector<casadi_int> colind(n+1, 0), row;
+    std::vector<SXElem> nz;
+    row.reserve(H.size());
+    nz.reserve(H.size());
+    for (auto&& h : H) {
+      colind[h.first.first+1]++;
+      row.push_back(h.first.second);
+      nz.push_back(h.second);
+    }
+    for (casadi_int c=0; c<n; ++c) colind[c+1] += colind[c];
+    return SX(Sparsity(n, n, colind, row), nz);
+  }
+
+
   template<typename T, typename CT>
   void SXFunction::call_setup(const ExtendedAlgEl& m,
     CT*** call_arg, T*** call_res, casadi_int** call_iw, T** call_w, T** nz_in, T** nz_out) const {
@@ -72,6 +72,10 @@ class CASADI_EXPORT SXFunction :
       \identifier{ue} */
   int eval(const double** arg, double** res, casadi_int* iw, double* w, void* mem) const override;
 
+  /** \brief  Evaluate numerically in single precision, work vectors given */
+  int eval_single(const float** arg, float** res, casadi_int* iw, float* w,
+    void* mem) const override;
+
   /** \brief  evaluate symbolically while also propagating directional derivatives
 
       \identifier{uf} */
@@ -100,6 +104,18 @@ class CASADI_EXPORT SXFunction :
   void ad_reverse(const std::vector<std::vector<SX> >& aseed,
                             std::vector<std::vector<SX> >& asens) const;
 
+  /** \brief Hessian and gradient of a scalar output by edge pushing
+
+      Sweeps the expression graph once in reverse, pushing second order
+      adjoints onto the predecessors of each node (Gower and Mello, 2012),
+      so that no sparsity pattern or coloring of the Hessian is needed.
+      The result is the full symmetric Hessian with respect to the input. */
+  SX hess_edge_pushing(SX& g) const;
+
+  /** \brief Second order partials (d00, d01, d11) of a scalar operation */
+  static void second_der(casadi_int op, const SXElem& x, const SXElem& y,
+    const SXElem& f, SXElem* dd, std::map<casadi_int, Function>& cache);
+
   /** \brief  Check if smooth
 
       \identifier{ui} */
@@ -109,15 +125,17 @@ class CASADI_EXPORT SXFunction :
   std::string print(const ScalarAtomic& a) const;
 
   // Print the input arguments of an instruction
+  template<typename T>
   void print_arg(std::ostream &stream, casadi_int k, const ScalarAtomic& el,
-    const double* w) const;
+    const T* w) const;
 
   // Print the input arguments of an instruction
   void print_arg(CodeGenerator& g, casadi_int k, const ScalarAtomic& el) const;
 
   // Print the output arguments of an instruction
+  template<typename T>
   void print_res(std::ostream &stream, casadi_int k, const ScalarAtomic& el,
-    const double* w) const;
+    const T* w) const;
 
   // Print the output arguments of an instruction
   void print_res(CodeGenerator& g, casadi_int k, const ScalarAtomic& el) const;
@@ -407,6 +425,12 @@ class CASADI_EXPORT SXFunction :
   bool live_variables_;
 
 protected:
+  using FunctionInternal::eval_gen;
+
+  /** \brief Numerical evaluation of the algorithm, double or single precision */
+  template<typename T>
+  int eval_gen(const T** arg, T** res, casadi_int* iw, T* w) const;
+
   template<typename T>
   void call_fwd(const AlgEl& e, const T** arg, T** res, casadi_int* iw, T* w) const;
 
@@ -1165,6 +1165,25 @@ namespace casadi {
   template<>
   SX CASADI_EXPORT SX::hessian(const SX &ex, const SX &arg, SX &g, const Dict& opts) {
     Dict all_opts = opts;
+    // Direct construction by edge pushing, no coloring needed
+    auto it = all_opts.find("edge_pushing");
+    if (it!=all_opts.end()) {
+      bool edge_pushing = it->second;
+      all_opts.erase(it);
+      if (edge_pushing && ex.is_scalar()) {
+        Dict h_opts;
+        auto h_it = all_opts.find("helper_options");
+        if (h_it!=all_opts.end()) h_opts = h_it->second;
+        h_opts["allow_free"] = true;
+        Function h("hess_helper", {arg}, {ex}, h_opts);
+        // Call nodes are left to the default algorithm
+        bool has_call = false;
+        for (casadi_int k=0; k<h.n_instructions() && !has_call; ++k) {
+          has_call = h.instruction_id(k)==OP_CALL;
+        }
+        if (!has_call) return h.get<SXFunction>()->hess_edge_pushing(g);
+      }
+    }
     if (!opts.count("symmetric")) all_opts["symmetric"] = true;
     g = gradient(ex, arg);
     return jacobian(g, arg, all_opts);
@@ -1660,6 +1679,14 @@ namespace casadi {
     return false;
   }
 
+  template<>
+  bool CASADI_EXPORT SX::simplify_algebraic(std::vector<SX>& arg,
+                                   std::vector<SX>& res,
+                                   const Dict& opts) {
+    // SXElem operations already apply these identities on construction
+    return false;
+  }
+
   template<>
   bool CASADI_EXPORT SX::simplify_ref_count(std::vector<SX>& arg,
                                    std::vector<SX>& res,
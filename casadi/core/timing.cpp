@@ -38,6 +38,7 @@ namespace casadi {
   }
 
   void FStats::tic() {
+    profile = name && Profiler::is_active();
     start_proc = std::clock();
     start_wall= high_resolution_clock::now();
   }
@@ -54,6 +55,13 @@ namespace casadi {
     t_wall += wall;
     n_call +=1;
 
+    // Record as a span
+    if (profile) {
+      Profiler::record(name, -1,
+        duration_cast<nanoseconds>(start_wall.time_since_epoch()).count(),
+        duration_cast<nanoseconds>(stop_wall.time_since_epoch()).count());
+    }
+
   }
 
   void FStats::join(FStats& rhs) {
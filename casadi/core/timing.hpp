@@ -27,6 +27,7 @@
 #define CASADI_TIMING_HPP
 
 #include "generic_type.hpp"
+#include "profiler.hpp"
 
 #include <chrono>
 #include <ctime>
@@ -80,6 +81,12 @@ namespace casadi {
       /// Accumulated proc time [s] since last reset
       double t_proc = 0;
 
+      /// Name of the span recorded by the profiler, if any
+      const char* name = nullptr;
+
+      /// Is the current measurement also recorded by the profiler?
+      bool profile = false;
+
       void join(FStats& rhs);
 
   };
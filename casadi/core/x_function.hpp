@@ -457,6 +457,8 @@ namespace casadi {
           allow_reverse = op.second;
         } else if (op.first=="verbose") {
           continue;
+        } else if (op.first=="edge_pushing") {
+          casadi_error("Option 'edge_pushing' applies to Hessians only");
         } else {
           casadi_error("No such Jacobian option: " + std::string(op.first));
         }
@@ -1077,6 +1079,8 @@ namespace casadi {
           MatType::simplify_ref_count(new_in, new_out);
         } else if (task=="const_folding") {
           MatType::simplify_const_folding(new_in, new_out);
+        } else if (task=="algebraic") {
+          MatType::simplify_algebraic(new_in, new_out);
         } else {
           casadi_error("No such simplify task: '" + task + "'.\n");
         }
@@ -0,0 +1,244 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+#include "xml_reader.hpp"
+#include "casadi_misc.hpp"
+#include <cctype>
+#include <cstring>
+
+namespace casadi {
+
+XmlReader::XmlReader(std::istream& stream) : buf_(stream.rdbuf()), line_(1), empty_(false) {
+  casadi_assert(buf_ != nullptr, "Stream not open");
+}
+
+int XmlReader::get() {
+  int c = buf_->sbumpc();
+  if (c == '\n') line_++;
+  return c;
+}
+
+int XmlReader::peek() {
+  return buf_->sgetc();
+}
+
+void XmlReader::expect(char c) {
+  int c1 = get();
+  casadi_assert(c1 == c, "XML syntax error on line " + str(line_) + ": Expected '"
+    + std::string(1, c) + "'");
+}
+
+void XmlReader::skip_ws() {
+  while (std::isspace(peek())) get();
+}
+
+std::string XmlReader::read_until(const char* term) {
+  std::string s;
+  size_t n = strlen(term);
+  for (;;) {
+    int c = get();
+    casadi_assert(c != EOF, "XML syntax error: Expected '" + std::string(term) + "'");
+    s.push_back(static_cast<char>(c));
+    if (s.size() >= n && s.compare(s.size() - n, n, term) == 0) {
+      s.resize(s.size() - n);
+      return s;
+    }
+  }
+}
+
+std::string XmlReader::read_name() {
+  std::string s;
+  for (;;) {
+    int c = peek();
+    if (c == EOF || std::isspace(c) || c == '=' || c == '>' || c == '/' || c == '?') break;
+    s.push_back(static_cast<char>(get()));
+  }
+  casadi_assert(!s.empty(), "XML syntax error on line " + str(line_) + ": Expected name");
+  return s;
+}
+
+void XmlReader::read_entity(std::string& s) {
+  // Read up to the semicolon
+  std::string e;
+  for (;;) {
+    int c = get();
+    casadi_assert(c != EOF, "XML syntax error on line " + str(line_) + ": Unterminated entity");
+    if (c == ';') break;
+    e.push_back(static_cast<char>(c));
+  }
+  if (e == "lt") {
+    s.push_back('<');
+  } else if (e == "gt") {
+    s.push_back('>');
+  } else if (e == "amp") {
+    s.push_back('&');
+  } else if (e == "quot") {
+    s.push_back('"');
+  } else if (e == "apos") {
+    s.push_back('\'');
+  } else if (!e.empty() && e[0] == '#') {
+    // Character reference, encode as UTF-8
+    unsigned long cp = e.size() > 1 && e[1] == 'x'
+      ? std::stoul(e.substr(2), nullptr, 16) : std::stoul(e.substr(1));
+    if (cp < 0x80) {
+      s.push_back(static_cast<char>(cp));
+    } else if (cp < 0x800) {
+      s.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+      s.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    } else if (cp < 0x10000) {
+      s.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+      s.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+      s.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    } else {
+      s.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+      s.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+      s.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+      s.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    }
+  } else {
+    // Unknown entity: keep as is
+    s += "&" + e + ";";
+  }
+}
+
+bool XmlReader::next(XmlNode& parent, XmlNode& child) {
+  casadi_assert(!empty_, "Content of previous element not read");
+  for (;;) {
+    // Character data up to the next markup
+    std::string text;
+    int c;
+    while ((c = get()) != EOF && c != '<') {
+      if (c == '&') {
+        read_entity(text);
+      } else if (c != '\r') {
+        // Leading whitespace is ignored, as for TinyXML
+        if (!text.empty() || !std::isspace(c)) text.push_back(static_cast<char>(c));
+      }
+    }
+    if (!text.empty()) parent.text = text;
+    // End of file
+    if (c == EOF) {
+      casadi_assert(open_.empty(), "XML syntax error: Missing end tag for '"
+        + (open_.empty() ? std::string() : open_.back()) + "'");
+      return false;
+    }
+    c = peek();
+    if (c == '/') {
+      // End tag
+      get();
+      std::string name = read_name();
+      skip_ws();
+      expect('>');
+      casadi_assert(!open_.empty() && open_.back() == name,
+        "XML syntax error on line " + str(line_) + ": Unexpected end tag '" + name + "'");
+      open_.pop_back();
+      return false;
+    } else if (c == '?') {
+      // Processing instruction or XML declaration
+      read_until("?>");
+    } else if (c == '!') {
+      get();
+      if (peek() == '-') {
+        // Comment
+        expect('-');
+        expect('-');
+        parent.comment = read_until("-->");
+      } else if (peek() == '[') {
+        // CDATA section
+        std::string s = read_until("]]>");
+        casadi_assert(s.rfind("[CDATA[", 0) == 0,
+          "XML syntax error on line " + str(line_) + ": Unknown section");
+        parent.text = s.substr(7);
+      } else {
+        // Document type declaration
+        read_until(">");
+      }
+    } else {
+      // Start tag
+      child = XmlNode();
+      child.line = line_;
+      child.name = read_name();
+      for (;;) {
+        skip_ws();
+        c = get();
+        if (c == '/') {
+          expect('>');
+          empty_ = true;
+          return true;
+        } else if (c == '>') {
+          open_.push_back(child.name);
+          return true;
+        }
+        casadi_assert(c != EOF, "XML syntax error: Unterminated tag '" + child.name + "'");
+        // Attribute
+        std::string att_name(1, static_cast<char>(c));
+        if (peek() != '=' && !std::isspace(peek())) att_name += read_name();
+        skip_ws();
+        expect('=');
+        skip_ws();
+        int q = get();
+        casadi_assert(q == '"' || q == '\'',
+          "XML syntax error on line " + str(line_) + ": Expected quoted attribute value");
+        std::string att;
+        while ((c = get()) != q) {
+          casadi_assert(c != EOF, "XML syntax error: Unterminated attribute value");
+          if (c == '&') {
+            read_entity(att);
+          } else {
+            att.push_back(static_cast<char>(c));
+          }
+        }
+        child.set_attribute(att_name, att);
+      }
+    }
+  }
+}
+
+void XmlReader::read_body(XmlNode& node) {
+  // Quick return if no content
+  if (empty_) {
+    empty_ = false;
+    return;
+  }
+  // Read children recursively
+  XmlNode c;
+  while (next(node, c)) {
+    read_body(c);
+    node.children.push_back(std::move(c));
+  }
+}
+
+void XmlReader::skip_body() {
+  XmlNode dummy;
+  if (empty_) {
+    empty_ = false;
+    return;
+  }
+  XmlNode c;
+  while (next(dummy, c)) skip_body();
+}
+
+} // namespace casadi
@@ -0,0 +1,100 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#ifndef CASADI_XML_READER_HPP
+#define CASADI_XML_READER_HPP
+
+#include <istream>
+#include <string>
+#include <vector>
+#include "xml_node.hpp"
+
+/// \cond INTERNAL
+
+namespace casadi {
+
+/** \brief Incremental XML reader
+
+    Reads an XML document from a stream one element at a time, so that large
+    documents can be processed without holding a full document tree in memory.
+    Each element is returned as an XmlNode holding its name, attributes and line
+    number; its content is read with read_body or discarded with skip_body. */
+class CASADI_EXPORT XmlReader {
+ public:
+  // Constructor
+  explicit XmlReader(std::istream& stream);
+
+  /** \brief Read the start tag of the next child element
+
+      Returns false, after consuming the end tag of the enclosing element, when
+      there are no more children. Text and comments are stored in parent. */
+  bool next(XmlNode& parent, XmlNode& child);
+
+  /** \brief Read all content of the element whose start tag was read last */
+  void read_body(XmlNode& node);
+
+  /** \brief Discard all content of the element whose start tag was read last */
+  void skip_body();
+
+ private:
+  // Get a character, tracking line numbers
+  int get();
+
+  // Peek at the next character
+  int peek();
+
+  // Read a character and make sure it matches
+  void expect(char c);
+
+  // Skip whitespace
+  void skip_ws();
+
+  // Read until a terminating sequence, which is consumed
+  std::string read_until(const char* term);
+
+  // Read an element or attribute name
+  std::string read_name();
+
+  // Read an entity reference, after the '&', and append the decoded string
+  void read_entity(std::string& s);
+
+  // Stream buffer
+  std::streambuf* buf_;
+
+  // Current line number
+  casadi_int line_;
+
+  // Is the last returned element of the form <name/>?
+  bool empty_;
+
+  // Names of the open elements
+  std::vector<std::string> open_;
+};
+
+} // namespace casadi
+
+/// \endcond
+
+#endif // CASADI_XML_READER_HPP
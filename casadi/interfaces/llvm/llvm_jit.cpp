@@ -0,0 +1,324 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "llvm_jit.hpp"
+#include "casadi/core/sx_function.hpp"
+#include "casadi/core/casadi_meta.hpp"
+
+#include <llvm/Config/llvm-config.h>
+#include <llvm/ExecutionEngine/Orc/ExecutionUtils.h>
+#include <llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h>
+#include <llvm/ExecutionEngine/Orc/LLJIT.h>
+#include <llvm/ExecutionEngine/Orc/ThreadSafeModule.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/Intrinsics.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/IR/Verifier.h>
+#include <llvm/Passes/PassBuilder.h>
+#include <llvm/Support/TargetSelect.h>
+#include <llvm/Support/raw_ostream.h>
+
+namespace casadi {
+
+  extern "C"
+  int CASADI_IMPORTER_LLVM_EXPORT
+  casadi_register_importer_llvm(ImporterInternal::Plugin* plugin) {
+    plugin->creator = LlvmJit::creator;
+    plugin->name = "llvm";
+    plugin->doc = LlvmJit::meta_doc.c_str();
+    plugin->version = CASADI_VERSION;
+    plugin->options = &LlvmJit::options_;
+    return 0;
+  }
+
+  extern "C"
+  void CASADI_IMPORTER_LLVM_EXPORT casadi_load_importer_llvm() {
+    ImporterInternal::registerPlugin(casadi_register_importer_llvm);
+  }
+
+  // Operations that are not lowered inline are evaluated by the interpreter's kernels
+  static double casadi_llvm_math(int op, double x, double y) {
+    double f;
+    casadi_math<double>::fun(op, x, y, f);
+    return f;
+  }
+
+  // Prefix of generated symbols, avoids clashes with libm when resolving intrinsics
+  static const std::string llvm_symbol_prefix = "casadi_llvm_";
+
+  LlvmJit::LlvmJit(const std::string& name) : ImporterInternal(name) {
+    opt_level_ = 2;
+  }
+
+  LlvmJit::~LlvmJit() {
+  }
+
+  const Options LlvmJit::options_
+  = {{&ImporterInternal::options_},
+     {{"function",
+       {OT_FUNCTION,
+        "SXFunction to be compiled. The generated symbol has the name of the function."}},
+      {"opt_level",
+       {OT_INT,
+        "Optimization level (0-3) of the IR passes and the native code generator. "
+        "Default: 2"}}
+     }
+  };
+
+  void LlvmJit::init(const Dict& opts) {
+    // Base class
+    ImporterInternal::init(opts);
+
+    // Read options
+    Function f;
+    for (auto&& op : opts) {
+      if (op.first=="function") {
+        f = op.second;
+      } else if (op.first=="opt_level") {
+        opt_level_ = op.second;
+      }
+    }
+    casadi_assert(!f.is_null(), "Option 'function' is required by the llvm JIT.");
+    casadi_assert(f.is_a("SXFunction", false),
+      "The llvm JIT compiles SXFunction instances only, got '" + f.class_name() + "'.");
+    casadi_assert(!f.has_free(),
+      "Cannot compile '" + f.name() + "' since variables " + str(f.get_free()) + " are free.");
+    casadi_assert(opt_level_>=0 && opt_level_<=3,
+      "Option 'opt_level' must be in the range 0-3, got " + str(opt_level_) + ".");
+    const SXFunction* sxf = static_cast<const SXFunction*>(f.get());
+
+    // Register the native target once per process
+    static const bool native_target = !llvm::InitializeNativeTarget()
+      && !llvm::InitializeNativeTargetAsmPrinter();
+    casadi_assert(native_target, "LLVM does not support the native target.");
+
+    // Module with a single function following the casadi evaluation signature
+    auto ctx = std::make_unique<llvm::LLVMContext>();
+    auto mod = std::make_unique<llvm::Module>(f.name(), *ctx);
+    llvm::IRBuilder<> b(*ctx);
+    llvm::Type* t_d = b.getDoubleTy();
+#if LLVM_VERSION_MAJOR >= 17
+    // Opaque pointers: a single pointer type
+    llvm::PointerType* t_dp = b.getPtrTy();
+    llvm::PointerType* t_dpp = t_dp;
+    llvm::PointerType* t_ip = t_dp;
+#else // LLVM_VERSION_MAJOR >= 17
+    llvm::PointerType* t_dp = t_d->getPointerTo();
+    llvm::PointerType* t_dpp = t_dp->getPointerTo();
+    llvm::PointerType* t_ip = b.getIntNTy(8*sizeof(casadi_int))->getPointerTo();
+#endif // LLVM_VERSION_MAJOR >= 17
+    llvm::FunctionType* t_fcn = llvm::FunctionType::get(b.getInt32Ty(),
+      {t_dpp, t_dpp, t_ip, t_dp, b.getInt32Ty()}, false);
+    llvm::Function* fcn = llvm::Function::Create(t_fcn, llvm::Function::ExternalLinkage,
+      llvm_symbol_prefix + f.name(), mod.get());
+    llvm::Value* arg = fcn->getArg(0);
+    llvm::Value* res = fcn->getArg(1);
+    b.SetInsertPoint(llvm::BasicBlock::Create(*ctx, "entry", fcn));
+
+    // Fallback for operations without an inline lowering
+    llvm::FunctionCallee math = mod->getOrInsertFunction("casadi_llvm_math",
+      llvm::FunctionType::get(t_d, {b.getInt32Ty(), t_d, t_d}, false));
+
+    // Null inputs read from a block of zeros, null outputs are written to a dead buffer
+    casadi_int max_in = 1, max_out = 1;
+    for (casadi_int i=0; i<f.n_in(); ++i) max_in = std::max(max_in, f.nnz_in(i));
+    for (casadi_int i=0; i<f.n_out(); ++i) max_out = std::max(max_out, f.nnz_out(i));
+    llvm::ArrayType* t_zeros = llvm::ArrayType::get(t_d, max_in);
+    llvm::Value* zeros = b.CreateConstInBoundsGEP2_32(t_zeros,
+      new llvm::GlobalVariable(*mod, t_zeros, true, llvm::GlobalValue::PrivateLinkage,
+                               llvm::ConstantAggregateZero::get(t_zeros), "zeros"), 0, 0);
+    llvm::Value* sink = b.CreateAlloca(t_d, b.getInt64(max_out), "sink");
+    std::vector<llvm::Value*> in(f.n_in(), nullptr), out(f.n_out(), nullptr);
+    auto get_ptr = [&](llvm::Value* v, casadi_int i, llvm::Value* null_ptr) {
+      llvm::Value* p = b.CreateLoad(t_dp, b.CreateConstInBoundsGEP1_64(t_dp, v, i));
+      return b.CreateSelect(b.CreateIsNull(p), null_ptr, p);
+    };
+
+    // Work vector elements become SSA values
+    std::vector<llvm::Value*> w(sxf->sz_w(), nullptr);
+    llvm::Value* zero = llvm::ConstantFP::get(t_d, 0.);
+    llvm::Value* one = llvm::ConstantFP::get(t_d, 1.);
+    auto to_double = [&](llvm::Value* c) { return b.CreateUIToFP(c, t_d);};
+    auto unary = [&](llvm::Intrinsic::ID id, llvm::Value* x) {
+      return b.CreateUnaryIntrinsic(id, x);
+    };
+    auto binary = [&](llvm::Intrinsic::ID id, llvm::Value* x, llvm::Value* y) {
+      return b.CreateBinaryIntrinsic(id, x, y);
+    };
+
+    // Lower the algorithm
+    for (auto&& e : sxf->algorithm_) {
+      llvm::Value *x = nullptr, *y = nullptr, *r = nullptr;
+      casadi_int ndeps = e.op==OP_CONST || e.op==OP_INPUT || e.op==OP_OUTPUT
+        || e.op==OP_CALL ? 0 : casadi_math<double>::ndeps(e.op);
+      if (ndeps>=1) x = w.at(e.i1);
+      if (ndeps==2) y = w.at(e.i2);
+      switch (e.op) {
+        case OP_CONST: r = llvm::ConstantFP::get(t_d, e.d); break;
+        case OP_INPUT:
+          if (!in[e.i1]) in[e.i1] = get_ptr(arg, e.i1, zeros);
+          r = b.CreateLoad(t_d, b.CreateConstInBoundsGEP1_64(t_d, in[e.i1], e.i2));
+          break;
+        case OP_OUTPUT:
+          if (!out[e.i0]) out[e.i0] = get_ptr(res, e.i0, sink);
+          b.CreateStore(w.at(e.i1), b.CreateConstInBoundsGEP1_64(t_d, out[e.i0], e.i2));
+          continue;
+        case OP_CALL:
+          casadi_error("The llvm JIT cannot compile '" + f.name() + "': "
+                       "calls to other functions are not supported.");
+        case OP_ASSIGN: case OP_LIFT: r = x; break;
+        case OP_ADD: r = b.CreateFAdd(x, y); break;
+        case OP_SUB: r = b.CreateFSub(x, y); break;
+        case OP_MUL: r = b.CreateFMul(x, y); break;
+        case OP_DIV: r = b.CreateFDiv(x, y); break;
+        case OP_NEG: r = b.CreateFNeg(x); break;
+        case OP_TWICE: r = b.CreateFAdd(x, x); break;
+        case OP_SQ: r = b.CreateFMul(x, x); break;
+        case OP_INV: r = b.CreateFDiv(one, x); break;
+        case OP_FMOD: r = b.CreateFRem(x, y); break;
+        case OP_SQRT: r = unary(llvm::Intrinsic::sqrt, x); break;
+        case OP_EXP: r = unary(llvm::Intrinsic::exp, x); break;
+        case OP_LOG: r = unary(llvm::Intrinsic::log, x); break;
+        case OP_SIN: r = unary(llvm::Intrinsic::sin, x); break;
+        case OP_COS: r = unary(llvm::Intrinsic::cos, x); break;
+        case OP_FABS: r = unary(llvm::Intrinsic::fabs, x); break;
+        case OP_FLOOR: r = unary(llvm::Intrinsic::floor, x); break;
+        case OP_CEIL: r = unary(llvm::Intrinsic::ceil, x); break;
+        case OP_POW: case OP_CONSTPOW: r = binary(llvm::Intrinsic::pow, x, y); break;
+        case OP_COPYSIGN: r = binary(llvm::Intrinsic::copysign, x, y); break;
+        case OP_FMIN: r = binary(llvm::Intrinsic::minnum, x, y); break;
+        case OP_FMAX: r = binary(llvm::Intrinsic::maxnum, x, y); break;
+        case OP_LT: r = to_double(b.CreateFCmpOLT(x, y)); break;
+        case OP_LE: r = to_double(b.CreateFCmpOLE(x, y)); break;
+        case OP_EQ: r = to_double(b.CreateFCmpOEQ(x, y)); break;
+        case OP_NE: r = to_double(b.CreateFCmpUNE(x, y)); break;
+        case OP_NOT: r = to_double(b.CreateFCmpOEQ(x, zero)); break;
+        case OP_AND:
+          r = to_double(b.CreateAnd(b.CreateFCmpUNE(x, zero), b.CreateFCmpUNE(y, zero)));
+          break;
+        case OP_OR:
+          r = to_double(b.CreateOr(b.CreateFCmpUNE(x, zero), b.CreateFCmpUNE(y, zero)));
+          break;
+        case OP_IF_ELSE_ZERO: r = b.CreateSelect(b.CreateFCmpOEQ(x, zero), zero, y); break;
+        case OP_SIGN:
+          r = b.CreateSelect(b.CreateFCmpOLT(x, zero), llvm::ConstantFP::get(t_d, -1.),
+                b.CreateSelect(b.CreateFCmpOGT(x, zero), one, x));
+          break;
+        default:
+          r = b.CreateCall(math, {b.getInt32(e.op), x, y ? y : zero});
+      }
+      w.at(e.i0) = r;
+    }
+    b.CreateRet(b.getInt32(0));
+
+    // Catch lowering errors before handing the module to the code generator
+    std::string msg;
+    llvm::raw_string_ostream msg_stream(msg);
+    casadi_assert(!llvm::verifyModule(*mod, &msg_stream),
+      "The llvm JIT generated invalid IR for '" + f.name() + "': " + msg_stream.str());
+
+    // Native code generator for the host
+    auto jtmb = llvm::orc::JITTargetMachineBuilder::detectHost();
+    if (!jtmb) casadi_error("LLVM: " + llvm::toString(jtmb.takeError()));
+#if LLVM_VERSION_MAJOR >= 18
+    typedef llvm::CodeGenOptLevel CodeGenOptLevel;
+#else // LLVM_VERSION_MAJOR >= 18
+    typedef llvm::CodeGenOpt::Level CodeGenOptLevel;
+#endif // LLVM_VERSION_MAJOR >= 18
+    jtmb->setCodeGenOptLevel(opt_level_==0 ? CodeGenOptLevel::None :
+                             opt_level_==1 ? CodeGenOptLevel::Less :
+                             opt_level_==2 ? CodeGenOptLevel::Default :
+                                             CodeGenOptLevel::Aggressive);
+    auto jit = llvm::orc::LLJITBuilder().setJITTargetMachineBuilder(std::move(*jtmb)).create();
+    if (!jit) casadi_error("LLVM: " + llvm::toString(jit.takeError()));
+    jit_ = std::move(*jit);
+    mod->setDataLayout(jit_->getDataLayout());
+#if LLVM_VERSION_MAJOR >= 21
+    mod->setTargetTriple(jit_->getTargetTriple());
+#else // LLVM_VERSION_MAJOR >= 21
+    mod->setTargetTriple(jit_->getTargetTriple().str());
+#endif // LLVM_VERSION_MAJOR >= 21
+
+    // IR optimization
+    if (opt_level_>0) {
+      llvm::LoopAnalysisManager lam;
+      llvm::FunctionAnalysisManager fam;
+      llvm::CGSCCAnalysisManager cgam;
+      llvm::ModuleAnalysisManager mam;
+      llvm::PassBuilder pb;
+      pb.registerModuleAnalyses(mam);
+      pb.registerCGSCCAnalyses(cgam);
+      pb.registerFunctionAnalyses(fam);
+      pb.registerLoopAnalyses(lam);
+      pb.crossRegisterProxies(lam, fam, cgam, mam);
+      pb.buildPerModuleDefaultPipeline(opt_level_==1 ? llvm::OptimizationLevel::O1 :
+                                       opt_level_==2 ? llvm::OptimizationLevel::O2 :
+                                                       llvm::OptimizationLevel::O3)
+        .run(*mod, mam);
+    }
+
+    // libm for the intrinsics, the interpreter kernels for everything else
+    llvm::orc::JITDylib& jd = jit_->getMainJITDylib();
+    auto process = llvm::orc::DynamicLibrarySearchGenerator::GetForCurrentProcess(
+      jit_->getDataLayout().getGlobalPrefix());
+    if (!process) casadi_error("LLVM: " + llvm::toString(process.takeError()));
+    jd.addGenerator(std::move(*process));
+    llvm::orc::MangleAndInterner mangle(jit_->getExecutionSession(), jit_->getDataLayout());
+    llvm::orc::SymbolMap symbols;
+#if LLVM_VERSION_MAJOR >= 17
+    symbols[mangle("casadi_llvm_math")] = llvm::orc::ExecutorSymbolDef(
+      llvm::orc::ExecutorAddr::fromPtr(&casadi_llvm_math), llvm::JITSymbolFlags::Exported);
+#else // LLVM_VERSION_MAJOR >= 17
+    symbols[mangle("casadi_llvm_math")] = llvm::JITEvaluatedSymbol(
+      llvm::pointerToJITTargetAddress(&casadi_llvm_math), llvm::JITSymbolFlags::Exported);
+#endif // LLVM_VERSION_MAJOR >= 17
+    if (auto err = jd.define(llvm::orc::absoluteSymbols(std::move(symbols)))) {
+      casadi_error("LLVM: " + llvm::toString(std::move(err)));
+    }
+    if (auto err = jit_->addIRModule(
+        llvm::orc::ThreadSafeModule(std::move(mod), std::move(ctx)))) {
+      casadi_error("LLVM: " + llvm::toString(std::move(err)));
+    }
+
+    // Materialize now so that compilation errors and cost surface during construction
+    casadi_assert(get_function(f.name())!=nullptr,
+      "The llvm JIT failed to compile '" + f.name() + "'.");
+  }
+
+  signal_t LlvmJit::get_function(const std::string& symname) {
+    auto sym = jit_->lookup(llvm_symbol_prefix + symname);
+    if (!sym) {
+      llvm::consumeError(sym.takeError());
+      return nullptr;
+    }
+#if LLVM_VERSION_MAJOR >= 15
+    return sym->toPtr<signal_t>();
+#else // LLVM_VERSION_MAJOR >= 15
+    return reinterpret_cast<signal_t>(static_cast<uintptr_t>(sym->getAddress()));
+#endif // LLVM_VERSION_MAJOR >= 15
+  }
+
+} // namespace casadi
@@ -0,0 +1,107 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#ifndef CASADI_LLVM_JIT_HPP
+#define CASADI_LLVM_JIT_HPP
+
+#include "casadi/core/importer_internal.hpp"
+#include <casadi/interfaces/llvm/casadi_importer_llvm_export.h>
+
+#include <memory>
+
+namespace llvm {
+  namespace orc {
+    class LLJIT;
+  } // namespace orc
+} // namespace llvm
+
+/** \defgroup plugin_Importer_llvm Title
+    \par
+
+      In-process just-in-time compiler for SX functions based on LLVM ORC.
+
+      The algorithm of an SXFunction, passed with the "function" option, is lowered
+      directly to LLVM IR and compiled to machine code in memory. No C source is
+      generated and no external compiler is invoked.
+*/
+
+/** \pluginsection{Importer,llvm} */
+
+/// \cond INTERNAL
+namespace casadi {
+  /** \brief \pluginbrief{Importer,llvm}
+
+   @copydoc Importer_doc
+   @copydoc plugin_Importer_llvm
+   * */
+  class CASADI_IMPORTER_LLVM_EXPORT LlvmJit : public ImporterInternal {
+  public:
+
+    /** \brief Constructor */
+    explicit LlvmJit(const std::string& name);
+
+    /** \brief  Create a new JIT function */
+    static ImporterInternal* creator(const std::string& name) {
+      return new LlvmJit(name);
+    }
+
+    /** \brief Destructor */
+    ~LlvmJit() override;
+
+    ///@{
+    /** \brief Options */
+    static const Options options_;
+    const Options& get_options() const override { return options_;}
+    ///@}
+
+    /** \brief Initialize */
+    void init(const Dict& opts) override;
+
+    /// A documentation string
+    static const std::string meta_doc;
+
+    /// Get name of plugin
+    const char* plugin_name() const override { return "llvm";}
+
+    // Get name of the class
+    std::string class_name() const override { return "LlvmJit";}
+
+    /// Get a function pointer for numerical evaluation
+    signal_t get_function(const std::string& symname) override;
+
+    /// No meta information: the symbols are generated from a Function, not from a file
+    bool can_have_meta() const override { return false;}
+
+    // Options
+    casadi_int opt_level_;
+
+  protected:
+    std::unique_ptr<llvm::orc::LLJIT> jit_;
+  };
+
+} // namespace casadi
+/// \endcond
+
+#endif // CASADI_LLVM_JIT_HPP
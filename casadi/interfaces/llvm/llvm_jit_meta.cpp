@@ -0,0 +1,56 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+      #include "llvm_jit.hpp"
+      #include <string>
+
+      const std::string casadi::LlvmJit::meta_doc=
+      "\n"
+"\n"
+"\n"
+"In-process just-in-time compiler for SX functions based on LLVM ORC.\n"
+"\n"
+"The algorithm of an SXFunction, passed with the \"function\" option, is\n"
+"lowered directly to LLVM IR and compiled to machine code in memory. No C\n"
+"source is generated and no external compiler is invoked.\n"
+"\n"
+"\n"
+">List of available options\n"
+"\n"
+"+-----------+-------------+---------------------------------------------+\n"
+"|    Id     |    Type     |                 Description                 |\n"
+"+===========+=============+=============================================+\n"
+"| function  | OT_FUNCTION | SXFunction to be compiled. The generated    |\n"
+"|           |             | symbol has the name of the function.        |\n"
+"+-----------+-------------+---------------------------------------------+\n"
+"| opt_level | OT_INT      | Optimization level (0-3) of the IR passes   |\n"
+"|           |             | and the native code generator. Default: 2   |\n"
+"+-----------+-------------+---------------------------------------------+\n"
+"\n"
+"\n"
+"\n"
+"\n"
+;
@@ -25,6 +25,7 @@
 
 #include "ipqp.hpp"
 #include "casadi/core/nlpsol.hpp"
+#include "casadi/core/linsol_internal.hpp"
 
 namespace casadi {
 
@@ -131,10 +132,12 @@ namespace casadi {
     alloc_w(casadi_ipqp_sz_w(&p_), true);
     // Memory for KKT formation
     alloc_w(kkt_.nnz(), true);
-    alloc_iw(A_.size2());
+    alloc_iw(na_);
     alloc_w(nx_ + na_);
     // KKT solver
     linsol_ = Linsol("linsol", linear_solver_, kkt_, linear_solver_options_);
+    // Memory for the KKT factors in generated code
+    alloc_w(linsol_->sz_w_nfact(), true);
     // Print summary
     if (print_header_) {
       print("-------------------------------------------\n");
@@ -232,6 +235,101 @@ namespace casadi {
     return 0;
   }
 
+  void Ipqp::codegen_body(CodeGenerator& g) const {
+    qp_codegen_body(g);
+    g.add_auxiliary(CodeGenerator::AUX_IPQP);
+    g.add_auxiliary(CodeGenerator::AUX_KKT);
+    if (print_iter_) g.add_auxiliary(CodeGenerator::AUX_PRINTF);
+    g.local("d", "struct casadi_ipqp_data");
+    g.local("p", "struct casadi_ipqp_prob");
+    g.local("nz_kkt", "casadi_real", "*");
+    g.local("w_kkt", "casadi_real", "*");
+    if (print_iter_) g.local("buf[121]", "char");
+
+    // Setup memory structure
+    g << "casadi_ipqp_setup(&p, " << nx_ << ", " << na_ << ");\n";
+
+    // Copy options
+    g << "p.max_iter = " << p_.max_iter << ";\n";
+    g << "p.pr_tol = " << g.constant(p_.pr_tol) << ";\n";
+    g << "p.du_tol = " << g.constant(p_.du_tol) << ";\n";
+    g << "p.co_tol = " << g.constant(p_.co_tol) << ";\n";
+    g << "p.mu_tol = " << g.constant(p_.mu_tol) << ";\n";
+
+    // Setup KKT system and the storage for its factorization
+    g << "nz_kkt = w; w += " << kkt_.nnz() << ";\n";
+    g << "w_kkt = w; w += " << linsol_->sz_w_nfact() << ";\n";
+
+    // Setup IP solver
+    g << "d.prob = &p;\n";
+    g << "casadi_ipqp_init(&d, &iw, &w);\n";
+    g << "casadi_ipqp_bounds(&d, " << g.arg(CONIC_G) << ", "
+      << g.arg(CONIC_LBX) << ", " << g.arg(CONIC_UBX) << ", "
+      << g.arg(CONIC_LBA) << ", " << g.arg(CONIC_UBA) << ");\n";
+    g.comment("Missing bounds default to infinity");
+    g << "if (!" << g.arg(CONIC_LBX) << ") " << g.fill("d.lbz", nx_, "-casadi_inf") << "\n";
+    g << "if (!" << g.arg(CONIC_LBA) << ") "
+      << g.fill("d.lbz+" + str(nx_), na_, "-casadi_inf") << "\n";
+    g << "if (!" << g.arg(CONIC_UBX) << ") " << g.fill("d.ubz", nx_, "casadi_inf") << "\n";
+    g << "if (!" << g.arg(CONIC_UBA) << ") "
+      << g.fill("d.ubz+" + str(nx_), na_, "casadi_inf") << "\n";
+    g << "casadi_ipqp_guess(&d, " << g.arg(CONIC_X0) << ", "
+      << g.arg(CONIC_LAM_X0) << ", " << g.arg(CONIC_LAM_A0) << ");\n";
+
+    g.comment("Reverse communication loop");
+    g << "while (casadi_ipqp(&d)) {\n";
+    g << "switch (d.task) {\n";
+    g << "case IPQP_MV:\n";
+    g.comment("Matrix-vector multiplication");
+    g << g.mv(g.arg(CONIC_H), H_, "d.z", "d.rz", false) << "\n";
+    g << g.mv(g.arg(CONIC_A), A_, "d.lam+" + str(nx_), "d.rz", true) << "\n";
+    g << g.mv(g.arg(CONIC_A), A_, "d.z", "d.rz+" + str(nx_), false) << "\n";
+    g << "break;\n";
+    g << "case IPQP_PROGRESS:\n";
+    if (print_iter_) {
+      g.comment("Print progress");
+      g << "if (d.iter % 10 == 0) {\n";
+      g << "if (casadi_ipqp_print_header(&d, buf, sizeof(buf))) break;\n";
+      g << g.printf("%s\\n", "buf") << "\n";
+      g << "}\n";
+      g << "if (casadi_ipqp_print_iteration(&d, buf, sizeof(buf))) break;\n";
+      g << g.printf("%s\\n", "buf") << "\n";
+    }
+    g << "break;\n";
+    g << "case IPQP_FACTOR:\n";
+    g.comment("Form and factorize KKT");
+    g << "casadi_kkt(" << g.sparsity(kkt_) << ", nz_kkt, "
+      << g.sparsity(H_) << ", " << g.arg(CONIC_H) << ", "
+      << g.sparsity(A_) << ", " << g.arg(CONIC_A) << ", d.S, d.D, w, iw);\n";
+    linsol_->generate_nfact(g, "nz_kkt", "w_kkt");
+    g << "break;\n";
+    g << "case IPQP_SOLVE:\n";
+    g.comment("Solve KKT");
+    linsol_->generate_solve(g, "d.linsys", 1, false, "w_kkt");
+    g << "break;\n";
+    g << "}\n";
+    g << "}\n";
+
+    g.comment("Get solution");
+    g << "casadi_ipqp_solution(&d, " << g.res(CONIC_X) << ", "
+      << g.res(CONIC_LAM_X) << ", " << g.res(CONIC_LAM_A) << ");\n";
+    g << "if (" << g.res(CONIC_COST) << ") {\n";
+    g << g.res(CONIC_COST) << "[0] = 0.5*"
+      << g.bilin(g.arg(CONIC_H), H_, "d.z", "d.z") << " + "
+      << g.dot(nx_, "d.z", "d.g") << ";\n";
+    g << "}\n";
+
+    g << "if (d.status == IPQP_SUCCESS) {\n";
+    g << "return 0;\n";
+    g << "} else {\n";
+    if (error_on_fail_) {
+      g << "return -1000;\n";
+    } else {
+      g << "return -1;\n";
+    }
+    g << "}\n";
+  }
+
   Dict Ipqp::get_stats(void* mem) const {
     Dict stats = Conic::get_stats(mem);
     auto m = static_cast<IpqpMemory*>(mem);
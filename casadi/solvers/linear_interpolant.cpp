@@ -51,7 +51,8 @@ namespace casadi {
        {OT_STRINGVECTOR,
         "Sets, for each grid dimenion, the lookup algorithm used to find the correct index. "
         "'linear' uses a for-loop + break; "
-        "'exact' uses floored division (only for uniform grids)."}}
+        "'exact' uses floored division (only for uniform grids); "
+        "'hunt' starts from the interval of the previous call."}}
      }
   };
 
@@ -83,25 +84,65 @@ namespace casadi {
     alloc_iw(2*ndim_, true);
   }
 
+  bool LinearInterpolant::has_hunt() const {
+    for (casadi_int e : lookup_mode_) {
+      if (e==LOOKUP_HUNT) return true;
+    }
+    return false;
+  }
+
+  int LinearInterpolant::init_mem(void* mem) const {
+    if (Interpolant::init_mem(mem)) return 1;
+    auto m = static_cast<LinearInterpolantMemory*>(mem);
+    m->index.assign(ndim_, 0);
+    return 0;
+  }
+
   int LinearInterpolant::
   eval(const double** arg, double** res, casadi_int* iw, double* w, void* mem) const {
     setup(mem, arg, res, iw, w);
     if (res[0]) {
+      auto m = static_cast<LinearInterpolantMemory*>(mem);
       const double* values = has_parametric_values() ? arg[arg_values()] : get_ptr(values_);
       const double* grid = has_parametric_grid() ? arg[arg_grid()] : get_ptr(grid_);
+      // casadi_interpn hunts from the intervals stored in the first ndim entries of iw
+      std::copy(m->index.begin(), m->index.end(), iw);
       casadi_interpn(res[0], ndim_, grid, get_ptr(offset_),
                     values, arg[0], get_ptr(lookup_mode_), m_, iw, w);
+      std::copy(iw, iw+ndim_, m->index.begin());
     }
     return 0;
   }
 
+  std::string LinearInterpolant::codegen_mem_type() const {
+    return "struct { casadi_int index[" + str(ndim_) + "]; }";
+  }
+
+  void LinearInterpolant::codegen_init_mem(CodeGenerator& g) const {
+    g.add_auxiliary(CodeGenerator::AUX_CLEAR, {"casadi_int"});
+    g << "casadi_clear_casadi_int(" << codegen_mem(g) << ".index, " << ndim_ << ");\n";
+    g << "return 0;\n";
+  }
+
   void LinearInterpolant::codegen_body(CodeGenerator& g) const {
     std::string values = has_parametric_values() ? g.arg(arg_values()) : g.constant(values_);
     std::string grid = has_parametric_grid() ? g.arg(arg_grid()) : g.constant(grid_);
-    g << "  if (res[0]) {\n"
-      << "    " << g.interpn("res[0]", ndim_, grid, g.constant(offset_),
-      values, "arg[0]", g.constant(lookup_mode_), m_,  "iw", "w") << "\n"
-      << "  }\n";
+    // Intervals of the previous call, for 'hunt' lookup
+    std::string index;
+    if (has_hunt()) {
+      g.add_auxiliary(CodeGenerator::AUX_COPY, {"casadi_int"});
+      index = codegen_mem(g) + ".index";
+    }
+    g << "  if (res[0]) {\n";
+    if (!index.empty()) {
+      g << "    casadi_copy_casadi_int(" << index << ", " << ndim_ << ", iw);\n";
+    }
+    g << "    " << g.interpn("res[0]", ndim_, grid, g.constant(offset_),
+      values, "arg[0]", g.constant(lookup_mode_), m_,  "iw", "w") << "\n";
+    if (!index.empty()) {
+      g << "    casadi_copy_casadi_int(iw, " << ndim_ << ", " << index << ");\n";
+    }
+    g << "  }\n";
   }
 
   Function LinearInterpolant::
@@ -146,6 +187,9 @@ namespace casadi {
     const double* values = has_parametric_values() ? arg[m->arg_values()] : get_ptr(m->values_);
     const double* grid = has_parametric_grid() ? arg[m->arg_grid()] : get_ptr(m->grid_);
 
+    // No previous intervals to hunt from
+    if (m->has_hunt()) casadi_clear(iw, m->ndim_);
+
     casadi_interpn_grad(res[0], m->ndim_, grid, get_ptr(m->offset_),
                       values, arg[0], get_ptr(m->lookup_mode_), m->m_, iw, w);
     return 0;
@@ -167,6 +211,12 @@ namespace casadi {
     std::string values = has_parametric_values() ? g.arg(m->arg_values()) : g.constant(m->values_);
     std::string grid = has_parametric_grid() ? g.arg(m->arg_grid()) : g.constant(m->grid_);
 
+    // No previous intervals to hunt from
+    if (m->has_hunt()) {
+      g.add_auxiliary(CodeGenerator::AUX_CLEAR, {"casadi_int"});
+      g << "  casadi_clear_casadi_int(iw, " << m->ndim_ << ");\n";
+    }
+
     g << "  " << g.interpn_grad("res[0]", m->ndim_,
       grid, g.constant(m->offset_), values,
       "arg[0]", g.constant(m->lookup_mode_), m->m_, "iw", "w") << "\n";
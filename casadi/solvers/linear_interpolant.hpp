@@ -39,6 +39,11 @@
 /// \cond INTERNAL
 
 namespace casadi {
+  struct CASADI_INTERPOLANT_LINEAR_EXPORT LinearInterpolantMemory : public FunctionMemory {
+    // Intervals found in the previous evaluation, for 'hunt' lookup
+    std::vector<casadi_int> index;
+  };
+
   /** \brief \pluginbrief{Interpolant,linear}
     Implements a multilinear interpolant: For 1D, the interpolating polynomial
     will be linear. For 2D, the interpolating polynomial will be bilinear, etc.
@@ -85,6 +90,15 @@ namespace casadi {
     // Initialize
     void init(const Dict& opts) override;
 
+    /** \brief Create memory block */
+    void* alloc_mem() const override { return new LinearInterpolantMemory();}
+
+    /** \brief Initalize memory block */
+    int init_mem(void* mem) const override;
+
+    /** \brief Free memory block */
+    void free_mem(void *mem) const override { delete static_cast<LinearInterpolantMemory*>(mem);}
+
     /// Evaluate numerically
     int eval(const double** arg, double** res, casadi_int* iw, double* w, void* mem) const override;
 
@@ -103,6 +117,18 @@ namespace casadi {
     /** \brief Generate code for the body of the C function */
     void codegen_body(CodeGenerator& g) const override;
 
+    /** \brief Thread-local memory object type */
+    std::string codegen_mem_type() const override;
+
+    /** \brief Is thread-local memory object needed? */
+    bool codegen_needs_mem() const override { return has_hunt();}
+
+    /** \brief Generate code for init_mem */
+    void codegen_init_mem(CodeGenerator& g) const override;
+
+    /** \brief Does any dimension use 'hunt' lookup? */
+    bool has_hunt() const;
+
     /// A documentation string
     static const std::string meta_doc;
 
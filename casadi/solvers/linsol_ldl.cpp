@@ -131,6 +131,71 @@ namespace casadi {
     return 0;
   }
 
+  int LinsolLdl::nfact_batch(void* mem, const double* A, casadi_int K,
+                             casadi_int stride) const {
+    auto m = static_cast<LinsolLdlMemory*>(mem);
+    casadi_int n = nrow(), nnz = this->nnz(), nnz_l = sp_Lt_.nnz();
+    m->lb.resize(K*nnz_l);
+    m->db.resize(K*n);
+    m->wb.resize(batch_lanes*(std::max(nnz, n) + n));
+    // Interleaved nonzeros of A, followed by the work vector of casadi_ldl_batch
+    double* a = get_ptr(m->wb);
+    double* w = a + batch_lanes*std::max(nnz, n);
+    for (casadi_int k0=0; k0<K; k0+=batch_lanes) {
+      casadi_int nb = K-k0 < batch_lanes ? K-k0 : batch_lanes;
+      for (casadi_int l=0; l<nb; ++l) {
+        const double* A_l = A + (k0+l)*stride;
+        for (casadi_int i=0; i<nnz; ++i) a[i*nb+l] = A_l[i];
+      }
+      double* lt = get_ptr(m->lb) + k0*nnz_l;
+      double* d = get_ptr(m->db) + k0*n;
+      // A constant lane count lets the compiler unroll and vectorize the lane loops
+      if (nb==batch_lanes) {
+        casadi_ldl_batch(sp_, a, sp_Lt_, lt, d, get_ptr(p_), w, batch_lanes);
+      } else {
+        casadi_ldl_batch(sp_, a, sp_Lt_, lt, d, get_ptr(p_), w, nb);
+      }
+    }
+    for (double d : m->db) {
+      if (d==0) {
+        casadi_warning("LDL factorization has zeros in D");
+        break;
+      }
+    }
+    return 0;
+  }
+
+  int LinsolLdl::solve_batch(void* mem, const double* A, double* x, casadi_int nrhs, bool tr,
+                             casadi_int K, casadi_int a_stride, casadi_int x_stride) const {
+    auto m = static_cast<LinsolLdlMemory*>(mem);
+    casadi_int n = nrow(), nnz_l = sp_Lt_.nnz();
+    // Interleaved right-hand sides, followed by the work vector of casadi_ldl_solve_batch
+    double* xb = get_ptr(m->wb);
+    double* w = xb + batch_lanes*n;
+    for (casadi_int k0=0; k0<K; k0+=batch_lanes) {
+      casadi_int nb = K-k0 < batch_lanes ? K-k0 : batch_lanes;
+      const double* lt = get_ptr(m->lb) + k0*nnz_l;
+      const double* d = get_ptr(m->db) + k0*n;
+      for (casadi_int r=0; r<nrhs; ++r) {
+        for (casadi_int l=0; l<nb; ++l) {
+          const double* x_l = x + (k0+l)*x_stride + r*n;
+          for (casadi_int i=0; i<n; ++i) xb[i*nb+l] = x_l[i];
+        }
+        // LDL^T is symmetric: tr has no effect
+        if (nb==batch_lanes) {
+          casadi_ldl_solve_batch(xb, sp_Lt_, lt, d, get_ptr(p_), w, batch_lanes);
+        } else {
+          casadi_ldl_solve_batch(xb, sp_Lt_, lt, d, get_ptr(p_), w, nb);
+        }
+        for (casadi_int l=0; l<nb; ++l) {
+          double* x_l = x + (k0+l)*x_stride + r*n;
+          for (casadi_int i=0; i<n; ++i) x_l[i] = xb[i*nb+l];
+        }
+      }
+    }
+    return 0;
+  }
+
   casadi_int LinsolLdl::neig(void* mem, const double* A) const {
     // Count number of negative eigenvalues
     auto m = static_cast<LinsolLdlMemory*>(mem);
@@ -173,6 +238,21 @@ namespace casadi {
     g << "}\n";
   }
 
+  void LinsolLdl::generate_nfact(CodeGenerator& g, const std::string& A,
+                                 const std::string& w) const {
+    std::string d = w + "+" + str(sp_Lt_.nnz());
+    std::string ww = w + "+" + str(sp_Lt_.nnz() + nrow());
+    g << g.ldl(g.sparsity(sp_), A, g.sparsity(sp_Lt_), w, d, g.constant(p_), ww) << "\n";
+  }
+
+  void LinsolLdl::generate_solve(CodeGenerator& g, const std::string& x,
+                                 casadi_int nrhs, bool tr, const std::string& w) const {
+    // LDL^T is symmetric: tr has no effect
+    std::string d = w + "+" + str(sp_Lt_.nnz());
+    std::string ww = w + "+" + str(sp_Lt_.nnz() + nrow());
+    g << g.ldl_solve(x, nrhs, g.sparsity(sp_Lt_), w, d, g.constant(p_), ww) << "\n";
+  }
+
   LinsolLdl::LinsolLdl(DeserializingStream& s) : LinsolInternal(s) {
     s.version("LinsolLdl", 1);
     s.unpack("LinsolLdl::p", p_);
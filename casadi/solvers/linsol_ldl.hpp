@@ -42,6 +42,8 @@
 namespace casadi {
   struct CASADI_LINSOL_LDL_EXPORT LinsolLdlMemory : public LinsolMemory {
     std::vector<double> l, d, w;
+    // Factorizations from nfact_batch, interleaved in blocks of batch_lanes matrices
+    std::vector<double> lb, db, wb;
   };
 
   /** \brief \pluginbrief{Linsol,ldl}
@@ -89,10 +91,34 @@ namespace casadi {
     // Solve the linear system
     int solve(void* mem, const double* A, double* x, casadi_int nrhs, bool tr) const override;
 
+    // Keeps several numeric factorizations
+    bool has_batch() const override { return true;}
+
+    // Factorize K linear systems sharing the symbolic factorization
+    int nfact_batch(void* mem, const double* A, casadi_int K, casadi_int stride) const override;
+
+    // Solve K linear systems factorized by nfact_batch
+    int solve_batch(void* mem, const double* A, double* x, casadi_int nrhs, bool tr,
+                    casadi_int K, casadi_int a_stride, casadi_int x_stride) const override;
+
+    // Number of matrices factorized side by side by nfact_batch
+    static const casadi_int batch_lanes = 16;
+
     /// Generate C code
     void generate(CodeGenerator& g, const std::string& A, const std::string& x,
                   casadi_int nrhs, bool tr) const override;
 
+    /// Generate C code for the factorization, with lt, d and scratch in w
+    void generate_nfact(CodeGenerator& g, const std::string& A,
+                        const std::string& w) const override;
+
+    /// Generate C code for a solve with the factors in w
+    void generate_solve(CodeGenerator& g, const std::string& x,
+                        casadi_int nrhs, bool tr, const std::string& w) const override;
+
+    /// Workspace generate_nfact/generate_solve share: lt + d + ldl work
+    size_t sz_w_nfact() const override { return sp_Lt_.nnz() + 2*nrow(); }
+
     /// Number of negative eigenvalues
     casadi_int neig(void* mem, const double* A) const override;
 
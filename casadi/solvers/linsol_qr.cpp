@@ -246,6 +246,24 @@ namespace casadi {
                     "qr_beta", g.constant(prinv_), g.constant(pc_), "qr_w") << "\n";
   }
 
+  void LinsolQr::generate_nfact(CodeGenerator& g, const std::string& A,
+                                const std::string& w) const {
+    std::string r = w + "+" + str(sp_v_.nnz());
+    std::string beta = w + "+" + str(sp_v_.nnz() + sp_r_.nnz());
+    std::string qr_w = w + "+" + str(sp_v_.nnz() + sp_r_.nnz() + ncol());
+    g << g.qr(g.sparsity(sp_), A, qr_w, g.sparsity(sp_v_), w, g.sparsity(sp_r_), r,
+              beta, g.constant(prinv_), g.constant(pc_)) << "\n";
+  }
+
+  void LinsolQr::generate_solve(CodeGenerator& g, const std::string& x,
+                                casadi_int nrhs, bool tr, const std::string& w) const {
+    std::string r = w + "+" + str(sp_v_.nnz());
+    std::string beta = w + "+" + str(sp_v_.nnz() + sp_r_.nnz());
+    std::string qr_w = w + "+" + str(sp_v_.nnz() + sp_r_.nnz() + ncol());
+    g << g.qr_solve(x, nrhs, tr, g.sparsity(sp_v_), w, g.sparsity(sp_r_), r,
+                    beta, g.constant(prinv_), g.constant(pc_), qr_w) << "\n";
+  }
+
   void LinsolQr::generate_det(CodeGenerator& g, const std::string& A,
                               const std::string& d) const {
     generate_factorize(g, A);
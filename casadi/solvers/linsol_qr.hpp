@@ -116,6 +116,17 @@ namespace casadi {
       return sp_v_.nnz() + sp_r_.nnz() + ncol() + nrow() + ncol();
     }
 
+    /// Generate C code for the factorization, with v, r, beta and scratch in w
+    void generate_nfact(CodeGenerator& g, const std::string& A,
+                        const std::string& w) const override;
+
+    /// Generate C code for a solve with the factors in w
+    void generate_solve(CodeGenerator& g, const std::string& x,
+                        casadi_int nrhs, bool tr, const std::string& w) const override;
+
+    /// Workspace generate_nfact/generate_solve share, laid out as for generate
+    size_t sz_w_nfact() const override { return sz_w_fact(); }
+
     // Get name of the plugin
     const char* plugin_name() const override { return "qr";}
 
@@ -30,6 +30,14 @@
 #include "casadi/core/conic_impl.hpp"
 #include "casadi/core/convexify.hpp"
 
+#ifdef CASADI_WITH_THREAD
+#ifdef CASADI_WITH_THREAD_MINGW
+#include <mingw.thread.h>
+#else // CASADI_WITH_THREAD_MINGW
+#include <thread>
+#endif // CASADI_WITH_THREAD_MINGW
+#endif // CASADI_WITH_THREAD
+
 #include <ctime>
 #include <iomanip>
 #include <fstream>
@@ -83,6 +91,12 @@ const Options Sqpmethod::options_
     {"max_iter_ls",
       {OT_INT,
       "Maximum number of linesearch iterations"}},
+    {"parallel_ls",
+      {OT_INT,
+      "Number of linesearch step lengths that are evaluated concurrently, "
+      "each on a separate memory (default: 1). The first trial that satisfies the "
+      "Armijo condition is accepted, such that the iterates do not depend on this option. "
+      "Evaluations are serial if CasADi was built without thread support."}},
     {"tol_pr",
       {OT_DOUBLE,
       "Stopping criterion for primal infeasibility"}},
@@ -162,6 +176,7 @@ void Sqpmethod::init(const Dict& opts) {
   min_iter_ = 0;
   max_iter_ = 50;
   max_iter_ls_ = 3;
+  parallel_ls_ = 1;
   c1_ = 1e-4;
   beta_ = 0.8;
   merit_memsize_ = 4;
@@ -194,6 +209,8 @@ void Sqpmethod::init(const Dict& opts) {
       min_iter_ = op.second;
     } else if (op.first=="max_iter_ls") {
       max_iter_ls_ = op.second;
+    } else if (op.first=="parallel_ls") {
+      parallel_ls_ = op.second;
     } else if (op.first=="c1") {
       c1_ = op.second;
     } else if (op.first=="beta") {
@@ -266,6 +283,10 @@ void Sqpmethod::init(const Dict& opts) {
 
   convexify_ = false;
 
+  casadi_assert(parallel_ls_>=1, "Option 'parallel_ls' must be positive");
+  // No point in speculating beyond the maximum number of trials
+  parallel_ls_ = std::min(parallel_ls_, std::max(max_iter_ls_, casadi_int(1)));
+
   // Get/generate required functions
   if (max_iter_ls_ || so_corr_) create_function("nlp_fg", {"x", "p"}, {"f", "g"});
   // First order derivative information
@@ -351,6 +372,7 @@ void Sqpmethod::init(const Dict& opts) {
   casadi_sqpmethod_work(&p_, &sz_iw, &sz_w);
   alloc_iw(sz_iw, true);
   alloc_w(sz_w, true);
+  if (parallel_ls_>1) alloc_w((nx_+ng_+1)*parallel_ls_, true); // z_trial, f_trial
   if (convexify_) {
     alloc_iw(convexify_data_.sz_iw);
     alloc_w(convexify_data_.sz_w);
@@ -377,6 +399,11 @@ void Sqpmethod::set_work(void* mem, const double**& arg, double**& res,
   m->d.prob = &p_;
   casadi_sqpmethod_set_work(&m->d, &arg, &res, &iw, &w);
 
+  if (parallel_ls_>1) {
+    m->z_trial = w; w += (nx_+ng_)*parallel_ls_;
+    m->f_trial = w; w += parallel_ls_;
+  }
+
   m->iter_count = -1;
 }
 
@@ -389,6 +416,7 @@ int Sqpmethod::init_mem(void* mem) const {
   m->add_stat("QP");
   m->add_stat("linesearch");
   m->mem_qp = qpsol_->checkout();
+  m->ret_trial.resize(parallel_ls_);
   return 0;
 }
 
@@ -603,6 +631,9 @@ int Sqpmethod::solve(void* mem) const {
       l1 = d_nlp->objective + m->sigma * l1_infeas;
     }
 
+    // Speculatively evaluated line-search trials: number evaluated, number consumed
+    casadi_int n_trial = 0, i_trial = 0;
+
     // Pre calculations for second order corrections
     double l1_infeas_cand, l1_cand, fk_cand;
     l1_infeas_cand = 0;
@@ -612,11 +643,22 @@ int Sqpmethod::solve(void* mem) const {
       casadi_axpy(nx_, 1., d->dx, d->z_cand);
 
       // Evaluating objective and constraints
-      m->arg[0] = d->z_cand;
-      m->arg[1] = d_nlp->p;
-      m->res[0] = &fk_cand;
-      m->res[1] = d->z_cand + nx_;
-      if (calc_function(m, "nlp_fg")) {
+      int flag;
+      if (parallel_ls_>1) {
+        // The full step is also the first line-search trial unless corrected
+        n_trial = parallel_ls_;
+        eval_trials(m, 1., n_trial);
+        flag = m->ret_trial[0];
+        fk_cand = m->f_trial[0];
+        casadi_copy(m->z_trial + nx_, ng_, d->z_cand + nx_);
+      } else {
+        m->arg[0] = d->z_cand;
+        m->arg[1] = d_nlp->p;
+        m->res[0] = &fk_cand;
+        m->res[1] = d->z_cand + nx_;
+        flag = calc_function(m, "nlp_fg");
+      }
+      if (flag) {
         l1_cand = -inf; // Make sure the second order corrections are not used!
       } else {
         l1_infeas_cand = casadi_sum_viol(nx_+ng_, d->z_cand, d_nlp->lbz, d_nlp->ubz);
@@ -747,11 +789,26 @@ int Sqpmethod::solve(void* mem) const {
 
         // Evaluating objective and constraints
         if (!so_corr_ || !so_succes) {
-          m->arg[0] = d->z_cand;
-          m->arg[1] = d_nlp->p;
-          m->res[0] = &fk_cand;
-          m->res[1] = d->z_cand + nx_;
-          if (calc_function(m, "nlp_fg")) {
+          int flag;
+          if (parallel_ls_>1) {
+            // Evaluate the next batch of step lengths if needed
+            if (i_trial==n_trial) {
+              n_trial = std::min(parallel_ls_, max_iter_ls_ - ls_iter + 1);
+              i_trial = 0;
+              eval_trials(m, t, n_trial);
+            }
+            flag = m->ret_trial[i_trial];
+            fk_cand = m->f_trial[i_trial];
+            casadi_copy(m->z_trial + i_trial*(nx_+ng_) + nx_, ng_, d->z_cand + nx_);
+            i_trial++;
+          } else {
+            m->arg[0] = d->z_cand;
+            m->arg[1] = d_nlp->p;
+            m->res[0] = &fk_cand;
+            m->res[1] = d->z_cand + nx_;
+            flag = calc_function(m, "nlp_fg");
+          }
+          if (flag) {
             // Avoid infinite recursion
             if (ls_iter == max_iter_ls_) {
               ls_success = false;
@@ -1017,6 +1074,55 @@ int Sqpmethod::solve_elastic_mode(SqpmethodMemory* m,
   return ret;
 }
 
+void Sqpmethod::eval_trials(SqpmethodMemory* m, double t, casadi_int n) const {
+  auto d_nlp = &m->d_nlp;
+  auto d = &m->d;
+
+  // Candidate steps, step length sequence identical to sequential backtracking
+  for (casadi_int i=0; i<n; ++i) {
+    double* z = m->z_trial + i*(nx_+ng_);
+    casadi_copy(d_nlp->z, nx_, z);
+    casadi_axpy(nx_, t, d->dx, z);
+    t = beta_ * t;
+  }
+
+  // Respond to Ctrl+C before the batch, the workers cannot
+  InterruptHandler::check();
+
+  // Evaluate trial i using thread-local oracle memory i
+  auto eval_trial = [this, m, d_nlp](casadi_int i) {
+    auto ml = m->thread_local_mem.at(i);
+    double* z = m->z_trial + i*(nx_+ng_);
+    ml->arg[0] = z;
+    ml->arg[1] = d_nlp->p;
+    ml->res[0] = m->f_trial + i;
+    ml->res[1] = z + nx_;
+    m->ret_trial[i] = calc_function(m, "nlp_fg", nullptr, static_cast<int>(i));
+  };
+
+#ifdef CASADI_WITH_THREAD
+  // Errors are rethrown in the calling thread
+  std::vector<std::exception_ptr> err(n);
+  std::vector<std::thread> threads;
+  threads.reserve(n);
+  m->concurrent = true;
+  for (casadi_int i=0; i<n; ++i) {
+    threads.emplace_back([&eval_trial, &err, i]() {
+      try {
+        eval_trial(i);
+      } catch (...) {
+        err[i] = std::current_exception();
+      }
+    });
+  }
+  for (auto&& th : threads) th.join();
+  m->concurrent = false;
+  for (auto&& e : err) if (e) std::rethrow_exception(e);
+#else // CASADI_WITH_THREAD
+  for (casadi_int i=0; i<n; ++i) eval_trial(i);
+#endif // CASADI_WITH_THREAD
+}
+
 double Sqpmethod::calc_gamma_1(SqpmethodMemory* m) const {
   auto d = &m->d;
   return std::max(gamma_0_*casadi_norm_inf(nx_, d->gf), gamma_1_min_);
@@ -1539,7 +1645,7 @@ Dict Sqpmethod::get_stats(void* mem) const {
 }
 
 Sqpmethod::Sqpmethod(DeserializingStream& s) : Nlpsol(s) {
-  int version = s.version("Sqpmethod", 1, 3);
+  int version = s.version("Sqpmethod", 1, 4);
   s.unpack("Sqpmethod::qpsol", qpsol_);
   if (version>=3) {
     s.unpack("Sqpmethod::qpsol_ela", qpsol_ela_);
@@ -1554,6 +1660,11 @@ Sqpmethod::Sqpmethod(DeserializingStream& s) : Nlpsol(s) {
   s.unpack("Sqpmethod::c1", c1_);
   s.unpack("Sqpmethod::beta", beta_);
   s.unpack("Sqpmethod::max_iter_ls_", max_iter_ls_);
+  if (version>=4) {
+    s.unpack("Sqpmethod::parallel_ls", parallel_ls_);
+  } else {
+    parallel_ls_ = 1;
+  }
   s.unpack("Sqpmethod::merit_memsize_", merit_memsize_);
   s.unpack("Sqpmethod::beta", beta_);
   s.unpack("Sqpmethod::print_header", print_header_);
@@ -1613,7 +1724,7 @@ Sqpmethod::Sqpmethod(DeserializingStream& s) : Nlpsol(s) {
 
 void Sqpmethod::serialize_body(SerializingStream &s) const {
   Nlpsol::serialize_body(s);
-  s.version("Sqpmethod", 3);
+  s.version("Sqpmethod", 4);
   s.pack("Sqpmethod::qpsol", qpsol_);
   s.pack("Sqpmethod::qpsol_ela", qpsol_ela_);
   s.pack("Sqpmethod::exact_hessian", exact_hessian_);
@@ -1626,6 +1737,7 @@ void Sqpmethod::serialize_body(SerializingStream &s) const {
   s.pack("Sqpmethod::c1", c1_);
   s.pack("Sqpmethod::beta", beta_);
   s.pack("Sqpmethod::max_iter_ls_", max_iter_ls_);
+  s.pack("Sqpmethod::parallel_ls", parallel_ls_);
   s.pack("Sqpmethod::merit_memsize_", merit_memsize_);
   s.pack("Sqpmethod::beta", beta_);
   s.pack("Sqpmethod::print_header", print_header_);
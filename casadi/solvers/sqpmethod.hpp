@@ -59,6 +59,11 @@ namespace casadi {
 
     /// Iteration count
     int iter_count;
+
+    /// Speculative line-search trials: [x; g] candidates, objectives, return flags
+    double* z_trial;
+    double* f_trial;
+    std::vector<int> ret_trial;
   };
 
   /** \brief  \pluginbrief{Nlpsol,sqpmethod}
@@ -106,6 +111,11 @@ namespace casadi {
     void set_work(void* mem, const double**& arg, double**& res,
                           casadi_int*& iw, double*& w) const override;
 
+    /// One thread-local oracle memory per concurrent line-search trial
+    int n_thread_local() const override {
+      return std::max(max_num_threads_, static_cast<int>(parallel_ls_));
+    }
+
     // Solve the NLP
     int solve(void* mem) const override;
 
@@ -153,6 +163,9 @@ namespace casadi {
     casadi_int merit_memsize_;
     ///@}
 
+    /// Number of line-search step lengths evaluated concurrently
+    casadi_int parallel_ls_;
+
     // Print options
     bool print_header_, print_iteration_, print_status_;
 
@@ -231,6 +244,9 @@ namespace casadi {
     // Calculate gamma_1
     double calc_gamma_1(SqpmethodMemory* m) const;
 
+    // Evaluate f and g at z + t*beta^i*dx, i=0..n-1, concurrently
+    void eval_trials(SqpmethodMemory* m, double t, casadi_int n) const;
+
     /// A documentation string
     static const std::string meta_doc;
 
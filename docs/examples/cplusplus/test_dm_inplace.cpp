@@ -0,0 +1,174 @@
+/*
+ *    MIT No Attribution
+ *
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl, KU Leuven.
+ *
+ *    Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ *    software and associated documentation files (the "Software"), to deal in the Software
+ *    without restriction, including without limitation the rights to use, copy, modify,
+ *    merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ *    permit persons to whom the Software is furnished to do so.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ *    PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ *    OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+/**
+In-place DM operators (+=, -=, *=, /=) and nonzero views, checked against the
+out-of-place operators
+*/
+
+#include "casadi/casadi.hpp"
+#include <cmath>
+
+using namespace casadi;
+
+// Same sparsity pattern and bitwise identical nonzeros (NaN matches NaN)
+void check_equal(const DM& a, const DM& b, const std::string& descr) {
+  casadi_assert(a.sparsity()==b.sparsity(),
+    descr + ": sparsity " + a.sparsity().dim() + " vs " + b.sparsity().dim());
+  for (casadi_int k=0; k<a.nnz(); ++k) {
+    double x = a.nonzeros()[k], y = b.nonzeros()[k];
+    casadi_assert(x==y || (std::isnan(x) && std::isnan(y)),
+      descr + ": nonzero " + str(k) + " is " + str(x) + " vs " + str(y));
+  }
+}
+
+// In-place operation, by operator
+void apply(char op, DM& x, const DM& y) {
+  switch (op) {
+    case '+': x += y; break;
+    case '-': x -= y; break;
+    case '*': x *= y; break;
+    case '/': x /= y; break;
+  }
+}
+
+// Out-of-place reference
+DM binary(char op, const DM& x, const DM& y) {
+  switch (op) {
+    case '+': return x + y;
+    case '-': return x - y;
+    case '*': return x * y;
+    default: return x / y;
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  DM::rng(1);
+  DM dense = DM::rand(3, 3) + 1;
+
+  // Operands: dense, lower triangular, diagonal, without nonzeros, a wider repeated
+  // block, and scalars, dense (zero and nonzero) or structurally zero
+  std::vector<DM> mats = {dense, project(dense, Sparsity::lower(3)),
+    project(-2*dense, Sparsity::diag(3)), DM(Sparsity(3, 3)),
+    horzcat(dense, project(dense, Sparsity::upper(3)))};
+  std::vector<DM> scalars = {DM(2.5), DM(0.), DM(Sparsity(1, 1))};
+  std::vector<DM> all = mats;
+  all.insert(all.end(), scalars.begin(), scalars.end());
+
+  // Compare every compound operator with its out-of-place result
+  for (char op : {'+', '-', '*', '/'}) {
+    for (casadi_int i=0; i<all.size(); ++i) {
+      for (casadi_int j=0; j<all.size(); ++j) {
+        const DM& x = all[i];
+        const DM& y = all[j];
+        // Skip dimension mismatches
+        DM ref;
+        try {
+          ref = binary(op, x, y);
+        } catch (std::exception&) {
+          continue;
+        }
+        DM r = x;
+        apply(op, r, y);
+        check_equal(r, ref, "x" + str(i) + " " + op + "= y" + str(j));
+      }
+    }
+  }
+
+  // The nonzeros are updated in place when the result keeps the sparsity of x,
+  // e.g. adding a diagonal matrix to a lower triangular one (projection of y)
+  DM L = mats[1];
+  DM r = L;
+  const double* nz = r.ptr();
+  r += mats[2];
+  casadi_assert(r.ptr()==nz, "Expected in-place update");
+  check_equal(r, L + mats[2], "lower += diagonal");
+
+  // Multiplying by a structurally zero scalar falls back to an empty pattern
+  r = L;
+  r *= DM(Sparsity(1, 1));
+  casadi_assert(r.nnz()==0, "Expected no nonzeros");
+  check_equal(r, L*DM(Sparsity(1, 1)), "lower *= structural zero");
+
+  // Adding a nonzero scalar to a sparse matrix falls back to a dense result
+  r = L;
+  r += 1;
+  casadi_assert(r.is_dense(), "Expected dense result");
+  check_equal(r, L + 1, "lower += 1");
+
+  // Aliasing: the matrix as its own right-hand side
+  for (char op : {'+', '-', '*', '/'}) {
+    for (casadi_int i=0; i<mats.size(); ++i) {
+      DM x = mats[i];
+      DM ref = binary(op, x, x);
+      apply(op, x, x);
+      check_equal(x, ref, std::string("aliased x") + str(i) + " " + op + "= x");
+    }
+  }
+
+  // The combine cache must not outlive the argument pattern
+  DM U = project(dense, Sparsity::upper(3));
+  {
+    DM d = project(dense, Sparsity::diag(3));
+    check_equal(L + d, project(dense + diag(diag(dense)), Sparsity::lower(3)), "lower + diag");
+    // Same pair of live patterns: same union
+    Sparsity s1 = L.sparsity().unite(d.sparsity());
+    Sparsity s2 = L.sparsity().unite(d.sparsity());
+    casadi_assert(s1.get()==s2.get(), "Expected cached union");
+  }
+  // The diagonal pattern is gone, a new pattern may reuse its address
+  for (casadi_int k=0; k<10; ++k) {
+    DM t = project(dense, Sparsity::triplet(3, 3, {k % 3}, {(k+1) % 3}));
+    DM ref = densify(L) + densify(t);
+    DM s = L + t;
+    check_equal(densify(s), ref, "lower + pattern " + str(k));
+    casadi_assert(s.sparsity()==Sparsity::lower(3).unite(t.sparsity()), "Wrong union");
+  }
+  check_equal(L + U, dense + project(dense, Sparsity::diag(3)), "lower + upper");
+
+  // Column views: contents and row indices
+  DM K = horzcat(L, DM(Sparsity(3, 1)), dense);
+  for (casadi_int j=0; j<K.size2(); ++j) {
+    DM col = K(Slice(), j);
+    NonzeroView<const double> v = static_cast<const DM&>(K).col_view(j);
+    casadi_assert(v.size()==col.nnz(), "Column " + str(j) + ": wrong size");
+    casadi_int k = 0;
+    for (double e : v) {
+      casadi_assert(e==col.nonzeros()[k], "Column " + str(j) + ": wrong value");
+      casadi_assert(v.row(k)==col.sparsity().row()[k], "Column " + str(j) + ": wrong row");
+      k++;
+    }
+  }
+
+  // Nonzero views: contents, row indices and write access
+  NonzeroView<double> v = K.nz_view(2, 7);
+  casadi_assert(v.size()==5, "Wrong size");
+  for (casadi_int k=0; k<v.size(); ++k) {
+    casadi_assert(v[k]==K.nonzeros()[2+k], "Wrong value");
+    casadi_assert(v.row(k)==K.sparsity().row()[2+k], "Wrong row");
+    v[k] = -1;
+  }
+  casadi_assert(K.nonzeros()[2]==-1 && K.nonzeros()[6]==-1 && K.nonzeros()[7]!=-1,
+    "Write through view failed");
+
+  std::cout << "In-place operators and views are consistent" << std::endl;
+  return 0;
+}
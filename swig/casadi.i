@@ -6122,6 +6122,7 @@ namespace casadi {
 }
 #endif
 %include <casadi/core/global_options.hpp>
+%include <casadi/core/profiler.hpp>
 
 %include <casadi/core/casadi_meta.hpp>
 #ifdef SWIGPYTHON
@@ -0,0 +1,85 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "bench_common.hpp"
+
+using namespace casadi_bench;
+
+// Generation of C code for the OCP oracle and its Jacobian
+static void BM_codegen(benchmark::State& state) {
+  Ocp<SX> ocp(state.range(0));
+  Function f("nlp", {ocp.w}, {ocp.f, ocp.g, jacobian(ocp.g, ocp.w)});
+  for (auto _ : state) {
+    CodeGenerator gen("bench_codegen");
+    gen.add(f);
+    std::string s = gen.dump();
+    benchmark::DoNotOptimize(s);
+  }
+}
+BENCHMARK(BM_codegen)->RangeMultiplier(10)->Range(10, 1000)->Unit(benchmark::kMillisecond);
+
+// Just-in-time compilation of the OCP oracle with a compiler plugin
+// (wall time, since the shell compiler runs in a child process)
+static void BM_jit(benchmark::State& state, const std::string& compiler, const Dict& jit_opts) {
+  if (!Importer::has_plugin(compiler)) {
+    state.SkipWithError(("Compiler plugin '" + compiler + "' not available").c_str());
+    return;
+  }
+  Ocp<SX> ocp(state.range(0));
+  Dict opts = {{"jit", true}, {"compiler", compiler}, {"jit_options", jit_opts}};
+  try {
+    for (auto _ : state) {
+      Function f("nlp", {ocp.w}, {ocp.f, ocp.g}, opts);
+      benchmark::DoNotOptimize(f);
+    }
+  } catch (std::exception& e) {
+    state.SkipWithError(e.what());
+  }
+}
+BENCHMARK_CAPTURE(BM_jit, shell_O0, "shell", Dict{{"flags", std::vector<std::string>{"-O0"}}})
+  ->Arg(10)->Arg(100)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_CAPTURE(BM_jit, shell_O2, "shell", Dict{{"flags", std::vector<std::string>{"-O2"}}})
+  ->Arg(10)->Arg(100)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_CAPTURE(BM_jit, llvm, "llvm", Dict{{"opt_level", 2}})
+  ->Arg(10)->Arg(100)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// Serialization followed by deserialization
+template<typename M>
+static void BM_serialize(benchmark::State& state) {
+  Ocp<M> ocp(state.range(0));
+  Function f = ocp.nlp();
+  size_t bytes = 0;
+  for (auto _ : state) {
+    std::string s = f.serialize();
+    Function g = Function::deserialize(s);
+    bytes += s.size();
+    benchmark::DoNotOptimize(g);
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(bytes));
+}
+BENCHMARK_TEMPLATE(BM_serialize, SX)->RangeMultiplier(10)->Range(10, 1000)
+  ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_serialize, MX)->RangeMultiplier(10)->Range(10, 1000)
+  ->Unit(benchmark::kMicrosecond);
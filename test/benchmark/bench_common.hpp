@@ -0,0 +1,117 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#ifndef CASADI_BENCH_COMMON_HPP
+#define CASADI_BENCH_COMMON_HPP
+
+#include <casadi/casadi.hpp>
+#include <benchmark/benchmark.h>
+
+namespace casadi_bench {
+  using namespace casadi;
+
+  /// Cart-pole dynamics xdot = f(x, u), x = [p, theta, v, omega]
+  template<typename M>
+  Function cartpole() {
+    M x = M::sym("x", 4), u = M::sym("u");
+    M c = cos(x(1)), s = sin(x(1));
+    M d = 2 - c*c;
+    M a = (u + s*(9.81*c - x(3)*x(3)))/d;
+    M alpha = (-u*c - x(3)*x(3)*c*s + 2*9.81*s)/d;
+    return Function("cartpole", {x, u}, {vertcat(x(2), x(3), a, alpha)}, {"x", "u"}, {"ode"});
+  }
+
+  /// Multiple-shooting OCP with N intervals of a single RK4 step
+  template<typename M>
+  struct Ocp {
+    M w, f, g;
+    explicit Ocp(casadi_int N, double T=2.) {
+      Function F = cartpole<M>();
+      double h = T/static_cast<double>(N);
+      std::vector<M> w_list, g_list;
+      M X = M::sym("X0", 4);
+      w_list.push_back(X);
+      f = 0;
+      for (casadi_int k=0; k<N; ++k) {
+        M U = M::sym("U" + str(k));
+        w_list.push_back(U);
+        M k1 = F(std::vector<M>{X, U}).at(0);
+        M k2 = F(std::vector<M>{X + h/2*k1, U}).at(0);
+        M k3 = F(std::vector<M>{X + h/2*k2, U}).at(0);
+        M k4 = F(std::vector<M>{X + h*k3, U}).at(0);
+        M X_end = X + h/6*(k1 + 2*k2 + 2*k3 + k4);
+        f += dot(X, X) + 0.1*U*U;
+        X = M::sym("X" + str(k+1), 4);
+        w_list.push_back(X);
+        g_list.push_back(X_end - X);
+      }
+      w = vertcat(w_list);
+      g = vertcat(g_list);
+    }
+    /// Oracle w -> (f, g)
+    Function nlp() const { return Function("nlp", {w}, {f, g}, {"w"}, {"f", "g"});}
+    /// Representative evaluation point
+    DM w0() const {
+      DM::rng(1);
+      return DM::rand(w.size1());
+    }
+  };
+
+  /// Preallocated buffers for repeated numerical evaluation
+  struct Evaluator {
+    Function f;
+    int mem;
+    std::vector<DM> in, out;
+    std::vector<const double*> arg;
+    std::vector<double*> res;
+    std::vector<casadi_int> iw;
+    std::vector<double> w;
+    Evaluator(const Function& f, const std::vector<DM>& in) : f(f), in(in),
+        arg(f.sz_arg()), res(f.sz_res()), iw(f.sz_iw()), w(f.sz_w()) {
+      mem = f.checkout();
+      casadi_assert(in.size()==f.n_in(), "Wrong number of inputs for '" + f.name() + "'");
+      for (casadi_int i=0; i<f.n_in(); ++i) {
+        // Empty inputs are passed as null (all zero)
+        casadi_assert(in[i].is_empty() || in[i].nnz()==f.nnz_in(i),
+          "Wrong number of nonzeros for input " + str(i) + " of '" + f.name() + "'");
+        arg[i] = in[i].is_empty() ? nullptr : this->in[i].ptr();
+      }
+      out.reserve(f.n_out());
+      for (casadi_int i=0; i<f.n_out(); ++i) {
+        out.push_back(DM::zeros(f.sparsity_out(i)));
+        res[i] = out.back().ptr();
+      }
+    }
+    ~Evaluator() { f.release(mem);}
+    void operator()() {
+      if (f(get_ptr(arg), get_ptr(res), get_ptr(iw), get_ptr(w), mem)) {
+        throw CasadiException("Evaluation of '" + f.name() + "' failed");
+      }
+    }
+  };
+
+} // namespace casadi_bench
+
+#endif // CASADI_BENCH_COMMON_HPP
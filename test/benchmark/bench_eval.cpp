@@ -0,0 +1,201 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "bench_common.hpp"
+
+using namespace casadi_bench;
+
+// Numerical evaluation of the OCP oracle, N intervals
+template<typename M>
+static void BM_eval(benchmark::State& state) {
+  Ocp<M> ocp(state.range(0));
+  Evaluator e(ocp.nlp(), {ocp.w0()});
+  for (auto _ : state) e();
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_eval, SX)->RangeMultiplier(10)->Range(10, 1000);
+BENCHMARK_TEMPLATE(BM_eval, MX)->RangeMultiplier(10)->Range(10, 1000);
+
+// Numerical evaluation of the constraint Jacobian
+template<typename M>
+static void BM_eval_jac(benchmark::State& state) {
+  Ocp<M> ocp(state.range(0));
+  Function J("jac_g", {ocp.w}, {jacobian(ocp.g, ocp.w)});
+  Evaluator e(J, {ocp.w0()});
+  for (auto _ : state) e();
+}
+BENCHMARK_TEMPLATE(BM_eval_jac, SX)->RangeMultiplier(10)->Range(10, 1000);
+BENCHMARK_TEMPLATE(BM_eval_jac, MX)->RangeMultiplier(10)->Range(10, 100);
+
+// Numerical evaluation of the Lagrangian Hessian, with and without graph simplification
+template<bool simplify>
+static void BM_eval_hess_simplify(benchmark::State& state) {
+  Ocp<MX> ocp(state.range(0));
+  MX lam = MX::sym("lam", ocp.g.size1());
+  MX H = hessian(ocp.f + dot(lam, ocp.g), ocp.w);
+  Function F("hess_l", {ocp.w, lam}, {H}, {{"simplify", simplify}});
+  Evaluator e(F, {ocp.w0(), DM::ones(ocp.g.size1())});
+  state.counters["instructions"] = F.n_instructions();
+  for (auto _ : state) e();
+}
+BENCHMARK_TEMPLATE(BM_eval_hess_simplify, false)->RangeMultiplier(10)->Range(10, 100);
+BENCHMARK_TEMPLATE(BM_eval_hess_simplify, true)->RangeMultiplier(10)->Range(10, 100);
+
+// Least-squares objective over n data points and its gradient, reduced by mapsum
+static void BM_mapsum_lsq(benchmark::State& state, const std::string& parallelization) {
+  casadi_int n = state.range(0);
+  SX p = SX::sym("p", 4), t = SX::sym("t"), y = SX::sym("y");
+  SX e = p(0)*exp(-p(1)*t)*cos(p(2)*t + p(3)) - y;
+  Function r("r", {p, t, y}, {0.5*e*e});
+  Function F = parallelization=="serial" ? r.map(n, std::vector<bool>{true, false, false},
+    std::vector<bool>{true})
+    : r.map("lsq", parallelization, n, std::vector<casadi_int>{0}, std::vector<casadi_int>{0});
+  MX P = MX::sym("p", 4), T = MX::sym("t", 1, n), Y = MX::sym("y", 1, n);
+  MX f = F(std::vector<MX>{P, T, Y}).at(0);
+  Function G("g", {P, T, Y}, {f, gradient(f, P)});
+  DM t0 = DM(range(n)).T()/n;
+  Evaluator ev(G, {DM({1, 2, 3, 0.5}), t0, sin(t0)});
+  for (auto _ : state) ev();
+  state.SetItemsProcessed(state.iterations()*n);
+}
+BENCHMARK_CAPTURE(BM_mapsum_lsq, serial, "serial")->RangeMultiplier(100)->Range(100, 1000000)
+  ->Unit(benchmark::kMicrosecond)->UseRealTime();
+BENCHMARK_CAPTURE(BM_mapsum_lsq, openmp, "openmp")->RangeMultiplier(100)->Range(100, 1000000)
+  ->Unit(benchmark::kMicrosecond)->UseRealTime();
+
+// Construction of a forward (tr=false) or reverse (tr=true) directional derivative
+template<typename M, bool tr>
+static void BM_ad(benchmark::State& state) {
+  Ocp<M> ocp(state.range(0));
+  M v = M::sym("v", tr ? ocp.g.size1() : ocp.w.size1());
+  for (auto _ : state) {
+    M d = jtimes(ocp.g, ocp.w, v, tr);
+    benchmark::DoNotOptimize(d);
+  }
+}
+BENCHMARK_TEMPLATE(BM_ad, SX, false)->RangeMultiplier(10)->Range(10, 1000)
+  ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_ad, SX, true)->RangeMultiplier(10)->Range(10, 1000)
+  ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_ad, MX, false)->RangeMultiplier(10)->Range(10, 1000)
+  ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_ad, MX, true)->RangeMultiplier(10)->Range(10, 1000)
+  ->Unit(benchmark::kMicrosecond);
+
+// Construction of the full constraint Jacobian
+template<typename M>
+static void BM_jacobian(benchmark::State& state) {
+  Ocp<M> ocp(state.range(0));
+  for (auto _ : state) {
+    M J = jacobian(ocp.g, ocp.w);
+    benchmark::DoNotOptimize(J);
+  }
+}
+BENCHMARK_TEMPLATE(BM_jacobian, SX)->RangeMultiplier(10)->Range(10, 1000)
+  ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_jacobian, MX)->RangeMultiplier(10)->Range(10, 100)
+  ->Unit(benchmark::kMillisecond);
+
+// Jacobian sparsity pattern by sparsity propagation
+template<typename M>
+static void BM_jac_sparsity(benchmark::State& state) {
+  Ocp<M> ocp(state.range(0));
+  for (auto _ : state) {
+    Sparsity sp = jacobian_sparsity(ocp.g, ocp.w);
+    benchmark::DoNotOptimize(sp);
+  }
+}
+BENCHMARK_TEMPLATE(BM_jac_sparsity, SX)->RangeMultiplier(10)->Range(10, 1000)
+  ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_jac_sparsity, MX)->RangeMultiplier(10)->Range(10, 1000)
+  ->Unit(benchmark::kMicrosecond);
+
+// Column coloring of the constraint Jacobian
+static void BM_uni_coloring(benchmark::State& state) {
+  Ocp<SX> ocp(state.range(0));
+  Sparsity sp = jacobian_sparsity(ocp.g, ocp.w);
+  for (auto _ : state) {
+    Sparsity c = sp.uni_coloring();
+    benchmark::DoNotOptimize(c);
+  }
+  state.counters["colors"] = static_cast<double>(sp.uni_coloring().size2());
+}
+BENCHMARK(BM_uni_coloring)->RangeMultiplier(10)->Range(10, 1000)
+  ->Unit(benchmark::kMicrosecond);
+
+// Star coloring of the Lagrangian Hessian
+static void BM_star_coloring(benchmark::State& state) {
+  Ocp<SX> ocp(state.range(0));
+  SX lam = SX::sym("lam", ocp.g.size1());
+  Sparsity sp = hessian(ocp.f + dot(lam, ocp.g), ocp.w).sparsity();
+  for (auto _ : state) {
+    Sparsity c = sp.star_coloring();
+    benchmark::DoNotOptimize(c);
+  }
+  state.counters["colors"] = static_cast<double>(sp.star_coloring().size2());
+}
+BENCHMARK(BM_star_coloring)->RangeMultiplier(10)->Range(10, 1000)
+  ->Unit(benchmark::kMicrosecond);
+
+// Hashing of a banded pattern with n columns
+static void BM_sparsity_hash(benchmark::State& state) {
+  Sparsity sp = Sparsity::band(state.range(0), 5);
+  for (auto _ : state) benchmark::DoNotOptimize(sp.hash());
+  state.SetItemsProcessed(state.iterations()*sp.nnz());
+}
+BENCHMARK(BM_sparsity_hash)->RangeMultiplier(100)->Range(100, 1000000);
+
+// Creation of banded patterns of varying size through the cache
+static void BM_sparsity_cache(benchmark::State& state) {
+  casadi_int k = state.thread_index();
+  for (auto _ : state) {
+    Sparsity sp = Sparsity::banded(100 + k++ % 100, 2);
+    benchmark::DoNotOptimize(sp);
+  }
+}
+#ifdef CASADI_WITH_THREADSAFE_SYMBOLICS
+BENCHMARK(BM_sparsity_cache)->ThreadRange(1, 8)->UseRealTime();
+#else
+BENCHMARK(BM_sparsity_cache);
+#endif // CASADI_WITH_THREADSAFE_SYMBOLICS
+
+// Construction of the OCP and its constraint Jacobian, one model per thread
+template<typename M>
+static void BM_construct(benchmark::State& state) {
+  for (auto _ : state) {
+    Ocp<M> ocp(state.range(0));
+    M J = jacobian(ocp.g, ocp.w);
+    benchmark::DoNotOptimize(J);
+  }
+}
+#ifdef CASADI_WITH_THREADSAFE_SYMBOLICS
+BENCHMARK_TEMPLATE(BM_construct, SX)->Arg(20)->ThreadRange(1, 8)->UseRealTime()
+  ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_construct, MX)->Arg(20)->ThreadRange(1, 8)->UseRealTime()
+  ->Unit(benchmark::kMillisecond);
+#else
+BENCHMARK_TEMPLATE(BM_construct, SX)->Arg(20)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_construct, MX)->Arg(20)->Unit(benchmark::kMillisecond);
+#endif // CASADI_WITH_THREADSAFE_SYMBOLICS
@@ -0,0 +1,89 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "bench_common.hpp"
+#include <cstring>
+
+using namespace casadi_bench;
+
+// Van der Pol oscillator exported, compiled and packed as an FMU, built once.
+// Returns an empty string, with the reason in *msg, if this is not possible.
+static std::string vdp_fmu(std::string* msg) {
+  static std::string fmu_file, error;
+  static bool done = false;
+  if (!done) {
+    done = true;
+    const char* feats = CasadiMeta::feature_list();
+    if (std::strstr(feats, "ghc-filesystem") == nullptr
+        || std::strstr(feats, "libzip") == nullptr) {
+      error = "ghc-filesystem/libzip not available";
+    } else {
+      try {
+        DaeBuilder dae("vdp_bench");
+        MX x0 = dae.add("x0"), x1 = dae.add("x1");
+        dae.eq(dae.der(x0), x1);
+        dae.eq(dae.der(x1), (1 - x0*x0)*x1 - x0);
+        dae.set_start("x0", 0);
+        dae.set_start("x1", 0);
+        Dict files = dae.export_fmu();
+        files = dae.compile_fmu(files,
+          {{"include_dirs", std::vector<std::string>{CASADI_BENCH_FMI_HEADERS}}});
+        fmu_file = dae.pack_fmu(files, {{"path", "vdp_bench.fmu"}});
+      } catch (std::exception& e) {
+        error = e.what();
+      }
+    }
+  }
+  *msg = error;
+  return fmu_file;
+}
+
+// Creation and first evaluation of the FMU Jacobian, as when an integrator
+// or a solver builds its derivative functions. With "pooled", the Jacobian is
+// created from a function that shares its Fmu, so it reuses pooled instances.
+// These are restored from their initialization snapshot if the FMU supports it,
+// and reset and initialized again otherwise. With "fresh", each Jacobian gets
+// a new Fmu and instantiates and initializes its own instances.
+static void BM_fmu_jacobian(benchmark::State& state, bool pooled) {
+  std::string msg, fmu_file = vdp_fmu(&msg);
+  if (fmu_file.empty()) {
+    state.SkipWithError(msg.c_str());
+    return;
+  }
+  // Evaluate the binary, not the CasADi expressions serialized in the FMU
+  DaeBuilder dae("vdp_bench", fmu_file, {{"enable_ls_serialization", false}});
+  Dict opts = {{"parallelization", "serial"}};
+  Function f = dae.create("f", {"x"}, {"ode"}, opts);
+  DM x = DM({1.1, 1.3});
+  f(std::vector<DM>{x});
+  for (auto _ : state) {
+    Function J = pooled ? f.factory("J", {"x"}, {"jac:ode:x"})
+                        : dae.create("J", {"x"}, {"jac_ode_x"}, opts);
+    DM r = J(std::vector<DM>{x}).at(0);
+    benchmark::DoNotOptimize(r);
+  }
+}
+BENCHMARK_CAPTURE(BM_fmu_jacobian, pooled, true)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_fmu_jacobian, fresh, false)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,132 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "bench_common.hpp"
+
+using namespace casadi_bench;
+
+// 2-D lookup table with n x n grid points
+static void interpolant_data(casadi_int n, std::vector<std::vector<double>>& grid,
+    std::vector<double>& values) {
+  std::vector<double> g(n);
+  for (casadi_int i=0; i<n; ++i) g[i] = static_cast<double>(i)/static_cast<double>(n-1);
+  grid = {g, g};
+  values.clear();
+  for (double y : g) {
+    for (double x : g) values.push_back(sin(3*x)*cos(2*y));
+  }
+}
+
+// Interpolant lookup at a single point
+static void BM_interpolant(benchmark::State& state, const std::string& plugin) {
+  std::vector<std::vector<double>> grid;
+  std::vector<double> values;
+  interpolant_data(state.range(0), grid, values);
+  Function F = interpolant("F", plugin, grid, values);
+  Evaluator e(F, {DM({0.37, 0.71})});
+  for (auto _ : state) e();
+}
+BENCHMARK_CAPTURE(BM_interpolant, linear, "linear")->RangeMultiplier(10)->Range(10, 1000);
+BENCHMARK_CAPTURE(BM_interpolant, bspline, "bspline")->RangeMultiplier(10)->Range(10, 1000);
+
+// Linear interpolant on n grid points, queried along a slow sweep as in a simulation
+static void BM_interpolant_sweep(benchmark::State& state, const std::string& lookup_mode) {
+  casadi_int n = state.range(0);
+  std::vector<double> g(n), v(n);
+  for (casadi_int i=0; i<n; ++i) {
+    g[i] = static_cast<double>(i)/static_cast<double>(n-1);
+    v[i] = sin(3*g[i]);
+  }
+  Function F = interpolant("F", "linear", {g}, v,
+    {{"lookup_mode", std::vector<std::string>{lookup_mode}}});
+  Evaluator e(F, {DM(0.)});
+  // Advance by a third of the grid spacing per query, restarting at the end
+  double* x = e.in[0].ptr();
+  double dx = 1./static_cast<double>(3*(n-1));
+  for (auto _ : state) {
+    *x += dx;
+    if (*x>1) *x = 0;
+    e();
+  }
+}
+BENCHMARK_CAPTURE(BM_interpolant_sweep, binary, "binary")->RangeMultiplier(100)
+  ->Range(100, 1000000);
+BENCHMARK_CAPTURE(BM_interpolant_sweep, hunt, "hunt")->RangeMultiplier(100)
+  ->Range(100, 1000000);
+
+// Cubic blazing spline on an n x n grid, just-in-time compiled
+static Function blazing_spline_jit(benchmark::State& state, casadi_int n,
+    const std::string& lookup_mode) {
+  std::vector<double> k;
+  for (casadi_int i=0; i<n; ++i) k.push_back(static_cast<double>(i)/static_cast<double>(n-1));
+  k.insert(k.begin(), 3, 0.);
+  k.insert(k.end(), 3, 1.);
+  // The generated code includes simde headers from the CasADi include path
+  std::vector<std::string> flags = {"-O2"};
+  if (!GlobalOptions::getCasadiIncludePath().empty()) {
+    flags.push_back("-I" + GlobalOptions::getCasadiIncludePath());
+  }
+  Dict jit_opts = {{"flags", flags}};
+  try {
+    return blazing_spline("F", {k, k}, {{"jit", true}, {"jit_options", jit_opts},
+      {"lookup_mode", std::vector<std::string>(2, lookup_mode)}});
+  } catch (std::exception& e) {
+    state.SkipWithError(e.what());
+    return Function();
+  }
+}
+
+// Cubic blazing spline lookup at a single point
+static void BM_blazing_spline(benchmark::State& state) {
+  casadi_int n = state.range(0);
+  Function F = blazing_spline_jit(state, n, "auto");
+  if (F.is_null()) return;
+  DM::rng(3);
+  Evaluator e(F, {DM({0.37, 0.71}), DM::rand(F.nnz_in(1))});
+  for (auto _ : state) e();
+}
+BENCHMARK(BM_blazing_spline)->RangeMultiplier(10)->Range(10, 1000);
+
+// Cubic blazing spline lookup along a slow diagonal sweep
+static void BM_blazing_spline_sweep(benchmark::State& state, const std::string& lookup_mode) {
+  casadi_int n = state.range(0);
+  Function F = blazing_spline_jit(state, n, lookup_mode);
+  if (F.is_null()) return;
+  DM::rng(3);
+  Evaluator e(F, {DM({0., 0.}), DM::rand(F.nnz_in(1))});
+  // Advance by a third of the knot spacing per query, restarting at the end
+  double* x = e.in[0].ptr();
+  double dx = 1./static_cast<double>(3*(n-1));
+  for (auto _ : state) {
+    x[0] += dx;
+    if (x[0]>1) x[0] = 0;
+    x[1] = x[0];
+    e();
+  }
+}
+BENCHMARK_CAPTURE(BM_blazing_spline_sweep, binary, "binary")->RangeMultiplier(10)
+  ->Range(100, 1000);
+BENCHMARK_CAPTURE(BM_blazing_spline_sweep, hunt, "hunt")->RangeMultiplier(10)
+  ->Range(100, 1000);
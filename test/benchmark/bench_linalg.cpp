@@ -0,0 +1,193 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "bench_common.hpp"
+
+using namespace casadi_bench;
+
+// Regularized KKT matrix of the OCP at a representative point
+static DM kkt(casadi_int N) {
+  Ocp<SX> ocp(N);
+  SX lam = SX::sym("lam", ocp.g.size1());
+  SX H = hessian(ocp.f + dot(lam, ocp.g), ocp.w);
+  SX J = jacobian(ocp.g, ocp.w);
+  SX K = blockcat(H + SX::eye(H.size1()), J.T(), J, -1e-3*SX::eye(J.size1()));
+  Function fK("kkt", {ocp.w, lam}, {K});
+  DM::rng(2);
+  return fK(std::vector<DM>{ocp.w0(), DM::rand(lam.size1())}).at(0);
+}
+
+// Symbolic factorization
+static void BM_linsol_sfact(benchmark::State& state, const std::string& solver) {
+  DM K = kkt(state.range(0));
+  for (auto _ : state) {
+    Linsol ls("ls", solver, K.sparsity());
+    ls.sfact(K.ptr());
+  }
+}
+BENCHMARK_CAPTURE(BM_linsol_sfact, ldl, "ldl")->RangeMultiplier(10)->Range(10, 1000)
+  ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_linsol_sfact, qr, "qr")->RangeMultiplier(10)->Range(10, 1000)
+  ->Unit(benchmark::kMicrosecond);
+
+// Numerical factorization and a single solve
+static void BM_linsol_solve(benchmark::State& state, const std::string& solver) {
+  DM K = kkt(state.range(0));
+  Linsol ls("ls", solver, K.sparsity());
+  ls.sfact(K.ptr());
+  std::vector<double> b(K.size1(), 1.), x;
+  for (auto _ : state) {
+    x = b;
+    if (ls.nfact(K.ptr())) throw CasadiException("Factorization failed");
+    ls.solve(K.ptr(), get_ptr(x));
+  }
+}
+BENCHMARK_CAPTURE(BM_linsol_solve, ldl, "ldl")->RangeMultiplier(10)->Range(10, 1000)
+  ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_linsol_solve, qr, "qr")->RangeMultiplier(10)->Range(10, 1000)
+  ->Unit(benchmark::kMicrosecond);
+
+// K small KKT matrices (single shooting interval) with perturbed Hessians, back to back
+static std::vector<double> kkt_batch(casadi_int K, Sparsity& sp) {
+  DM K0 = kkt(1);
+  sp = K0.sparsity();
+  DM::rng(3);
+  std::vector<double> A;
+  for (casadi_int k=0; k<K; ++k) {
+    DM Kk = K0 + project(diag(DM::rand(sp.size1())), sp);
+    const std::vector<double>& nz = Kk.nonzeros();
+    A.insert(A.end(), nz.begin(), nz.end());
+  }
+  return A;
+}
+
+// Factorize and solve K systems one by one, or all at once with nfact_batch/solve_batch
+template<bool batch>
+static void BM_linsol_batch(benchmark::State& state) {
+  casadi_int K = state.range(0);
+  Sparsity sp;
+  std::vector<double> A = kkt_batch(K, sp);
+  Linsol ls("ls", "ldl", sp);
+  ls.sfact(get_ptr(A));
+  std::vector<double> b(K*sp.size1(), 1.), x;
+  for (auto _ : state) {
+    x = b;
+    if (batch) {
+      if (ls.nfact_batch(get_ptr(A), K)) throw CasadiException("Factorization failed");
+      ls.solve_batch(get_ptr(A), get_ptr(x), K);
+    } else {
+      for (casadi_int k=0; k<K; ++k) {
+        if (ls.nfact(get_ptr(A) + k*sp.nnz())) throw CasadiException("Factorization failed");
+        ls.solve(get_ptr(A) + k*sp.nnz(), get_ptr(x) + k*sp.size1());
+      }
+    }
+  }
+}
+BENCHMARK_TEMPLATE(BM_linsol_batch, false)->RangeMultiplier(10)->Range(10, 1000)
+  ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_linsol_batch, true)->RangeMultiplier(10)->Range(10, 1000)
+  ->Unit(benchmark::kMicrosecond);
+
+// Solve MX node under map, against calling the unmapped function K times
+template<bool map>
+static void BM_linsol_map(benchmark::State& state) {
+  casadi_int K = state.range(0);
+  Sparsity sp;
+  std::vector<double> A = kkt_batch(K, sp);
+  MX a = MX::sym("a", sp), b = MX::sym("b", sp.size1());
+  Function f("f", {a, b}, {solve(a, b, "ldl")});
+  if (map) {
+    Evaluator F(f.map(K), {DM(repmat(sp, 1, K), A), DM::ones(sp.size1(), K)});
+    for (auto _ : state) F();
+  } else {
+    Evaluator F(f, {DM(sp, std::vector<double>(A.begin(), A.begin() + sp.nnz())),
+                    DM::ones(sp.size1())});
+    for (auto _ : state) {
+      for (casadi_int k=0; k<K; ++k) {
+        F.arg[0] = get_ptr(A) + k*sp.nnz();
+        F();
+      }
+    }
+  }
+}
+BENCHMARK_TEMPLATE(BM_linsol_map, false)->RangeMultiplier(10)->Range(10, 1000)
+  ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_linsol_map, true)->RangeMultiplier(10)->Range(10, 1000)
+  ->Unit(benchmark::kMicrosecond);
+
+// Chain of elementwise operations on dense DM vectors, out of place or in place
+template<bool inplace>
+static void BM_dm_chain(benchmark::State& state) {
+  DM::rng(1);
+  DM x = DM::rand(state.range(0)), a = DM::rand(x.size1()), b = DM::rand(x.size1()), y;
+  for (auto _ : state) {
+    if (inplace) {
+      y = x;
+      y += a;
+      y *= b;
+      y -= a;
+      y /= 2;
+    } else {
+      y = (x + a)*b - a;
+      y = y/2;
+    }
+    benchmark::DoNotOptimize(y);
+  }
+}
+BENCHMARK_TEMPLATE(BM_dm_chain, false)->RangeMultiplier(100)->Range(10, 100000);
+BENCHMARK_TEMPLATE(BM_dm_chain, true)->RangeMultiplier(100)->Range(10, 100000);
+
+// Sum of sparse DM matrices with different patterns, e.g. KKT assembly
+static void BM_dm_sparse_add(benchmark::State& state) {
+  DM K = kkt(state.range(0));
+  DM H = triu(K), L = tril(K);
+  DM S;
+  for (auto _ : state) {
+    S = H + L;
+    S = S - 2*L;
+    benchmark::DoNotOptimize(S);
+  }
+}
+BENCHMARK(BM_dm_sparse_add)->RangeMultiplier(10)->Range(10, 1000);
+
+// Column sums of a sparse DM, through submatrices or through views
+template<bool view>
+static void BM_dm_columns(benchmark::State& state) {
+  DM K = kkt(state.range(0));
+  std::vector<double> s(K.size2());
+  for (auto _ : state) {
+    for (casadi_int j=0; j<K.size2(); ++j) {
+      if (view) {
+        s[j] = 0;
+        for (double v : K.col_view(j)) s[j] += v;
+      } else {
+        s[j] = static_cast<double>(sum1(K(Slice(), j)));
+      }
+    }
+    benchmark::DoNotOptimize(s);
+  }
+}
+BENCHMARK_TEMPLATE(BM_dm_columns, false)->RangeMultiplier(10)->Range(10, 100);
+BENCHMARK_TEMPLATE(BM_dm_columns, true)->RangeMultiplier(10)->Range(10, 1000);
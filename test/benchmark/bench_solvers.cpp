@@ -0,0 +1,94 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "bench_common.hpp"
+
+using namespace casadi_bench;
+
+// QP from linearizing the OCP around a representative point
+static void BM_qpsol(benchmark::State& state, const std::string& solver, Dict opts) {
+  Ocp<SX> ocp(state.range(0));
+  SX H = hessian(ocp.f, ocp.w);
+  SX A = jacobian(ocp.g, ocp.w);
+  Function qp_data("qp_data", {ocp.w}, {H, gradient(ocp.f, ocp.w), A, ocp.g});
+  std::vector<DM> d = qp_data(std::vector<DM>{ocp.w0()});
+  opts["print_iter"] = opts["print_header"] = opts["print_info"] = false;
+  opts["error_on_fail"] = false;
+  Function qp = conic("qp", solver, {{"h", H.sparsity()}, {"a", A.sparsity()}}, opts);
+  // Bounded controls, equality constrained defects
+  DM lbx = -inf*DM::ones(ocp.w.size1()), ubx = inf*DM::ones(ocp.w.size1());
+  for (casadi_int k=0; k<state.range(0); ++k) {
+    lbx(4 + 5*k) = -1;
+    ubx(4 + 5*k) = 1;
+  }
+  Evaluator e(qp, {d[0], d[1], d[2], -d[3], -d[3], lbx, ubx, DM(), DM(), DM(), DM(), DM()});
+  for (auto _ : state) e();
+}
+BENCHMARK_CAPTURE(BM_qpsol, qrqp, "qrqp", Dict())->RangeMultiplier(10)->Range(10, 100)
+  ->Unit(benchmark::kMillisecond);
+// The KKT system of this QP needs pivoting, which ldl does not do
+BENCHMARK_CAPTURE(BM_qpsol, ipqp, "ipqp", Dict{{"linear_solver", "qr"}})
+  ->RangeMultiplier(10)->Range(10, 100)->Unit(benchmark::kMillisecond);
+
+// SQP solve of the OCP from a fixed initial state
+static void BM_sqpmethod(benchmark::State& state) {
+  casadi_int N = state.range(0);
+  Ocp<SX> ocp(N);
+  Dict qp_opts = {{"print_iter", false}, {"print_header", false}, {"print_info", false},
+                  {"error_on_fail", false}};
+  Dict opts = {{"qpsol", "qrqp"}, {"qpsol_options", qp_opts}, {"print_header", false},
+               {"print_iteration", false}, {"print_status", false}, {"print_time", false},
+               {"error_on_fail", false}};
+  Function solver = nlpsol("solver", "sqpmethod",
+    {{"x", ocp.w}, {"f", ocp.f}, {"g", ocp.g}}, opts);
+  DM lbx = -inf*DM::ones(ocp.w.size1()), ubx = inf*DM::ones(ocp.w.size1());
+  for (casadi_int i=0; i<4; ++i) lbx(i) = ubx(i) = i==1 ? 0.2 : 0;
+  for (casadi_int k=0; k<N; ++k) {
+    lbx(4 + 5*k) = -2;
+    ubx(4 + 5*k) = 2;
+  }
+  DM x0 = DM::zeros(ocp.w.size1());
+  Evaluator e(solver, {x0, DM(), lbx, ubx, DM::zeros(ocp.g.size1()), DM::zeros(ocp.g.size1()),
+                       DM(), DM()});
+  for (auto _ : state) e();
+}
+BENCHMARK(BM_sqpmethod)->RangeMultiplier(10)->Range(10, 100)->Unit(benchmark::kMillisecond);
+
+// Integration of the cart-pole over a horizon with 20 output times
+static void BM_integrator(benchmark::State& state, const std::string& plugin) {
+  Function F = cartpole<SX>();
+  SX x = SX::sym("x", 4), u = SX::sym("u");
+  std::vector<double> tout;
+  for (casadi_int k=1; k<=20; ++k) tout.push_back(0.1*static_cast<double>(k));
+  Dict opts = {{"number_of_finite_elements", static_cast<casadi_int>(state.range(0))}};
+  Function I = integrator("I", plugin, {{"x", x}, {"u", u}, {"ode", F(SXVector{x, u}).at(0)}},
+    0, tout, opts);
+  Evaluator e(I, {DM({0, 0.2, 0, 0}), DM(), DM(), 0.5*DM::ones(I.sparsity_in("u")),
+                  DM(), DM(), DM()});
+  for (auto _ : state) e();
+}
+BENCHMARK_CAPTURE(BM_integrator, rk, "rk")->Arg(1)->Arg(10)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_integrator, collocation, "collocation")->Arg(1)->Arg(10)
+  ->Unit(benchmark::kMicrosecond);
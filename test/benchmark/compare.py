@@ -0,0 +1,60 @@
+#
+#     This file is part of CasADi.
+#
+#     CasADi -- A symbolic framework for dynamic optimization.
+#     Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+#                             KU Leuven. All rights reserved.
+#     Copyright (C) 2011-2014 Greg Horn
+#
+#     CasADi is free software; you can redistribute it and/or
+#     modify it under the terms of the GNU Lesser General Public
+#     License as published by the Free Software Foundation; either
+#     version 3 of the License, or (at your option) any later version.
+#
+#     CasADi is distributed in the hope that it will be useful,
+#     but WITHOUT ANY WARRANTY; without even the implied warranty of
+#     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+#     Lesser General Public License for more details.
+#
+#     You should have received a copy of the GNU Lesser General Public
+#     License along with CasADi; if not, write to the Free Software
+#     Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+#
+#
+"""Compare two casadi_bench JSON outputs (--benchmark_out_format=json)
+
+Usage: python compare.py baseline.json contender.json [threshold]
+
+Prints the relative change in (median) real time per benchmark and exits with
+status 1 if any benchmark got slower by more than threshold (default 0.1).
+"""
+import json
+import sys
+
+def load(fname):
+  ret = {}
+  with open(fname) as f:
+    for b in json.load(f)["benchmarks"]:
+      if "error_occurred" in b and b["error_occurred"]: continue
+      # With repetitions, compare the medians
+      if b.get("run_type") == "aggregate" and b.get("aggregate_name") != "median": continue
+      ret[b.get("run_name", b["name"])] = b["real_time"]
+  return ret
+
+if __name__ == "__main__":
+  base = load(sys.argv[1])
+  new = load(sys.argv[2])
+  threshold = float(sys.argv[3]) if len(sys.argv) > 3 else 0.1
+  regressed = False
+  for name in sorted(set(base) & set(new)):
+    change = new[name]/base[name] - 1
+    flag = ""
+    if change > threshold:
+      flag = "  <-- slower"
+      regressed = True
+    elif change < -threshold:
+      flag = "  <-- faster"
+    print("%-60s %+7.1f%%%s" % (name, 100*change, flag))
+  for name in sorted(set(base) ^ set(new)):
+    print("%-60s only in %s" % (name, sys.argv[1] if name in base else sys.argv[2]))
+  sys.exit(1 if regressed else 0)
@@ -1050,6 +1050,30 @@ class ConicTests(casadiTestCase):
         F = cg["F"]
         #with self.assertOutput(["last_tau","Converged"],[]): # Printing, but not captured by python stdout
         #    F()
+
+  @requires_conic("ipqp")
+  def test_ipqp_codegen(self):
+    x = ca.MX.sym("x",3)
+    H = ca.DM([[4,1,0],[1,2,0.5],[0,0.5,3]])
+    A = ca.DM([[1,1,1],[1,-1,0]])
+    qp = {"x":x,"f":0.5*ca.bilin(H,x,x)+ca.dot(ca.DM([1,-2,0.5]),x),"g":ca.mtimes(A,x)}
+    solver_in = {"lbx":[-1,-1,-inf],"ubx":[1,inf,0.3],"lbg":[0.5,-inf],"ubg":[inf,0.2]}
+    for linear_solver in ["ldl","qr"]:
+      solver = ca.qpsol("solver","ipqp",qp,{"linear_solver":linear_solver,"print_header":False,"print_iter":False,"print_info":False})
+      ref = solver(**solver_in)
+      self.assertTrue(solver.stats()["success"])
+      if args.run_slow:
+        cg = self.check_codegen(solver,solver_in,std="c99",digits=10)
+        F = cg["F"]
+        # Timing comparison between the virtual machine and the generated code
+        N = 1000
+        t0 = time.time()
+        for i in range(N): solver(**solver_in)
+        t_vm = (time.time()-t0)/N
+        t0 = time.time()
+        for i in range(N): F(**solver_in)
+        t_cg = (time.time()-t0)/N
+        print("ipqp(%s): VM %.3g s, codegen %.3g s per call" % (linear_solver,t_vm,t_cg))
     
     
 
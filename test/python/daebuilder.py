@@ -109,6 +109,64 @@ class Daebuildertests(casadiTestCase):
     if os.path.exists(fmu_file):
         os.remove(fmu_file)
 
+  @memory_heavy() # FMU has a memleak
+  def test_fmu_instance_pool(self):
+    # FMU instances are pooled in the Fmu object and reused by all functions created from it
+    feats = ca.CasadiMeta.feature_list()
+    if "ghc-filesystem" not in feats or "libzip" not in feats:
+        print("Skipping instance pool: ghc-filesystem/libzip not available")
+        return
+    fmi_headers = "../../external_packages/FMI-Standard-3.0/headers"
+    if not os.path.exists(os.path.join(fmi_headers, "fmi3Functions.h")):
+        print("Skipping instance pool: FMI-3 headers not available")
+        return
+    dae = ca.DaeBuilder("vdp_pool")
+    x0 = dae.add("x0")
+    x1 = dae.add("x1")
+    dae.eq(dae.der(x0), x1)
+    dae.eq(dae.der(x1), (1 - x0 * x0) * x1 - x0)
+    dae.set_start("x0", 0)
+    dae.set_start("x1", 0)
+    files = dae.export_fmu()
+    try:
+        files = dae.compile_fmu(files, {"include_dirs": [fmi_headers]})
+    except Exception as e:
+        for local in files.keys():
+            if os.path.exists(local):
+                os.remove(local)
+        print("Skipping instance pool: C compilation unavailable:", e)
+        return
+    fmu_file = dae.pack_fmu(files, {"path": "vdp_pool.fmu"})
+    # Evaluate the binary, not the CasADi expressions serialized in the FMU
+    dae2 = ca.DaeBuilder("vdp_pool", fmu_file, dict(enable_ls_serialization=False))
+    x_test = ca.vertcat(1.1, 1.3)
+    J_ref = ca.DM([[0, 1], [-1 - 2 * 1.1 * 1.3, 1 - 1.1 ** 2]])
+    for parallelization in ["serial", "thread"]:
+        f = dae2.create("f", ["x"], ["ode"], dict(parallelization=parallelization))
+        f(x_test)
+        stats = f.stats()
+        n_in_use = stats["fmu_instances"] - stats["fmu_instances_pooled"]
+        # Derivative functions share the Fmu of f and are created and destroyed repeatedly
+        n_instances = None
+        for i in range(20):
+            J = f.factory("J", ["x"], ["jac:ode:x"])
+            self.checkarray(J(x_test), J_ref, digits=7)
+            stats = J.stats()
+            if n_instances is None: n_instances = stats["fmu_instances"]
+            # No new instances: those of the previous function were released and reused
+            self.assertEqual(stats["fmu_instances"], n_instances)
+            # Freeing the function returns its instances to the pool
+            J = None
+        stats = f.stats()
+        self.assertEqual(stats["fmu_instances"], n_instances)
+        self.assertEqual(stats["fmu_instances"] - stats["fmu_instances_pooled"], n_in_use)
+        f = None
+    # Cleanup
+    dae2 = None
+    gc.collect()
+    if os.path.exists(fmu_file):
+        os.remove(fmu_file)
+
   @memory_heavy() # FMU has a memleak
   def test_cstr(self):
     fmu_file = "../data/cstr.fmu"
@@ -148,6 +206,38 @@ class Daebuildertests(casadiTestCase):
     self.checkfunction(f,f_ref,inputs=test_point,digits=4,hessian=False,evals=1)
     print(f.stats())
       
+  def test_large_model_description(self):
+    # modelDescription.xml is read incrementally, one variable at a time
+    n = 20000
+    dirname = "large_model_description"
+    import shutil
+    if os.path.isdir(dirname): shutil.rmtree(dirname)
+    os.makedirs(dirname)
+    with open(os.path.join(dirname, "modelDescription.xml"), "w") as f:
+      f.write('<?xml version="1.0" encoding="UTF-8"?>\n')
+      f.write('<fmiModelDescription fmiVersion="2.0" modelName="large" guid="{0}">\n')
+      f.write('  <ModelExchange modelIdentifier="large"/>\n  <ModelVariables>\n')
+      for i in range(n):
+        f.write('    <ScalarVariable name="x[%d]" valueReference="%d" description="&lt;state&gt;">'
+                '<Real start="%d"/></ScalarVariable>\n' % (i, i, i))
+      for i in range(n):
+        f.write('    <ScalarVariable name="der(x[%d])" valueReference="%d">'
+                '<Real derivative="%d"/></ScalarVariable>\n' % (i, n + i, i + 1))
+      f.write('  </ModelVariables>\n  <ModelStructure>\n    <Derivatives>\n')
+      for i in range(n):
+        f.write('      <Unknown index="%d" dependencies="%d"/>\n' % (n + i + 1, i + 1))
+      f.write('    </Derivatives>\n  </ModelStructure>\n</fmiModelDescription>\n')
+    from time import time
+    t0 = time()
+    dae = ca.DaeBuilder("large", dirname)
+    print("Loaded", 2 * n, "variables in", time() - t0, "s")
+    self.assertEqual(len(dae.x()), n)
+    self.assertEqual(dae.x()[7], "x[7]")
+    self.assertEqual(dae.start("x[7]"), 7)
+    self.assertEqual(dae.description("x[7]"), "<state>")
+    dae = None
+    shutil.rmtree(dirname)
+
   @memory_heavy() # FMU has a memleak
   def test_indendent_var(self):
     return
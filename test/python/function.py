@@ -31,6 +31,7 @@ from types import *
 from helpers import *
 import pickle
 import os
+import json
 import re
 import sys
 from casadi.tools import capture_stdout
@@ -858,6 +859,48 @@ class Functiontests(casadiTestCase):
 
             self.check_serialize(F,inputs=inputs)
 
+  def test_mapsum_openmp(self):
+    p = ca.SX.sym("p",4)
+    t = ca.SX.sym("t")
+    y = ca.SX.sym("y")
+    e = p[0]*ca.exp(-p[1]*t)*ca.cos(p[2]*t+p[3])-y
+    r = ca.Function("r",[p,t,y],[0.5*e**2,e])
+
+    for n in [3,100,1000]:
+      F = r.map("lsq","openmp",n,[0],[0])
+      Fref = r.map(n,[True,False,False],[True,False])
+
+      P = ca.MX.sym("p",4)
+      T = ca.MX.sym("t",1,n)
+      Y = ca.MX.sym("y",1,n)
+      G = ca.Function("G",[P,T,Y],[F(P,T,Y)[0],ca.gradient(F(P,T,Y)[0],P)])
+      Gref = ca.Function("G",[P,T,Y],[Fref(P,T,Y)[0],ca.gradient(Fref(P,T,Y)[0],P)])
+
+      t0 = ca.DM(list(range(n))).T/n
+      inputs = [ca.DM([1,2,3,0.5]),t0,ca.sin(t0)]
+      self.checkfunction_light(F,Fref,inputs=inputs)
+      self.checkfunction(G,Gref,inputs=inputs,digits=10)
+      self.check_codegen(G,inputs=inputs)
+      self.check_serialize(F,inputs=inputs)
+
+    # Fixed block partition: bitwise identical results for any number of threads
+    import subprocess
+    G.save("mapsum_openmp.casadi")
+    script = ("import casadi as ca; G = ca.Function.load('mapsum_openmp.casadi'); "
+              "t0 = ca.DM(list(range(%d))).T/%d; "
+              "r = G(ca.DM([1,2,3,0.5]),t0,ca.sin(t0)); "
+              "print([float(e).hex() for e in ca.vertcat(*r).nonzeros()])") % (n, n)
+    outs = set()
+    for nt in ["1","2","3","8"]:
+      env = dict(os.environ, OMP_NUM_THREADS=nt)
+      outs.add(subprocess.check_output([sys.executable,"-c",script],env=env))
+    self.assertEqual(len(outs),1)
+
+    # Options are applied to the returned function for every parallelization
+    for par in ["serial","openmp"]:
+      with self.assertInException("foobar"):
+        r.map("lsq",par,3,[0],[0],{"foobar":True})
+
   def test_issue4274(self):
     x=ca.MX.sym('x')
 
@@ -1008,6 +1051,60 @@ class Functiontests(casadiTestCase):
           self.checkfunction(f,Fref,inputs=inputs)
           self.check_codegen(f,inputs=inputs)
 
+  def test_mapaccum_loop(self):
+
+    x = ca.SX.sym("x",2)
+    y = ca.SX.sym("y")
+    z = ca.SX.sym("z",2,2)
+    v = ca.SX.sym("v",ca.Sparsity.upper(3))
+
+    fun = ca.Function("f",[y,x,z,v],[z @ x+y+c.trace(v)**2,ca.sin(y*x).T,v/y])
+
+    np.random.seed(0)
+    for n in [1,4]:
+      X = ca.MX.sym("x",x.sparsity())
+      Y = [ca.MX.sym("y",y.sparsity()) for i in range(n)]
+      Z = [ca.MX.sym("z",z.sparsity()) for i in range(n)]
+      V = [ca.MX.sym("v",v.sparsity()) for i in range(n)]
+
+      X_ = ca.DM(x.sparsity(),np.random.random(x.nnz()))
+      Y_ = [ ca.DM(i.sparsity(),np.random.random(i.nnz())) for i in Y ]
+      Z_ = [ ca.DM(i.sparsity(),np.random.random(i.nnz())) for i in Z ]
+      V_ = [ ca.DM(i.sparsity(),np.random.random(i.nnz())) for i in V ]
+
+      F = fun.mapaccum("map",n,[1,3],[0,2],{"loop": True})
+
+      XP = X
+      VP = V[0]
+      Y0s = []
+      Xps = []
+      Vps = []
+      for k in range(n):
+        XP, Y0, VP = fun(Y[k],XP,Z[k],VP)
+        Y0s.append(Y0)
+        Xps.append(XP)
+        Vps.append(VP)
+
+      Fref = ca.Function("f",[ca.horzcat(*Y),X,ca.horzcat(*Z),V[0]],[ca.horzcat(*Xps),ca.horzcat(*Y0s),ca.horzcat(*Vps)])
+      inputs = [ca.horzcat(*Y_),X_,ca.horzcat(*Z_),V_[0]]
+
+      for f in [F,toSX_fun(F)]:
+        self.checkfunction(f,Fref,inputs=inputs)
+        self.check_codegen(f,inputs=inputs)
+      self.check_serialize(F,inputs=inputs)
+
+    g = ca.Function("g",[x,y],[ca.sin(x)*y,x[0]*y])
+    inputs = [ca.DM([0.1,0.2]),ca.DM(np.random.random(5)).T]
+    self.checkfunction(g.fold(5,{"loop": True}),g.fold(5),inputs=inputs)
+
+    # Construction does not depend on the number of steps
+    F = g.mapaccum("map",100000,{"loop": True})
+    self.assertTrue(F.is_a("MapAccum"))
+    self.assertTrue(F.sz_w()<1000)
+
+    with self.assertInException("matching sparsity"):
+      ca.Function("f",[x],[x[0]]).mapaccum(3,{"loop": True})
+
   def test_mapaccum_schemes(self):
 
     x = ca.SX.sym("x",2)
@@ -1261,6 +1358,29 @@ class Functiontests(casadiTestCase):
       self.assertTrue(same(F([-.6, 2.5]), 24.4))
       self.assertTrue(same(F([-.6, 3.5]), 34.4))
 
+  def test_interpolant_hunt(self):
+    # 'hunt' starts from the intervals of the previous call: results must not depend on query order
+    xg = list(np.linspace(0,1,40)**2)
+    yg = list(np.linspace(-1,1,15))
+    values = [np.sin(5*x)*np.cos(2*y) for y in yg for x in xg]
+    t = np.linspace(-0.2,1.2,60)
+    X = np.vstack((t, np.cos(7*t)))
+    X = np.hstack((X, X[:,::-1], [[xg[5],xg[-1],1.3,-0.1,xg[20]],[yg[3],-2,0.9,1,yg[0]]]))
+    x = ca.MX.sym("x",2)
+    for plugin in ["linear","bspline"]:
+      Fref = ca.interpolant('F', plugin, [xg, yg], values, {"lookup_mode": ["binary","binary"]})
+      F = ca.interpolant('F', plugin, [xg, yg], values, {"lookup_mode": ["hunt","hunt"]})
+      for i in range(X.shape[1]):
+        self.checkarray(F(X[:,i]), Fref(X[:,i]), digits=14)
+      J = ca.Function('J',[x],[ca.jacobian(F(x),x)])
+      Jref = ca.Function('J',[x],[ca.jacobian(Fref(x),x)])
+      for i in range(0,X.shape[1],7):
+        self.checkarray(J(X[:,i]), Jref(X[:,i]), digits=14)
+      Fm = F.map(X.shape[1])
+      self.checkarray(Fm(X), Fref.map(X.shape[1])(X), digits=14)
+      self.check_codegen(Fm, inputs=[X])
+      self.check_serialize(F, inputs=[X[:,0]])
+
   @skip(not scipy_interpolate)
   def test_nd_linear(self):
 
@@ -2274,6 +2394,56 @@ class Functiontests(casadiTestCase):
 
     self.checkfunction(F,Fref,inputs=[ca.DM([[1,2],[3,7]])])
 
+  def test_fold_checkpoints(self):
+    x = ca.MX.sym("x",3)
+    u = ca.MX.sym("u")
+    f = ca.Function("f",[x,u],[ca.sin(x)*u+x,x[0]*u])
+
+    N = 1000
+    X0 = ca.MX.sym("x",3)
+    U = ca.MX.sym("u",1,N)
+    xk = X0
+    ys = []
+    for k in range(N):
+      xk, y = f(xk,U[k])
+      ys.append(y)
+    Fref = ca.Function("f",[X0,U],[xk,ca.hcat(ys)])
+
+    inputs = [ca.DM([0.1,0.2,0.3]),ca.DM(numpy.linspace(0,0.01,N)).T]
+    sz_w = []
+    for opts in [{"base": 7},{"checkpoints": 1},{"checkpoints": 20},{"checkpoints": 5000}]:
+      F = f.fold(N,opts)
+      self.checkfunction_light(F,Fref,inputs=inputs)
+      G = ca.Function("g",[X0,U],[ca.gradient(ca.sumsqr(F(X0,U)[0]),U)])
+      sz_w.append(G.sz_w())
+      Gref = ca.Function("g",[X0,U],[ca.gradient(ca.sumsqr(Fref(X0,U)[0]),U)])
+      self.checkarray(G(*inputs),Gref(*inputs),digits=10)
+    # A tight budget keeps fewer intermediate states in reverse mode
+    self.assertTrue(sz_w[2]<sz_w[3])
+
+    F = f.mapaccum(N,{"checkpoints": 20})
+    Fref = f.mapaccum(N,{"base": -1})
+    self.checkfunction_light(F,Fref,inputs=inputs)
+
+    with self.assertInException("checkpoints must be positive"):
+      f.fold(N,{"checkpoints": 0})
+    with self.assertInException("mutually exclusive"):
+      f.fold(N,{"base": 7, "checkpoints": 20})
+    with self.assertInException("base must be at least 2"):
+      f.fold(N,{"base": 1})
+
+  def test_checkout(self):
+    x = ca.MX.sym("x")
+    f = ca.Function("f",[x],[x**2])
+    m = [f.checkout() for i in range(3)]
+    self.assertEqual(len(set(m)),3)
+    f.release(m[1])
+    # Released memory objects are reused
+    self.assertEqual(f.checkout(),m[1])
+    f.release(m[0])
+    self.checkarray(f(3),9)
+    for i in m: f.release(i)
+    self.assertEqual(f.checkout(),min(m))
 
   @memory_heavy()
   def test_thread_safety(self):
@@ -2427,6 +2597,61 @@ class Functiontests(casadiTestCase):
     self.assertTrue("Q" in found)
     self.assertTrue("fwd1_Q" in found)
     
+  @requiresPlugin(ca.Importer,"llvm")
+  def test_jit_llvm(self):
+    x = ca.SX.sym("x",3)
+    y = ca.SX.sym("y")
+    e = ca.vertcat(ca.sin(x)*y+ca.exp(x[0])/ca.sqrt(y),
+                   ca.fmin(x[1],y)*ca.sign(x[2]),
+                   ca.if_else(x[0]<y, ca.atan2(x[1],y), ca.erf(x[2])))
+    f = ca.Function('f',[x,y],[e,x[1]**y])
+    for opts in [{}, {"jit_options": {"opt_level": 0}}, {"jit_threshold": 3}]:
+      opts.update({"jit":True,"compiler":"llvm"})
+      g = ca.Function('f',[x,y],[e,x[1]**y],opts)
+      for i in range(5):
+        self.checkfunction_light(g,f,inputs=[ca.DM([0.3,1.2,-2.5+i]),1.7])
+
+    # Only SX algorithms are lowered
+    x = ca.MX.sym("x")
+    with self.assertInException("SXFunction"):
+      ca.Function('f',[x],[ca.sin(x)],{"jit":True,"compiler":"llvm"})
+
+  def test_jit_threshold_options(self):
+    # Deferred compilation is only available for the in-process compiler
+    x = ca.SX.sym("x")
+    for opts in [{"jit_threshold": 3}, {"jit_threshold": 3, "jit": True, "compiler": "shell"},
+                 {"jit_threshold": 3, "compiler": "llvm"}]:
+      with self.assertInException("jit_threshold"):
+        ca.Function('f',[x],[ca.sin(x)],opts)
+
+  def test_profiler(self):
+    x = ca.MX.sym("x",2)
+    g = ca.Function('g',[x],[ca.sin(x)*2])
+    f = ca.Function('f',[x],[ca.mtimes(x.T,g(x))])
+    ca.Profiler.start()
+    for i in range(3): f(ca.DM([1,2]))
+    ca.Profiler.stop()
+    n = ca.Profiler.n_spans()
+    self.assertTrue(n>0)
+    f(ca.DM([1,2]))
+    self.assertEqual(ca.Profiler.n_spans(),n)
+
+    ca.Profiler.to_chrome_trace("profile.json")
+    with open("profile.json") as fh:
+      events = json.load(fh)["traceEvents"]
+    self.assertEqual(len(events),n)
+    names = set(e["name"] for e in events)
+    for name in ["f","g","call","mtimes","sin"]:
+      self.assertTrue(name in names)
+
+    ca.Profiler.to_folded("profile.folded")
+    with open("profile.folded") as fh:
+      stacks = [l.rsplit(" ",1)[0].split(";") for l in fh.read().splitlines()]
+    self.assertTrue(any(s[1]=="f" and s[2].startswith("call[") and s[3:4]==["g"] for s in stacks if len(s)>2))
+
+    ca.Profiler.clear()
+    self.assertEqual(ca.Profiler.n_spans(),0)
+
   @requiresPlugin(ca.Importer,"shell")
   def test_jit_directory(self):
   
@@ -2518,6 +2743,39 @@ class Functiontests(casadiTestCase):
 
     self.checkarray(JJ(5,2),5*pi+3)
 
+  def test_single_precision(self):
+    inputs = [ca.DM([1+1e-10,2])]
+    for X in [ca.SX, ca.MX]:
+      x = X.sym("x",2)
+      f = ca.Function("f",[x],[ca.vertcat(ca.sin(x[0])*x[1], x[0]-1)])
+      fs = ca.Function("f",[x],[ca.vertcat(ca.sin(x[0])*x[1], x[0]-1)],{"single_precision": True})
+      r = f(*inputs)
+      rs = fs(*inputs)
+      self.checkarray(rs,r,digits=6)
+      # Input is rounded to float
+      self.checkarray(r[1],1e-10,digits=15)
+      self.checkarray(rs[1],0,digits=15)
+
+      # Calls to other functions use single precision as well
+      y = ca.SX.sym("y",2)
+      g = ca.Function("g",[y],[f(y)],{"single_precision": True, "never_inline": True})
+      self.checkarray(g(*inputs),rs,digits=15)
+
+      fs.change_option("single_precision",False)
+      self.checkarray(fs(*inputs),r,digits=15)
+
+      # Single precision evaluation honours print_instructions
+      outs = []
+      for single in [False, True]:
+        fp = ca.Function("f",[x],[ca.sin(x[0])*x[1]],{"print_instructions": True, "single_precision": single})
+        with capture_stdout() as out:
+          fp(*inputs)
+        outs.append(out[0].split("\n"))
+      self.assertTrue(len(outs[1])>1)
+      self.assertEqual(len(outs[0]),len(outs[1]))
+
+    self.check_serialize(ca.Function("f",[x],[x-1],{"single_precision": True}),inputs=inputs)
+
   def test_dump(self):
     x = ca.MX.sym("x",ca.Sparsity.lower(3))
     y = ca.MX.sym("y",0,0)
@@ -2556,6 +2814,51 @@ class Functiontests(casadiTestCase):
       self.checkarray(Xr,X)
       self.checkarray(Ar,A)
 
+    # Binary format: all evaluations appended to a single file
+    if os.path.exists("fb.casadi_dump"): os.remove("fb.casadi_dump")
+    f = ca.Function("fb",[x,y,z],[2*x,2*z],["x","y","z"],["a","c"],{"dump_in":True,"dump_out":True,"dump_format":"bin"})
+    ins = [ca.sparsify(ca.DM([[1,0,0],[2,4,0],[7,8,9]])),ca.DM(),ca.DM([[1,3],[4,5]])]
+    for k in range(4):
+      f(*[k*e for e in ins])
+    stats = f.stats()
+    self.assertEqual(stats["n_dump_written"], 8)
+    self.assertEqual(stats["n_dump_dropped"], 0)
+    # Evaluations may be writing concurrently
+    with self.assertRaises(Exception):
+      f.change_option("dump_format", "mtx")
+
+    # Reading flushes queued records
+    recorded_in = f.read_dump("fb.casadi_dump")
+    recorded_out = f.read_dump("fb.casadi_dump", True)
+    self.assertEqual(len(recorded_in), 4)
+    self.assertEqual(len(recorded_out), 4)
+    for k in range(4):
+      for i in range(3):
+        self.checkarray(recorded_in[k][i], k*ins[i])
+      out = f(*recorded_in[k])
+      self.checkarray(recorded_out[k][0], out[0])
+      self.checkarray(recorded_out[k][1], out[1])
+
+    # A second instance with the same name appends to the same writer
+    f2 = ca.Function("fb",[x,y,z],[2*x,2*z],["x","y","z"],["a","c"],{"dump_in":True,"dump_format":"bin"})
+    f2(*ins)
+    self.assertEqual(len(f.read_dump("fb.casadi_dump")), 9)
+    # ... unless its sparsity differs
+    zl = ca.MX.sym("z",ca.Sparsity.lower(2))
+    f3 = ca.Function("fb",[x,y,zl],[2*x,2*zl],["x","y","z"],["a","c"],{"dump_in":True,"dump_format":"bin"})
+    with self.assertRaises(Exception):
+      f3(*ins)
+    del f, f2, f3
+
+    # Records appended later are still read against their own sparsity
+    f = ca.Function("fb",[x,y,z],[2*x,2*z],["x","y","z"],["a","c"],{"dump_in":True,"dump_format":"bin"})
+    f(*ins)
+    self.assertEqual(len(f.read_dump("fb.casadi_dump")), 10)
+    f = ca.Function("fb",[x,y,zl],[2*x],["x","y","z"],["a"])
+    with self.assertRaises(Exception):
+      f.read_dump("fb.casadi_dump")
+    os.remove("fb.casadi_dump")
+
     if args.run_slow and "ghc-filesystem" in ca.CasadiMeta.feature_list():
       import shutil
       for d in ["dump_fn", "dump_fn_codegen"]:
@@ -4405,7 +4708,7 @@ class Functiontests(casadiTestCase):
               random_base.seed(1)
               points_u = random_base.sample(points_u,125)
 
-          for lookup_mode in ["linear","exact","binary"]:
+          for lookup_mode in ["linear","exact","binary","hunt"]:
             opts_lu = {"precompute_coeff": precompute_coeff,
                        "precompute_grid": precompute_grid,
                        "lookup_mode": [lookup_mode]*N,
@@ -4580,6 +4883,30 @@ class Functiontests(casadiTestCase):
     self.check_codegen(f,inputs=[ca.DM.rand(4,4),1],opts={"force_canonical":False})
     self.check_codegen(f,inputs=[ca.DM.rand(4,4),1],opts={"force_canonical":True})
     
+  def test_codegen_constant_blob(self):
+    x = ca.MX.sym("x",50)
+    c = ca.DM.rand(50)
+    A = ca.DM(ca.Sparsity.lower(50),ca.DM.rand(ca.Sparsity.lower(50).nnz()).nonzeros())
+    f = ca.Function("f",[x],[ca.mtimes(A,x)+c,ca.dot(c,ca.sin(x))])
+    modes = ["embedded","file"]
+    if sys.platform.startswith("linux"): modes.append("incbin")
+    for mode in modes:
+      self.check_codegen(f,inputs=[ca.DM.rand(50)],opts={"constant_blob":mode,"constant_blob_threshold":20})
+    with self.assertInException("constant_blob"):
+      ca.CodeGenerator("foo",{"constant_blob":"mmap"})
+    # Without the data file, exposed functions fail rather than read garbage
+    if sys.platform.startswith("linux"):
+      import subprocess, ctypes
+      f.generate("blob_missing.c",{"constant_blob":"file","constant_blob_threshold":20})
+      subprocess.check_call("gcc -shared -fPIC blob_missing.c -o blob_missing.so", shell=True)
+      os.remove("blob_missing.bin")
+      lib = ctypes.CDLL("./blob_missing.so")
+      for getter in [lib.f_sparsity_in, lib.f_sparsity_out]:
+        getter.restype = ctypes.c_void_p
+        getter.argtypes = [ctypes.c_longlong]
+        self.assertIsNone(getter(0))
+      self.assertEqual(lib.f(None,None,None,None,0),1)
+
   def test_options_sanitize(self):
       def canonical(e):
         if isinstance(e,dict):
@@ -4739,6 +5066,33 @@ class Functiontests(casadiTestCase):
     fs.disp(True)
     self.assertEqual(fs.n_nodes(),7)
 
+  def test_simplify_algebraic(self):
+    ca.DM.rng(1)
+    A = ca.DM.rand(3,3)+3*ca.DM.eye(3)
+    B = ca.DM.rand(3,3)
+    D = ca.diag(ca.DM.rand(3))
+    x = ca.MX.sym("x",3)
+    X = ca.MX.sym("X",3,3)
+
+    # inv(inv(X)), A*(B*x), known zeros in a constant factor, nested constant sums
+    e = [ca.inv(ca.inv(X)), ca.mtimes(A,ca.mtimes(B,x)), ca.mtimes(ca.densify(D),x), 2+(3+x)]
+    f = ca.Function("f",[x,X],e)
+
+    fs = f.transform([["simplify",0,"algebraic"]])
+    inputs = [ca.DM.rand(3), A]
+    self.checkfunction_light(f,fs,inputs=inputs)
+    self.assertTrue(fs.n_instructions() < f.n_instructions())
+
+    # the same passes are available when constructing the function
+    fo = ca.Function("f",[x,X],e,{"simplify":True})
+    self.checkfunction_light(f,fo,inputs=inputs)
+    self.assertTrue(fo.n_instructions() < f.n_instructions())
+    for k in range(fo.n_instructions()):
+      self.assertNotEqual(fo.instruction_id(k), ca.OP_SOLVE)
+
+    # and during code generation
+    self.check_codegen(f,inputs=inputs,opts={"simplify":True})
+
   def test_simplify_combine_terms(self):
     # issue #4227: expression-level simplify routes through Function.simplify
     x = ca.SX.sym("x")
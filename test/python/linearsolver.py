@@ -417,6 +417,49 @@ class LinearSolverTests(casadiTestCase):
 
           self.checkfunction(solversx,solution,digits_sens = 7)
 
+  def test_solve_batch(self):
+    numpy.random.seed(1)
+    nx, ng, K = 5, 2, 37
+    sp = ca.blockcat([[ca.Sparsity.dense(nx,nx),ca.Sparsity.dense(nx,ng)],
+                      [ca.Sparsity.dense(ng,nx),ca.Sparsity.diag(ng)]])
+    As = []
+    Bs = []
+    for k in range(K):
+      H = numpy.random.rand(nx,nx)
+      J = numpy.random.rand(ng,nx)
+      KKT = numpy.block([[H.dot(H.T)+numpy.eye(nx),J.T],[J,-0.1*numpy.eye(ng)]])
+      As.append(ca.project(ca.DM(KKT),sp))
+      Bs.append(ca.DM(numpy.random.rand(nx+ng,2)))
+
+    for Solver, options, req in lsolvers:
+      print(Solver)
+      solver = ca.Linsol("solver", Solver, sp, options)
+
+      # Numerical, all matrices share the symbolic factorization
+      X = solver.solve_batch(As, Bs)
+      for k in range(K):
+        self.checkarray(X[k], ca.solve(As[k], Bs[k]), digits=8)
+
+      # Solve node under map, with more operations around it
+      A = ca.MX.sym("A",sp)
+      b = ca.MX.sym("b",nx+ng,2)
+      f = ca.Function("f",[A,b],[2*solver.solve(A,b)+b])
+      F = f.map(K)
+      F_out = F(ca.hcat(As),ca.hcat(Bs))
+      self.checkarray(F_out, ca.hcat([f(As[k],Bs[k]) for k in range(K)]), digits=8)
+      self.check_serialize(F,inputs=[ca.hcat(As),ca.hcat(Bs)])
+
+      # With regularity_check, a failing factorization is reported with its index
+      options_check = dict(options)
+      options_check["regularity_check"] = True
+      As_singular = list(As)
+      As_singular[5] = ca.DM(sp,0)
+      try:
+        ca.Linsol("solver", Solver, sp, options_check).solve(As_singular[5], Bs[5])
+      except Exception:
+        with self.assertInException("Linear system 5 of %d" % K):
+          ca.Linsol("solver", Solver, sp, options_check).solve_batch(As_singular, Bs)
+
   def test_large_sparse(self):
 
     n = 10
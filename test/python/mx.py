@@ -1227,7 +1227,18 @@ class MXtests(casadiTestCase):
       if (ok_a and ok_b and ok_z and z_sp.nnz() > 0
           and ac == br and ar == zr and bc == zc):
         return 'dense'             # PseudoDenseMultiplication
-      return 'generic'             # base Multiplication
+      # base Multiplication: adjacent columns with identical patterns in B and z
+      # form a dense sub-block if all of the gathered A is nonzero
+      A_d = np.array(ca.DM(A_sp, 1.0))
+      for c in range(z_sp.size2()-1):
+        rows_z = list(z_sp.row()[z_sp.colind()[c]:z_sp.colind()[c+1]])
+        rows_b = list(B_sp.row()[B_sp.colind()[c]:B_sp.colind()[c+1]])
+        if (rows_z and rows_b
+            and rows_z == list(z_sp.row()[z_sp.colind()[c+1]:z_sp.colind()[c+2]])
+            and rows_b == list(B_sp.row()[B_sp.colind()[c+1]:B_sp.colind()[c+2]])
+            and np.count_nonzero(A_d[np.ix_(rows_z, rows_b)]) == len(rows_z)*len(rows_b)):
+          return 'dense'
+      return 'generic'
 
     Adense_sym = ca.MX.sym('A', m, k)
     Bdense_sym = ca.MX.sym('B', k, n)
@@ -1287,7 +1298,7 @@ class MXtests(casadiTestCase):
             elif cat == 'dense_sparse':
               expected = 'casadi_mtimes_dense_sparse('  # plugin-agnostic
             else:
-              expected = 'casadi_mtimes('               # plugin-agnostic
+              expected = 'casadi_mtimes_plan('          # plugin-agnostic
 
             # Is the expected kernel in the generated code?
             f.generate('f.c')
@@ -1313,6 +1324,50 @@ class MXtests(casadiTestCase):
                 self.check_codegen(f, inputs=val_in, extralibs=extralibs)
 
 
+  def test_mtimes_block(self):
+    # Block-sparse operands with a common block size use dense block kernels
+    np.random.seed(1)
+    def blocks(n, p, bs):
+      return ca.kron(ca.Sparsity.banded(n, p), ca.Sparsity.dense(bs, bs))
+    for A_sp, B_sp, Z_sp in [(blocks(5, 1, 3), blocks(5, 1, 3), blocks(5, 2, 3)),
+                             (blocks(5, 1, 3), blocks(5, 2, 3).T, blocks(5, 1, 3)),
+                             (blocks(3, 1, 6), blocks(6, 1, 3), blocks(6, 2, 3))]:
+      A = ca.MX.sym("A", A_sp)
+      B = ca.MX.sym("B", B_sp)
+      Z = ca.MX.sym("Z", Z_sp)
+      Av = ca.DM(A_sp, np.random.random(A_sp.nnz()))
+      Bv = ca.DM(B_sp, np.random.random(B_sp.nnz()))
+      Zv = ca.DM(Z_sp, np.random.random(Z_sp.nnz()))
+      ref = ca.mtimes(ca.densify(Av), ca.densify(Bv))
+      # Products outside the pattern of Z are dropped by mac
+      for r, r_ref in [(ca.mtimes(A, B), ref), (ca.mac(A, B, Z), ca.project(ref, Z_sp) + Zv)]:
+        f = ca.Function("f", [A, B, Z], [r])
+        self.checkarray(ca.densify(f(Av, Bv, Zv)), ca.densify(r_ref))
+        self.checkarray(f.expand()(Av, Bv, Zv), f(Av, Bv, Zv))
+        f.generate('f.c')
+        with open('f.c', 'r') as codefile:
+          self.assertIn('casadi_mtimes_block(', codefile.read())
+        self.check_codegen(f, inputs=[Av, Bv, Zv])
+        self.check_serialize(f, inputs=[Av, Bv, Zv])
+
+  def test_mtimes_nonfinite(self):
+    # Structural zeros of x never multiply Inf or NaN in y, as in DM mtimes
+    for x_sp, y_sp in [(ca.Sparsity.lower(4), ca.Sparsity.dense(4, 3)),
+                       (ca.Sparsity.banded(6, 1), ca.Sparsity.dense(6, 4)),
+                       (ca.Sparsity.lower(4), ca.Sparsity.lower(4))]:
+      x = ca.MX.sym("x", x_sp)
+      y = ca.MX.sym("y", y_sp)
+      f = ca.Function("f", [x, y], [ca.mtimes(x, y)])
+      for bad in [np.inf, -np.inf, np.nan]:
+        xv = ca.DM(x_sp, 1)
+        yv = ca.DM(y_sp, np.arange(1, y_sp.nnz()+1))
+        yv[y_sp.size1()-1, 0] = bad
+        ref = ca.mtimes(xv, yv)
+        for fun in [f, f.expand()]:
+          r = fun(xv, yv)
+          self.assertTrue(r.sparsity()==ref.sparsity())
+          np.testing.assert_array_equal(np.array(r.nonzeros()), np.array(ref.nonzeros()))
+
   def test_l1_blas_plugin(self):
     # Counterpart to test_mtimes_blas_plugin, but for the L1 ops dispatched
     # through GlobalOptions::setDefaultBlas: dot, norm_1, norm_2, plus axpy
@@ -3521,6 +3576,57 @@ class MXtests(casadiTestCase):
 
         einstein_tests([2,4,3], [2,5,3], [5, 4], [-1, -2, -3], [-1, -4, -3], [-4, -2])
 
+  def test_einstein_gemm(self):
+    np.random.seed(0)
+    # Batched products with transposed operands and permuted result
+    for ta, tb, tc in [("ij", "jk", "ik"), ("ji", "jk", "ik"), ("ij", "kj", "ki"),
+                       ("bij", "bjk", "bik"), ("ijb", "jkb", "kib"), ("ijk", "kl", "ijl")]:
+      dims = {"i": 2, "j": 3, "k": 4, "l": 5, "b": 3}
+      lab = {c: -1-n for n, c in enumerate("ijklb")}
+      A = np.random.random([dims[c] for c in ta])
+      B = np.random.random([dims[c] for c in tb])
+      As = ca.MX.sym("A", A.size)
+      Bs = ca.MX.sym("B", B.size)
+      r = ca.einstein(As, Bs, [dims[c] for c in ta], [dims[c] for c in tb], [dims[c] for c in tc],
+                      [lab[c] for c in ta], [lab[c] for c in tb], [lab[c] for c in tc])
+      f = ca.Function("f", [As, Bs], [r])
+      ref = np.einsum(ta + "," + tb + "->" + tc, A, B)
+      # einstein is column-major
+      self.checkarray(f(A.ravel(order="F"), B.ravel(order="F")), ref.ravel(order="F"), digits=10)
+      self.check_codegen(f, inputs=[A.ravel(order="F"), B.ravel(order="F")])
+
+    # Matrix chain is contracted right to left
+    P = ca.MX.sym("P", 5*5)
+    Q = ca.MX.sym("Q", 5*5)
+    x = ca.MX.sym("x", 5)
+    PQ = ca.einstein(P, Q, [5, 5], [5, 5], [5, 5], [-1, -2], [-2, -3], [-1, -3])
+    f = ca.Function("f", [P, Q, x], [ca.einstein(PQ, x, [5, 5], [5], [5], [-1, -2], [-2], [-1])])
+    Pv, Qv, xv = np.random.random((5, 5)), np.random.random((5, 5)), np.random.random(5)
+    self.checkarray(f(Pv.ravel(order="F"), Qv.ravel(order="F"), xv), Pv @ Qv @ xv, digits=10)
+    for i in range(f.n_instructions()):
+      if f.instruction_id(i)==ca.OP_EINSTEIN:
+        self.assertEqual(f.instruction_MX(i).numel(), 5)
+    self.check_serialize(f, inputs=[Pv.ravel(order="F"), Qv.ravel(order="F"), xv])
+
+    # The BLAS plugin chosen at construction survives serialization
+    try:
+      ca.load_blas("classic")
+    except Exception:
+      return
+    try:
+      ca.GlobalOptions.setDefaultBlas("classic")
+      f = ca.Function("f", [P, Q], [ca.einstein(P, Q, [5, 5], [5, 5], [5, 5],
+                                                [-1, -2], [-2, -3], [-1, -3])])
+      f.save('einstein.casadi')
+      ca.GlobalOptions.setDefaultBlas("reference")
+      fdeser = ca.Function.load('einstein.casadi')
+      fdeser.generate('einstein.c')
+      with open('einstein.c', 'r') as codefile:
+        self.assertIn('CASADI_BLAS_DGEMM(', codefile.read())
+      self.checkfunction_light(f, fdeser, inputs=[Pv.ravel(order="F"), Qv.ravel(order="F")])
+    finally:
+      ca.GlobalOptions.setDefaultBlas("reference")
+
   def test_sparsity_operation(self):
     L = [ca.MX(ca.Sparsity(1,1)),ca.MX(ca.Sparsity(2,1)), ca.MX.sym("x",1,1), ca.MX.sym("x", ca.Sparsity(1,1)), ca.DM(1), ca.DM(ca.Sparsity(1,1),1), ca.DM(ca.Sparsity(2,1),1), ca.DM(ca.Sparsity.dense(2,1),1)]
 
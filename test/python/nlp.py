@@ -1766,6 +1766,56 @@ class NLPtests(casadiTestCase):
 
       self.checkfunction_light(f,f2,[0,0.5],digits=6)
 
+  @requires_conic("ipqp")
+  def test_sqpmethod_ipqp_codegen(self):
+    x = ca.MX.sym("x",2)
+    nlp = {"x":x,"f":(1-x[0])**2+100*(x[1]-x[0]**2)**2,"g":x[0]+x[1]}
+    solver_in = {"x0":[0.5,0.5],"lbx":[-2,-2],"ubx":[2,2],"lbg":-inf,"ubg":1.5}
+    qpsol_options = {"print_iter":False,"print_header":False,"print_info":False,"error_on_fail":False}
+    solver = ca.nlpsol("solver","sqpmethod",nlp,{"qpsol":"ipqp","qpsol_options":qpsol_options,
+      "print_header":False,"print_iteration":False,"print_time":False})
+    res = solver(**solver_in)
+    self.assertTrue(solver.stats()["success"])
+    if args.run_slow:
+      self.check_codegen(solver,solver_in,std="c99",digits=8)
+
+  @requires_conic("qrqp")
+  @requires_integrator("cvodes")
+  def test_sqpmethod_parallel_ls(self):
+    # Multiple shooting with an embedded integrator: expensive nlp_fg
+    x = ca.SX.sym("x",2)
+    u = ca.SX.sym("u")
+    F = ca.integrator("F","cvodes",{"x":x,"u":u,"ode":ca.vertcat(x[1],(1-x[0]**2)*x[1]-x[0]+u)},0,0.5)
+    N = 10
+    X = ca.MX.sym("X",2,N+1)
+    U = ca.MX.sym("U",1,N)
+    Xn = F.map(N)(x0=X[:,:N],u=U)["xf"]
+    nlp = {"x":ca.veccat(X,U),"f":ca.sumsqr(X)+10*ca.sumsqr(U)+100*ca.sumsqr(X[:,-1]),
+           "g":ca.vertcat(ca.vec(Xn-X[:,1:]),X[:,0]-ca.vertcat(1,0))}
+    solver_in = {"x0":0.5,"lbg":0,"ubg":0,"lbx":-1.5,"ubx":1.5}
+    ref = None
+    for parallel_ls in [1,2,3]:
+      opts = {"qpsol":"qrqp","qpsol_options":{"print_iter":False,"print_header":False},
+        "hessian_approximation":"limited-memory","max_iter_ls":8,"parallel_ls":parallel_ls,
+        "print_header":False,"print_iteration":False,"print_time":False,"max_iter":200}
+      solver = ca.nlpsol("solver","sqpmethod",nlp,opts)
+      t0 = time.time()
+      res = solver(**solver_in)
+      stats = solver.stats()
+      self.assertTrue(stats["success"])
+      print("parallel_ls %d: %.2f ms per iteration, %d nlp_fg calls" % (parallel_ls,
+        (time.time()-t0)*1e3/stats["iter_count"], stats["n_call_nlp_fg"]))
+      # Speculation must not change the iterates
+      if ref is None:
+        ref = (res, stats["iter_count"])
+      else:
+        self.assertEqual(stats["iter_count"],ref[1])
+        self.checkarray(res["x"],ref[0]["x"],digits=14)
+        self.checkarray(res["lam_g"],ref[0]["lam_g"],digits=14)
+      # Trial buffers and thread-local memories must survive serialization
+      if parallel_ls>1:
+        self.check_serialize(solver,solver_in)
+
   @requires_conic("qrqp")
   def test_regularize_sqpmethod(self):
 
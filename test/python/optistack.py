@@ -1529,6 +1529,51 @@ class OptiStacktests(inherit_from):  # pyright: ignore[reportGeneralTypeIssues]
             dual_all = sol.value(opti.lam_g)
             
             self.checkarray(dual_opti, dual_all)
+
+    @requires_conic("qrqp")
+    def test_incremental_rebuild(self):
+        import time
+        N = 20
+        opti = ca.Opti('conic')
+        x = opti.variable(N+1)
+        u = opti.variable(N)
+        x0 = opti.parameter()
+        opti.minimize(ca.sumsqr(x)+ca.sumsqr(u))
+        opti.solver('qrqp',{"print_iter":False,"print_header":False})
+
+        obstacle = x[N//2]>=0.5
+
+        solvers = set()
+        t0 = time.time()
+        for k in range(10):
+            # Rebuild the constraint set from scratch every cycle
+            opti.subject_to()
+            opti.subject_to(x[0]==x0)
+            for i in range(N):
+                opti.subject_to(x[i+1]==0.9*x[i]+u[i])
+            opti.subject_to(opti.bounded(-1,u,1+k))
+            opti.subject_to(obstacle,{"slot":True})
+            opti.set_value(x0,1+0.1*k)
+            opti.set_active(obstacle,k%2==0)
+            sol = opti.solve()
+            solvers.add(opti.debug.casadi_solver.__hash__())
+            if k%2==0:
+              self.checkarray(sol.value(x[N//2]),0.5,digits=8)
+            else:
+              self.assertTrue(sol.value(x[N//2])<0.5)
+        print("Opti planning loop: %.2f ms per cycle" % ((time.time()-t0)*100))
+
+        # Structurally identical problems reuse the solver instance
+        self.assertEqual(len(solvers),1)
+
+        # A structural change triggers a rebuild
+        terminal = x[-1]==0
+        opti.subject_to(terminal)
+        opti.solve()
+        self.assertFalse(opti.debug.casadi_solver.__hash__() in solvers)
+
+        with self.assertInException("slot"):
+          opti.set_active(terminal)
     
 if __name__ == '__main__':
     unittest.main()
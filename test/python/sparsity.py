@@ -613,6 +613,29 @@ class Sparsitytests(casadiTestCase):
     sp_diag = ca.Sparsity.diag(4)
     self.assertFalse(sp_diag.is_compactible()[0])
 
+  def test_block_size(self):
+    self.message("block_size")
+    # Block tridiagonal with dense 3x3 blocks
+    sp = ca.kron(ca.Sparsity.banded(4, 1), ca.Sparsity.dense(3, 3))
+    self.assertEqual(sp.block_size(), 3)
+    self.assertTrue(sp.is_block(3))
+    self.assertFalse(sp.is_block(2))
+    self.assertFalse(sp.is_block(4))
+
+    # 4x4 blocks are also 2x2 blocks
+    sp = ca.kron(ca.Sparsity.diag(3), ca.Sparsity.dense(4, 4))
+    self.assertEqual(sp.block_size(), 4)
+    self.assertTrue(sp.is_block(2))
+
+    # Misaligned blocks
+    sp = ca.Sparsity.dense(2, 2)
+    sp = ca.diagcat(ca.Sparsity(1, 1), sp, ca.Sparsity(1, 1))
+    self.assertEqual(sp.block_size(), 1)
+
+    # Unstructured
+    self.assertEqual(ca.Sparsity.diag(4).block_size(), 1)
+    self.assertEqual(ca.Sparsity.dense(6, 4).block_size(), 2)
+
 
 if __name__ == '__main__':
     unittest.main()
@@ -1167,6 +1167,45 @@ class SXtests(casadiTestCase):
 
     self.checkarray(h_out[0].nonzeros(),H.nonzeros())
 
+  def test_hessian_edge_pushing(self):
+    x = ca.SX.sym("x",5)
+    p = ca.SX.sym("p")
+    x_sparse = ca.SX(ca.Sparsity.triplet(3,2,[0,2,1],[0,0,1]),ca.vertcat(x[0],x[2],x[4]))
+    for ex, arg in [(ca.sum1(ca.sin(x[1:]*x[:-1]))+p*ca.exp(x[0])/x[4], x),
+                    (ca.sqrt(x[0])*ca.log(x[1])+ca.tanh(x[2])**3-x[3]**x[4]+1/x[2], x),
+                    (x[0]*x[0]+ca.atan2(x[1],x[0])+ca.fmin(x[2],x[3])*x[4], x),
+                    (ca.dot(x,x)**2+p*x[3], x),
+                    (ca.sum1(ca.cos(x[2:]))+p, x),
+                    (ca.sin(x[0]*x[2])+x[4]**3, x_sparse)]:
+      g_ref = ca.gradient(ex, arg)
+      H_ref = ca.jacobian(g_ref, arg)
+      H, g = ca.hessian(ex, arg, {"edge_pushing": True})
+      self.assertEqual(H.shape, H_ref.shape)
+      self.assertTrue(g.sparsity()==arg.sparsity())
+      self.assertTrue(H.sparsity().is_subset(H_ref.sparsity()))
+      f_ref = ca.Function("f_ref",[x,p],[H_ref,g_ref])
+      f = ca.Function("f",[x,p],[H,g])
+      for x0 in [[1.1,0.7,0.3,1.9,2.5],[0.4,1.3,2.1,0.2,1.7]]:
+        for r, r_ref in zip(f(x0,0.3),f_ref(x0,0.3)):
+          self.checkarray(r,r_ref,digits=10)
+
+    # Passed through factory, the option reaches the Hessian blocks only
+    ex = ca.sum1(ca.sin(x[1:]*x[:-1]))+p*ca.exp(x[0])/x[4]
+    f = ca.Function("f",[x,p],[ex],["x","p"],["o0"])
+    with self.assertOutput(["hess_edge_pushing"],[]):
+      F = f.factory("F",["x","p"],["hess:o0:x:x","jac:o0:x"],
+                    {"edge_pushing": True, "helper_options": {"verbose": True}})
+    F_ref = f.factory("F",["x","p"],["hess:o0:x:x","jac:o0:x"])
+    for r, r_ref in zip(F([1.1,0.7,0.3,1.9,2.5],0.3),F_ref([1.1,0.7,0.3,1.9,2.5],0.3)):
+      self.checkarray(r,r_ref,digits=10)
+
+    # Not ignored where it does not apply
+    with self.assertInException("applies to Hessians only"):
+      ca.jacobian(ex, x, {"edge_pushing": True})
+    xm = ca.MX.sym("x",5)
+    with self.assertInException("only available for SX"):
+      ca.hessian(ca.sumsqr(xm), xm, {"edge_pushing": True})
+
   def test_mxnulloutput(self):
      a = ca.SX(5,0)
      b = ca.SX.sym("x",2)